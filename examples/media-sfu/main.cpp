@@ -49,21 +49,22 @@ int main() {
 
 		auto track = pc->addTrack(media);
 
-		track->setMediaHandler(std::make_shared<rtc::RtcpReceivingSession>());
+		// The forwarder fans out incoming RTP packets to receivers, rewriting them for each one
+		auto forwarder = std::make_shared<rtc::RtpForwarder>();
+		track->setMediaHandler(forwarder);
+		track->chainMediaHandler(std::make_shared<rtc::RtcpReceivingSession>());
 
 		const rtc::SSRC targetSSRC = 42;
-		track->onMessage(
-		    [&receivers, targetSSRC](rtc::binary message) {
-			    // This is an RTP packet
-			    auto rtp = reinterpret_cast<rtc::RtpHeader *>(message.data());
-			    rtp->setSsrc(targetSSRC);
-			    for (auto pc : receivers) {
-				    if (pc->track != nullptr && pc->track->isOpen()) {
-					    pc->track->send(message);
-				    }
-			    }
+
+		// Forwarded packets are stored once for all receivers to answer their NACKs. With a single
+		// layer, every receiver gets the same sequence numbers, so the history is filled by a
+		// subscriber receiving the same stream.
+		auto history = std::make_shared<rtc::RtpPacketHistory>();
+		forwarder->addSubscriber(
+		    [history](rtc::binary packet) {
+			    history->store(rtc::make_message(std::move(packet)));
 		    },
-		    nullptr);
+		    targetSSRC);
 
 		pc->setLocalDescription();
 
@@ -99,9 +100,14 @@ int main() {
 			media.addSSRC(targetSSRC, "video-send");
 
 			r->track = r->conn->addTrack(media);
+			r->track->setMediaHandler(std::make_shared<rtc::RtcpNackResponder>(history));
+
+			auto id = forwarder->addSubscriber(r->track, targetSSRC);
+			r->track->chainMediaHandler(std::make_shared<rtc::PliHandler>(
+			    [forwarder, id]() { forwarder->requestKeyframe(id); }));
 
-			r->track->onOpen([r]() {
-				r->track->requestKeyframe(); // So the receiver can start playing immediately
+			r->track->onOpen([forwarder, id]() {
+				forwarder->requestKeyframe(id); // So the receiver can start playing immediately
 			});
 			r->track->onMessage([](rtc::binary var) {}, nullptr);
 
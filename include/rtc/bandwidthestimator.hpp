@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_BANDWIDTH_ESTIMATOR_H
+#define RTC_BANDWIDTH_ESTIMATOR_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "pacinghandler.hpp"
+#include "transportcchandler.hpp"
+#include "utils.hpp"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace rtc {
+
+// Sender-side bandwidth estimation in the style of Google Congestion Control
+// (draft-ietf-rmcat-gcc-02): a delay-based estimate computed from transport-wide congestion
+// control feedback is combined with a loss-based estimate and capped by REMB. The resulting target
+// bitrate drives an optional PacingHandler and is reported to the application, typically to
+// configure the encoder.
+class RTC_CPP_EXPORT BandwidthEstimator final : public MediaHandler {
+public:
+	using clock = std::chrono::steady_clock;
+
+	inline static const unsigned int DefaultMinBitrate = 30000;
+	inline static const unsigned int DefaultMaxBitrate = 10000000;
+	inline static const double DefaultPacingFactor = 2.5;
+
+	/// @param startBitrate Initial target bitrate in bits per second
+	/// @param minBitrate Minimum target bitrate in bits per second
+	/// @param maxBitrate Maximum target bitrate in bits per second
+	BandwidthEstimator(unsigned int startBitrate, unsigned int minBitrate = DefaultMinBitrate,
+	                   unsigned int maxBitrate = DefaultMaxBitrate);
+
+	/// Sets the pacer to drive, its bitrate is set to the target bitrate times pacingFactor
+	void setPacingHandler(shared_ptr<PacingHandler> pacer,
+	                      double pacingFactor = DefaultPacingFactor);
+
+	/// Consumes the feedback of the transport-wide congestion control session
+	/// This replaces the feedback callback of the session.
+	void setTransportCcSession(shared_ptr<TransportCcSession> session);
+
+	/// Sets the callback called when the target bitrate changes
+	void onTargetBitrate(std::function<void(unsigned int bitrate)> callback);
+
+	unsigned int targetBitrate() const;
+
+	/// Processes transport-wide congestion control results
+	void processTransportCcFeedback(const std::vector<TransportCcPacketResult> &results,
+	                                clock::time_point now = clock::now());
+	/// Processes a REMB bitrate in bits per second
+	/// The bitrate caps the target until it is not refreshed for 5 seconds.
+	void processRemb(unsigned int bitrate, clock::time_point now = clock::now());
+	/// Processes a fraction lost from a RTCP report block, in 1/256 units
+	void processLossReport(uint8_t fractionLost, clock::time_point now = clock::now());
+
+	/// Reads local SSRCs, to match RTCP report blocks
+	void media(const Description::Media &desc) override;
+	/// Reads REMB, and report blocks in RTCP SR and RR
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	enum class Usage { Normal, Overusing, Underusing };
+	enum class RateState { Hold, Increase, Decrease };
+
+	struct PacketGroup {
+		clock::time_point firstSendTime;
+		clock::time_point lastSendTime;
+		std::chrono::microseconds lastArrivalTime;
+	};
+
+	void processPacketGroup(const PacketGroup &group, clock::time_point now);
+	void updateTrendline(double delayDeltaMs, double arrivalTimeMs, double sendDeltaMs,
+	                     clock::time_point now);
+	void updateThreshold(double modifiedTrend, clock::time_point now);
+	void updateDelayBasedBitrate(clock::time_point now);
+	void updateLossBasedBitrate(double lossFraction, clock::time_point now);
+	optional<double> ackedBitrate() const;
+	// Returns the new target if it changed significantly
+	optional<unsigned int> updateTarget(clock::time_point now);
+	void notifyTarget(unsigned int bitrate);
+
+	const double mMinBitrate;
+	const double mMaxBitrate;
+
+	// Delay-based estimation
+	optional<PacketGroup> mCurrentGroup;
+	optional<PacketGroup> mPreviousGroup;
+	optional<double> mFirstArrivalTimeMs;
+	std::deque<std::pair<double, double>> mDelayHistory; // arrival time and smoothed delay in ms
+	double mAccumulatedDelay = 0.;
+	double mSmoothedDelay = 0.;
+	unsigned int mDeltaCount = 0;
+	double mPreviousTrend = 0.;
+	double mThreshold;
+	optional<clock::time_point> mLastThresholdUpdate;
+	double mTimeOverusing = -1.;
+	unsigned int mOveruseCount = 0;
+	Usage mUsage = Usage::Normal;
+	RateState mRateState = RateState::Increase;
+	optional<clock::time_point> mLastRateUpdate;
+	optional<clock::time_point> mLastDelayDecrease;
+	double mDelayBasedBitrate;
+
+	// Acknowledged bitrate over a sliding window
+	std::deque<std::pair<std::chrono::microseconds, size_t>> mAcked; // arrival time and size
+	size_t mAckedBytes = 0;
+
+	// Loss-based estimation
+	double mLossBasedBitrate;
+	optional<clock::time_point> mLastLossUpdate;
+	optional<clock::time_point> mLastLossDecrease;
+	optional<clock::time_point> mLastTransportCcFeedback;
+
+	optional<double> mRembBitrate;
+	clock::time_point mLastRemb;
+
+	double mTargetBitrate;
+	unsigned int mReportedBitrate = 0;
+	std::vector<SSRC> mSsrcs;
+
+	weak_ptr<PacingHandler> mPacer;
+	double mPacingFactor = DefaultPacingFactor;
+	synchronized_callback<unsigned int> mTargetBitrateCallback;
+
+	mutable std::mutex mMutex;
+};
+
+} // namespace rtc
+
+#endif // RTC_ENABLE_MEDIA
+
+#endif // RTC_BANDWIDTH_ESTIMATOR_H
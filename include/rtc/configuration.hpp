@@ -63,6 +63,14 @@ enum class CertificateType {
 
 enum class TransportPolicy { All = RTC_TRANSPORT_POLICY_ALL, Relay = RTC_TRANSPORT_POLICY_RELAY };
 
+// DTLS-SRTP protection profiles, see https://www.rfc-editor.org/rfc/rfc7714.html#section-14.2
+enum class SrtpProfile {
+	AeadAes128Gcm,       // SRTP_AEAD_AES_128_GCM
+	AeadAes256Gcm,       // SRTP_AEAD_AES_256_GCM
+	Aes128CmHmacSha1_80, // SRTP_AES128_CM_HMAC_SHA1_80
+	Aes128CmHmacSha1_32  // SRTP_AES128_CM_HMAC_SHA1_32
+};
+
 struct RTC_CPP_EXPORT Configuration {
 	// ICE settings
 	std::vector<IceServer> iceServers;
@@ -89,6 +97,16 @@ struct RTC_CPP_EXPORT Configuration {
 	// Local maximum message size for Data Channels
 	optional<size_t> maxMessageSize;
 
+	// Number of parallel SRTP workers, 0 to run SRTP crypto on the calling thread
+	// Packets of different SSRCs are processed in parallel on the thread pool, then delivered in
+	// order. Since protection is asynchronous, a send failure is reported by the next send call.
+	size_t srtpWorkers = 0;
+
+	// SRTP protection profiles in order of preference, profiles not supported by the TLS backend or
+	// libSRTP are ignored. SRTP_AES128_CM_HMAC_SHA1_80 is always offered as it is mandatory.
+	std::vector<SrtpProfile> srtpProfiles = {SrtpProfile::AeadAes128Gcm, SrtpProfile::AeadAes256Gcm,
+	                                         SrtpProfile::Aes128CmHmacSha1_80};
+
 	// Certificates and private keys
 	optional<string> certificatePemFile;
 	optional<string> keyPemFile;
@@ -97,6 +115,12 @@ struct RTC_CPP_EXPORT Configuration {
 
 #ifdef RTC_ENABLE_WEBSOCKET
 
+// What send() does with a message exceeding the WebSocket send buffer limit
+enum class SendBufferPolicy {
+	Block = RTC_SEND_BUFFER_BLOCK, // wait for the buffer to drain
+	Drop = RTC_SEND_BUFFER_DROP    // drop the message and return false
+};
+
 struct WebSocketConfiguration {
 	bool disableTlsVerification = false; // if true, don't verify the TLS certificate
 	optional<ProxyServer> proxyServer;   // only non-authenticated http supported for now
@@ -110,6 +134,13 @@ struct WebSocketConfiguration {
 	optional<string> keyPemFile;
 	optional<string> keyPemPass;
 	optional<size_t> maxMessageSize;
+
+	// Offload TLS encryption of outgoing data to the kernel, only on Linux with OpenSSL 3.0 or 3.1
+	bool enableKernelTls = false;
+
+	// Limit of outgoing data buffered per connection in bytes, unlimited if unset
+	optional<size_t> maxBufferedAmount;
+	SendBufferPolicy sendBufferPolicy = SendBufferPolicy::Block;
 };
 
 struct WebSocketServerConfiguration {
@@ -121,6 +152,17 @@ struct WebSocketServerConfiguration {
 	optional<string> bindAddress;
 	optional<std::chrono::milliseconds> connectionTimeout;
 	optional<size_t> maxMessageSize;
+
+	// Number of threads accepting connections, each with its own SO_REUSEPORT listener where
+	// supported, otherwise sharing a single listener. Client callback calls are serialized.
+	unsigned int acceptThreads = 1;
+
+	// Offload TLS encryption of outgoing data to the kernel, only on Linux with OpenSSL 3.0 or 3.1
+	bool enableKernelTls = false;
+
+	// Limit of outgoing data buffered per connection in bytes, unlimited if unset
+	optional<size_t> maxBufferedAmount;
+	SendBufferPolicy sendBufferPolicy = SendBufferPolicy::Block;
 };
 
 #endif
@@ -0,0 +1,414 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_COROUTINE_H
+#define RTC_COROUTINE_H
+
+#include "channel.hpp"
+#include "common.hpp"
+#include "global.hpp"
+#include "peerconnection.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rtc {
+
+// An executor runs the given function to resume a coroutine. It must not run it synchronously, as
+// the coroutine would then resume inside a library callback.
+using CoroutineExecutor = std::function<void(std::function<void()> resume)>;
+
+// Set the executor for coroutines awaiting on libdatachannel objects, for instance to resume them
+// on the application event loop. By default, they are resumed on the library thread pool.
+RTC_CPP_EXPORT void SetCoroutineExecutor(CoroutineExecutor executor);
+
+namespace impl {
+
+// Run the function with the coroutine executor, or on the thread pool if none is set
+RTC_CPP_EXPORT void ExecuteCoroutine(std::function<void()> resume);
+
+// Coroutines waiting on an object. A single callback is registered for each event of the object
+// when the waiters are created, and notifies all of them, so several coroutines may wait on the
+// same object, for instance one receiving while another one is sending.
+class RTC_CPP_EXPORT CoroutineWaiters final {
+public:
+	using init_callback = std::function<void(const std::shared_ptr<CoroutineWaiters> &waiters)>;
+
+	// Get the waiters of the object, init is called to register callbacks if they are created.
+	// They live as long as the registered callbacks, or until the object is released.
+	static std::shared_ptr<CoroutineWaiters> Get(const void *object, const init_callback &init);
+	static void Release(const void *object); // called when the object is destroyed
+
+	int add(std::function<void()> notify); // returns an id for remove()
+	void remove(int id);
+	void notifyAll();
+
+private:
+	std::mutex mMutex;
+	std::vector<std::pair<int, std::function<void()>>> mWaiters;
+	int mNextId = 0;
+};
+
+} // namespace impl
+
+} // namespace rtc
+
+// The coroutine layer over the callback API is header-only so that the library itself does not
+// require C++20, and it is available only if the including code has coroutine support.
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define RTC_HAS_COROUTINES 1
+#else
+#define RTC_HAS_COROUTINES 0
+#endif
+
+#if RTC_HAS_COROUTINES
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
+
+namespace rtc {
+
+template <typename T = void> class Task;
+
+namespace impl {
+
+// Shared between a suspending coroutine and the callbacks able to resume it. Callbacks may be
+// called before the coroutine is actually suspended, in which case it does not suspend at all.
+class CoroutineResumer final {
+public:
+	explicit CoroutineResumer(std::coroutine_handle<> handle) : mHandle(handle) {}
+
+	void notify() {
+		if (mFlags.fetch_or(Notified) == Armed)
+			ExecuteCoroutine([handle = mHandle]() { handle.resume(); });
+	}
+
+	bool arm() { return (mFlags.fetch_or(Armed) & Notified) == 0; } // true if suspended
+
+private:
+	enum : int { Notified = 1, Armed = 2 };
+
+	const std::coroutine_handle<> mHandle;
+	std::atomic<int> mFlags = 0;
+};
+
+inline std::shared_ptr<CoroutineWaiters> GetWaiters(rtc::Channel &channel) {
+	return CoroutineWaiters::Get(&channel, [&channel](const auto &waiters) {
+		auto notify = [waiters]() { waiters->notifyAll(); };
+		channel.onOpen(notify);
+		channel.onClosed(notify);
+		channel.onAvailable(notify);
+		channel.onBufferedAmountLow(notify);
+	});
+}
+
+inline std::shared_ptr<CoroutineWaiters> GetWaiters(rtc::PeerConnection &pc) {
+	return CoroutineWaiters::Get(&pc, [&pc](const auto &waiters) {
+		pc.onStateChange([waiters](rtc::PeerConnection::State) { waiters->notifyAll(); });
+		pc.onGatheringStateChange(
+		    [waiters](rtc::PeerConnection::GatheringState) { waiters->notifyAll(); });
+	});
+}
+
+// Awaitable suspending until the object waiters are notified or check() returns true. Wakeups may
+// be spurious, for instance on another event of the object, so callers check their condition in a
+// loop.
+template <typename Derived> class WaitersAwaitable {
+public:
+	explicit WaitersAwaitable(std::shared_ptr<CoroutineWaiters> waiters)
+	    : mWaiters(std::move(waiters)) {}
+
+	bool await_ready() { return derived().check(); }
+
+	bool await_suspend(std::coroutine_handle<> handle) {
+		auto resumer = std::make_shared<CoroutineResumer>(handle);
+		int id = mWaiters->add([resumer]() { resumer->notify(); });
+		if (derived().check()) {
+			mWaiters->remove(id);
+			return false; // the condition was met while registering
+		}
+
+		return resumer->arm();
+	}
+
+	void await_resume() {}
+
+private:
+	Derived &derived() { return static_cast<Derived &>(*this); }
+
+	const std::shared_ptr<CoroutineWaiters> mWaiters;
+};
+
+class AvailableAwaitable final : public WaitersAwaitable<AvailableAwaitable> {
+public:
+	AvailableAwaitable(rtc::Channel &channel)
+	    : WaitersAwaitable(GetWaiters(channel)), mChannel(channel) {}
+
+	bool check() { return mChannel.availableAmount() > 0 || mChannel.isClosed(); }
+
+private:
+	rtc::Channel &mChannel;
+};
+
+class BufferedAmountLowAwaitable final : public WaitersAwaitable<BufferedAmountLowAwaitable> {
+public:
+	BufferedAmountLowAwaitable(rtc::Channel &channel, size_t threshold)
+	    : WaitersAwaitable(GetWaiters(channel)), mChannel(channel), mThreshold(threshold) {}
+
+	bool check() { return mChannel.bufferedAmount() <= mThreshold || mChannel.isClosed(); }
+
+private:
+	rtc::Channel &mChannel;
+	const size_t mThreshold;
+};
+
+class OpenAwaitable final : public WaitersAwaitable<OpenAwaitable> {
+public:
+	OpenAwaitable(rtc::Channel &channel)
+	    : WaitersAwaitable(GetWaiters(channel)), mChannel(channel) {}
+
+	bool check() { return mChannel.isOpen() || mChannel.isClosed(); }
+
+private:
+	rtc::Channel &mChannel;
+};
+
+class StateChangeAwaitable final : public WaitersAwaitable<StateChangeAwaitable> {
+public:
+	using State = rtc::PeerConnection::State;
+
+	StateChangeAwaitable(rtc::PeerConnection &pc, State state)
+	    : WaitersAwaitable(GetWaiters(pc)), mPeerConnection(pc), mState(state) {}
+
+	bool check() { return mPeerConnection.state() != mState; }
+
+private:
+	rtc::PeerConnection &mPeerConnection;
+	const State mState; // state when suspending
+};
+
+class GatheringStateChangeAwaitable final
+    : public WaitersAwaitable<GatheringStateChangeAwaitable> {
+public:
+	using GatheringState = rtc::PeerConnection::GatheringState;
+
+	GatheringStateChangeAwaitable(rtc::PeerConnection &pc, GatheringState state)
+	    : WaitersAwaitable(GetWaiters(pc)), mPeerConnection(pc), mState(state) {}
+
+	bool check() { return mPeerConnection.gatheringState() != mState; }
+
+private:
+	rtc::PeerConnection &mPeerConnection;
+	const GatheringState mState; // state when suspending
+};
+
+class TaskPromiseBase {
+public:
+	std::suspend_always initial_suspend() noexcept { return {}; }
+
+	auto final_suspend() noexcept {
+		// Transfer control to the awaiting coroutine, if any
+		struct FinalAwaitable {
+			bool await_ready() noexcept { return false; }
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept {
+				return continuation ? continuation : std::noop_coroutine();
+			}
+			void await_resume() noexcept {}
+
+			std::coroutine_handle<> continuation;
+		};
+		return FinalAwaitable{continuation};
+	}
+
+	void unhandled_exception() { exception = std::current_exception(); }
+
+	std::coroutine_handle<> continuation;
+	std::exception_ptr exception;
+};
+
+template <typename T> class TaskPromise final : public TaskPromiseBase {
+public:
+	Task<T> get_return_object();
+	void return_value(T value) { result.emplace(std::move(value)); }
+
+	T get() {
+		if (exception)
+			std::rethrow_exception(exception);
+
+		return std::move(*result);
+	}
+
+private:
+	optional<T> result;
+};
+
+template <> class TaskPromise<void> final : public TaskPromiseBase {
+public:
+	Task<void> get_return_object();
+	void return_void() {}
+
+	void get() {
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+};
+
+// Coroutine started immediately and never awaited, for Spawn()
+struct DetachedTask {
+	struct promise_type {
+		DetachedTask get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+template <typename T> DetachedTask RunTask(Task<T> task, std::promise<T> promise) {
+	try {
+		if constexpr (std::is_void_v<T>) {
+			co_await std::move(task);
+			promise.set_value();
+		} else {
+			promise.set_value(co_await std::move(task));
+		}
+	} catch (...) {
+		promise.set_exception(std::current_exception());
+	}
+}
+
+} // namespace impl
+
+// Lazily started coroutine, which runs when awaited by another coroutine or passed to Spawn()
+template <typename T> class [[nodiscard]] Task final {
+public:
+	using promise_type = impl::TaskPromise<T>;
+
+	Task(Task &&other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+	Task(const Task &) = delete;
+	~Task() {
+		if (mHandle)
+			mHandle.destroy();
+	}
+
+	Task &operator=(Task &&other) noexcept {
+		if (mHandle)
+			mHandle.destroy();
+
+		mHandle = std::exchange(other.mHandle, nullptr);
+		return *this;
+	}
+	Task &operator=(const Task &) = delete;
+
+	bool await_ready() const noexcept { return !mHandle || mHandle.done(); }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+		mHandle.promise().continuation = continuation;
+		return mHandle; // start the task
+	}
+
+	T await_resume() {
+		if (!mHandle)
+			throw std::logic_error("Task is empty");
+
+		return mHandle.promise().get();
+	}
+
+private:
+	using handle_type = std::coroutine_handle<promise_type>;
+
+	explicit Task(handle_type handle) : mHandle(handle) {}
+
+	handle_type mHandle;
+
+	friend promise_type;
+};
+
+template <typename T> Task<T> impl::TaskPromise<T>::get_return_object() {
+	return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> impl::TaskPromise<void>::get_return_object() {
+	return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// Start a task on the calling thread and return a future for its result
+template <typename T> std::future<T> Spawn(Task<T> task) {
+	std::promise<T> promise;
+	auto future = promise.get_future();
+	impl::RunTask(std::move(task), std::move(promise));
+	return future;
+}
+
+// The following functions register callbacks on the object when first waiting: onOpen, onClosed,
+// onAvailable and onBufferedAmountLow for a channel, onStateChange and onGatheringStateChange for a
+// peer connection. Therefore, they must not be mixed with these callbacks on the same object.
+// Several tasks may wait on the same object, which must outlive them.
+
+// Receive the next message, or nullopt if the channel is closed
+// As for receive(), onMessage must be unset.
+inline Task<optional<message_variant>> AsyncReceive(Channel &channel) {
+	while (true) {
+		if (auto message = channel.receive())
+			co_return message;
+
+		if (channel.isClosed())
+			co_return nullopt;
+
+		co_await impl::AvailableAwaitable(channel);
+	}
+}
+
+// Send a message, then wait until the buffered amount is at most the threshold, which replaces the
+// one set on the channel
+inline Task<void> AsyncSend(Channel &channel, message_variant data,
+                            size_t bufferedAmountLowThreshold = 0) {
+	channel.setBufferedAmountLowThreshold(bufferedAmountLowThreshold);
+	channel.send(std::move(data));
+	while (channel.bufferedAmount() > bufferedAmountLowThreshold && !channel.isClosed())
+		co_await impl::BufferedAmountLowAwaitable(channel, bufferedAmountLowThreshold);
+}
+
+// Wait for the channel to be open, returns false if it is closed instead
+inline Task<bool> AsyncOpen(Channel &channel) {
+	while (!channel.isOpen() && !channel.isClosed())
+		co_await impl::OpenAwaitable(channel);
+
+	co_return channel.isOpen();
+}
+
+// Wait for the state, or for Failed or Closed, and return the reached state
+inline Task<PeerConnection::State> AsyncState(PeerConnection &pc, PeerConnection::State state) {
+	using State = PeerConnection::State;
+	State current;
+	while ((current = pc.state()) != state && current != State::Failed && current != State::Closed)
+		co_await impl::StateChangeAwaitable(pc, current);
+
+	co_return current;
+}
+
+// Wait for the gathering of local candidates to complete
+inline Task<void> AsyncGatheringComplete(PeerConnection &pc) {
+	using GatheringState = PeerConnection::GatheringState;
+	GatheringState current;
+	while ((current = pc.gatheringState()) != GatheringState::Complete)
+		co_await impl::GatheringStateChangeAwaitable(pc, current);
+}
+
+} // namespace rtc
+
+#endif // RTC_HAS_COROUTINES
+
+#endif // RTC_COROUTINE_H
@@ -12,6 +12,7 @@
 #include "channel.hpp"
 #include "common.hpp"
 #include "reliability.hpp"
+#include "stats.hpp"
 
 #include <type_traits>
 
@@ -34,6 +35,7 @@ public:
 	string label() const;
 	string protocol() const;
 	Reliability reliability() const;
+	DataChannelStats stats() const;
 
 	bool isOpen(void) const override;
 	bool isClosed(void) const override;
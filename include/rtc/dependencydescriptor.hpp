@@ -12,6 +12,8 @@
 #include "common.hpp"
 
 #include <bitset>
+#include <utility>
+#include <vector>
 
 namespace rtc {
 
@@ -36,6 +38,24 @@ private:
 	size_t mSize = 0;
 };
 
+struct BitReader {
+	static BitReader fromSizeBits(const byte *buf, size_t offsetBits, size_t sizeBits);
+
+	size_t getReadBits() const;
+	size_t getRemainingBits() const;
+
+	bool read(size_t bits, uint64_t *v);
+	// Read non-symmetric unsigned encoded integer
+	// ref: https://aomediacodec.github.io/av1-rtp-spec/#a82-syntax
+	bool readNonSymmetric(uint64_t n, uint64_t *v);
+
+private:
+	const byte *mBuf = nullptr;
+	size_t mInitialOffset = 0;
+	size_t mOffset = 0;
+	size_t mSize = 0;
+};
+
 enum class DecodeTargetIndication {
 	NotPresent = 0,
 	Discardable = 1,
@@ -102,6 +122,31 @@ private:
 	const DependencyDescriptor &mDescriptor;
 };
 
+// Read dependency descriptor from RTP Header Extension
+// The template dependency structure is only attached to some packets, typically the first packet
+// of keyframes, so it is cached and used to resolve the templates of following packets.
+class RTC_CPP_EXPORT DependencyDescriptorReader {
+public:
+	DependencyDescriptorReader() = default;
+
+	/// Reads a descriptor, the frame dependency template is resolved with the cached structure
+	/// @return the descriptor, or nullopt if it is invalid or no structure has been received
+	optional<DependencyDescriptor> read(const byte *buf, size_t sizeBytes);
+
+	/// Returns the cached template dependency structure, nullptr if none has been received
+	shared_ptr<const FrameDependencyStructure> structure() const;
+
+	/// Returns the maximum spatial and temporal ids of each decode target of a structure
+	static std::vector<std::pair<int, int>>
+	DecodeTargetLayers(const FrameDependencyStructure &structure);
+
+private:
+	bool readStructure(BitReader &reader, FrameDependencyStructure &structure);
+
+	shared_ptr<const FrameDependencyStructure> mStructure;
+	optional<uint32_t> mActiveDecodeTargetsBitmask;
+};
+
 } // namespace rtc
 
 #endif
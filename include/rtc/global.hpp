@@ -12,8 +12,10 @@
 #include "common.hpp"
 
 #include <chrono>
+#include <cstdint>
 #include <future>
 #include <iostream>
+#include <vector>
 
 namespace rtc {
 
@@ -37,6 +39,9 @@ RTC_CPP_EXPORT void InitLogger(LogLevel level, LogCallback callback = nullptr);
 
 RTC_CPP_EXPORT void SetThreadPoolSize(unsigned int count); // 0: hardware concurrency
 
+// Run the function asynchronously on the library thread pool
+RTC_CPP_EXPORT void EnqueueTask(std::function<void()> task);
+
 struct SctpSettings {
 	// For the following settings, not set means optimized default
 	optional<size_t> recvBufferSize;                // in bytes
@@ -55,6 +60,28 @@ struct SctpSettings {
 
 RTC_CPP_EXPORT void SetSctpSettings(SctpSettings s);
 
+// External event loop: if enabled before initialization, no thread pool workers, poll thread nor
+// pacing thread are spawned, and the application must call Poll() or ProcessEvents() regularly on
+// a single thread, including until Cleanup() completes. Paced media is released from Poll() and
+// GetPollTimeout() accounts for it. Threads of the ICE and SCTP stacks are not affected.
+RTC_CPP_EXPORT void SetExternalEventLoop(bool enabled);
+
+// Process pending events, waiting up to timeout for one, or indefinitely if timeout is negative,
+// returns the number of processed events
+RTC_CPP_EXPORT int Poll(std::chrono::milliseconds timeout);
+RTC_CPP_EXPORT int ProcessEvents(); // Poll() without waiting
+
+struct PollDescriptor {
+	intptr_t fd; // socket on Windows
+	bool in;
+	bool out;
+};
+
+// To integrate in an application poll loop, call ProcessEvents() when a descriptor is ready or the
+// timeout expires. The list changes over time, but a descriptor is always ready when it does.
+RTC_CPP_EXPORT std::vector<PollDescriptor> GetPollDescriptors();
+RTC_CPP_EXPORT optional<std::chrono::milliseconds> GetPollTimeout(); // nullopt if none
+
 // Optional global preload and cleanup
 RTC_CPP_EXPORT bool Preload();
 RTC_CPP_EXPORT std::shared_future<void> Cleanup();
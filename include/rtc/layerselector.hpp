@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_LAYER_SELECTOR_H
+#define RTC_LAYER_SELECTOR_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "dependencydescriptor.hpp"
+#include "mediahandler.hpp"
+#include "rtp.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace rtc {
+
+// Scalable video layer selection: forwards only the spatial and temporal layers up to a target,
+// and drops the others while keeping sequence numbers contiguous. The marker bit is moved to the
+// end of the highest forwarded layer frame.
+//
+// Layers are identified with the dependency descriptor RTP header extension when present, which
+// works for any codec, and with the payload descriptor for VP9 otherwise. Switching to a lower
+// layer happens at the next frame, switching to a higher layer waits for a switch point.
+//
+// The selector handles both directions, so it can be chained on a receiving track, or on each
+// subscriber track of a forwarding server to select layers per subscriber. On a sending track, it
+// must be chained before RtcpNackResponder so retransmissions use the rewritten sequence numbers.
+class RTC_CPP_EXPORT LayerSelector final : public MediaHandler {
+public:
+	inline static const int AllLayers = 0xFF;
+	inline static const string DependencyDescriptorUri =
+	    "https://aomediacodec.github.io/av1-rtp-spec/#dependency-descriptor-rtp-header-extension";
+
+	/// @param dependencyDescriptorId Header extension id of the dependency descriptor, if zero it
+	/// is found in the media description
+	LayerSelector(uint8_t dependencyDescriptorId = 0);
+
+	/// Sets the maximum spatial and temporal layers to forward, can be changed at any time
+	void setTargetLayers(int spatialLayer, int temporalLayer);
+
+	/// Returns the spatial and temporal layers currently forwarded, or nullopt before the first
+	/// selectable packet
+	optional<std::pair<int, int>> currentLayers() const;
+
+	void media(const Description::Media &desc) override;
+	void incoming(message_vector &messages, const message_callback &send) override;
+	void outgoing(message_vector &messages, const message_callback &send) override;
+
+private:
+	enum class Decision { PassThrough, Forward, Drop };
+
+	void filter(message_vector &messages);
+	Decision select(message_ptr &message);
+	Decision selectWithDescriptor(const DependencyDescriptor &descriptor, bool &endOfLayers);
+	Decision selectVp9(const byte *payload, size_t size, bool &endOfLayers);
+	optional<int> findDecodeTarget(optional<uint32_t> activeDecodeTargetsBitmask) const;
+
+	uint8_t mDependencyDescriptorId;
+	std::unordered_set<uint8_t> mVp9PayloadTypes;
+	int mTargetSpatial = AllLayers;
+	int mTargetTemporal = AllLayers;
+
+	optional<SSRC> mSsrc;
+	uint16_t mSeqOffset = 0; // number of dropped packets
+
+	// Dependency descriptor state
+	DependencyDescriptorReader mReader;
+	shared_ptr<const FrameDependencyStructure> mStructure;
+	std::vector<std::pair<int, int>> mDecodeTargetLayers;
+	optional<int> mCurrentDecodeTarget;
+
+	// VP9 payload descriptor state
+	optional<uint16_t> mLastPictureId;
+
+	optional<std::pair<int, int>> mCurrentLayers; // spatial and temporal
+	mutable std::mutex mMutex;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_LAYER_SELECTOR_H */
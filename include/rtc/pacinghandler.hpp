@@ -14,16 +14,28 @@
 #include "mediahandler.hpp"
 #include "utils.hpp"
 
-#include <atomic>
-#include <queue>
+#include <mutex>
+#include <vector>
 
 namespace rtc {
 
+namespace impl {
+
+struct PacingFlow;
+
+} // namespace impl
+
 // Paced sending of RTP packets. It takes a stream of RTP packets that can have an uneven bitrate
-// and delivers them in a smoother manner by sending a fixed size of them on an interval
+// and delivers them in a smoother manner, at most the amount sent at the bitrate over sendInterval
+// at once. All pacers are served by a shared engine with a precise timer. Audio and retransmissions
+// have priority: they may exceed the bitrate of their pacer, borrowing from the budget shared by
+// all pacers, which delays video. Retransmissions are paced when the RtcpNackResponder is chained
+// before the pacer. Handlers chained after it process packets when they are released rather than
+// when queued.
 class RTC_CPP_EXPORT PacingHandler : public MediaHandler {
 public:
 	PacingHandler(double bitsPerSecond, std::chrono::milliseconds sendInterval, size_t maxQueueSize=0);
+	~PacingHandler();
 
 	void setBitrate(double bitsPerSecond);
 
@@ -31,27 +43,27 @@ public:
 
 	void onOverflow(std::function<void()> callback);
 
+	void media(const Description::Media &desc) override;
 	void outgoing(message_vector &messages, const message_callback &send) override;
 
 private:
-	std::atomic<bool> mHaveScheduled = false;
-
 	double mBytesPerSecond;
-	double mBudget;
-
 	std::chrono::milliseconds mSendInterval;
-	std::chrono::time_point<std::chrono::high_resolution_clock> mLastRun;
-
 	size_t mMaxQueueAmount;
 
-	std::mutex mParamsMutex;
+	bool mAudio = false;
+	std::vector<SSRC> mRetransmissionSsrcs;
+
+	shared_ptr<impl::PacingFlow> mFlow;
+	message_callback mSend;
+
 	std::mutex mMutex;
-	std::queue<message_ptr> mRtpBuffer;
 
 	synchronized_callback<> mOverflowCallback;
 
-	void schedule(const message_callback &send, std::chrono::milliseconds scheduleInterval);
-	void run(const message_callback &send);
+	double burstSize() const;
+	void updatePriority();
+	void release(message_vector &messages);
 };
 
 } // namespace rtc
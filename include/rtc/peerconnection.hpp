@@ -15,6 +15,7 @@
 #include "datachannel.hpp"
 #include "description.hpp"
 #include "reliability.hpp"
+#include "stats.hpp"
 #include "track.hpp"
 
 #include <chrono>
@@ -130,6 +131,7 @@ public:
 	size_t bytesSent();
 	size_t bytesReceived();
 	optional<std::chrono::milliseconds> rtt();
+	StatsReport stats();
 };
 
 RTC_CPP_EXPORT std::ostream &operator<<(std::ostream &out, PeerConnection::State state);
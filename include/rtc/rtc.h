@@ -257,6 +257,26 @@ RTC_C_EXPORT bool rtcIsNegotiationNeeded(int pc);
 RTC_C_EXPORT int rtcGetMaxDataChannelStream(int pc);
 RTC_C_EXPORT int rtcGetRemoteMaxMessageSize(int pc);
 
+typedef struct {
+	// ICE selected candidate pair, see rtcGetSelectedCandidatePair()
+	uint64_t packetsSent;
+	uint64_t bytesSent;
+	uint64_t packetsReceived;
+	uint64_t bytesReceived;
+	// SCTP association, negative means not available
+	int sctpRtt; // ms
+	int sctpRto; // ms
+	int sctpCongestionWindow;
+	int sctpUnackedChunks;
+	// SRTP
+	uint64_t srtpPacketsTruncated;
+	uint64_t srtpReplays;
+	uint64_t srtpAuthFailures;
+	uint64_t srtpOtherFailures;
+} rtcTransportStats;
+
+RTC_C_EXPORT int rtcGetTransportStats(int pc, rtcTransportStats *stats);
+
 // DataChannel, Track, and WebSocket common API
 
 RTC_C_EXPORT int rtcSetOpenCallback(int id, rtcOpenCallbackFunc cb);
@@ -308,6 +328,16 @@ RTC_C_EXPORT int rtcGetDataChannelLabel(int dc, char *buffer, int size);
 RTC_C_EXPORT int rtcGetDataChannelProtocol(int dc, char *buffer, int size);
 RTC_C_EXPORT int rtcGetDataChannelReliability(int dc, rtcReliability *reliability);
 
+typedef struct {
+	uint64_t messagesSent;
+	uint64_t bytesSent;
+	uint64_t messagesReceived;
+	uint64_t bytesReceived;
+	uint64_t bufferedAmount;
+} rtcDataChannelStats;
+
+RTC_C_EXPORT int rtcGetDataChannelStats(int dc, rtcDataChannelStats *stats);
+
 // Track
 
 typedef struct {
@@ -331,6 +361,30 @@ RTC_C_EXPORT int rtcGetTrackDescription(int tr, char *buffer, int size);
 RTC_C_EXPORT int rtcGetTrackMid(int tr, char *buffer, int size);
 RTC_C_EXPORT int rtcGetTrackDirection(int tr, rtcDirection *direction);
 
+typedef struct {
+	// Outbound
+	uint64_t packetsSent;
+	uint64_t bytesSent;
+	uint64_t nackCount; // received
+	uint64_t pliCount;  // received
+	uint64_t firCount;  // received
+	bool hasRemoteReport; // if false, remotePacketsLost and remoteJitter are not available
+	int64_t remotePacketsLost;
+	double remoteJitter; // seconds, negative means not available
+	// Inbound
+	uint64_t packetsReceived;
+	uint64_t bytesReceived;
+	uint64_t nackSent;
+	uint64_t pliSent;
+	uint64_t firSent;
+	uint64_t packetsDiscarded;
+	bool hasReceptionStats; // if false, packetsLost and jitter are not available
+	int64_t packetsLost;
+	double jitter; // seconds, negative means not available
+} rtcTrackStats;
+
+RTC_C_EXPORT int rtcGetTrackStats(int tr, rtcTrackStats *stats);
+
 RTC_C_EXPORT int rtcRequestKeyframe(int tr);
 RTC_C_EXPORT int rtcRequestBitrate(int tr, unsigned int bitrate);
 
@@ -517,6 +571,11 @@ RTC_C_EXPORT RTC_DEPRECATED int rtcSetNeedsToSendRtcpSr(int id);
 
 // WebSocket
 
+typedef enum {
+	RTC_SEND_BUFFER_BLOCK = 0, // wait for the send buffer to drain
+	RTC_SEND_BUFFER_DROP = 1   // drop the message
+} rtcSendBufferPolicy;
+
 typedef struct {
 	bool disableTlsVerification; // if true, don't verify the TLS certificate
 	const char *proxyServer;     // only non-authenticated http supported for now
@@ -527,6 +586,9 @@ typedef struct {
 	int pingIntervalMs;         // in milliseconds, 0 means default, < 0 means disabled
 	int maxOutstandingPings;    // 0 means default, < 0 means disabled
 	int maxMessageSize;         // <= 0 means default
+	bool enableKernelTls;       // if true, offload TLS encryption to the kernel if possible
+	int maxBufferedAmount;      // <= 0 means unlimited
+	rtcSendBufferPolicy sendBufferPolicy;
 } rtcWsConfiguration;
 
 RTC_C_EXPORT int rtcCreateWebSocket(const char *url); // returns ws id
@@ -549,6 +611,10 @@ typedef struct {
 	const char *bindAddress;        // NULL for any
 	int connectionTimeoutMs;        // in milliseconds, 0 means default, < 0 means disabled
 	int maxMessageSize;             // <= 0 means default
+	int acceptThreads;              // <= 0 means 1
+	bool enableKernelTls;           // if true, offload TLS encryption to the kernel if possible
+	int maxBufferedAmount;          // <= 0 means unlimited
+	rtcSendBufferPolicy sendBufferPolicy;
 } rtcWsServerConfiguration;
 
 RTC_C_EXPORT int rtcCreateWebSocketServer(const rtcWsServerConfiguration *config,
@@ -582,6 +648,11 @@ typedef struct {
 // Note: SCTP settings apply to newly-created PeerConnections only
 RTC_C_EXPORT int rtcSetSctpSettings(const rtcSctpSettings *settings);
 
+// External event loop, applied on initialization
+RTC_C_EXPORT int rtcSetExternalEventLoop(bool enabled);
+RTC_C_EXPORT int rtcPoll(int timeout); // in milliseconds, negative to wait indefinitely, returns
+                                       // the number of processed events
+
 // Optional global preload and cleanup
 RTC_C_EXPORT bool rtcPreload(void);
 RTC_C_EXPORT void rtcCleanup(void);
@@ -13,9 +13,11 @@
 #include "common.hpp"
 #include "global.hpp"
 //
+#include "coroutine.hpp" // coroutines only if C++20 is used
 #include "datachannel.hpp"
 #include "iceudpmuxlistener.hpp"
 #include "peerconnection.hpp"
+#include "stats.hpp"
 #include "track.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
@@ -48,7 +50,13 @@
 #include "rembhandler.hpp"
 #include "pacinghandler.hpp"
 #include "rtcpnackresponder.hpp"
+#include "rtppackethistory.hpp"
 #include "rtcpreceivingsession.hpp"
 #include "rtcpsrreporter.hpp"
+#include "transportcchandler.hpp"
+#include "transportccreporter.hpp"
+#include "bandwidthestimator.hpp"
+#include "layerselector.hpp"
+#include "rtpforwarder.hpp"
 
 #endif // RTC_ENABLE_MEDIA
@@ -14,18 +14,32 @@
 #include "mediahandler.hpp"
 #include "description.hpp"
 #include "rtp.hpp"
+#include "rtppackethistory.hpp"
 
+#include <chrono>
 #include <mutex>
-#include <queue>
 #include <unordered_map>
 
 namespace rtc {
 
+// Answers NACKs with packets from a history. Retransmissions are passed through the handlers
+// chained after the responder, like outgoing packets.
 class RTC_CPP_EXPORT RtcpNackResponder final : public MediaHandler {
 public:
-	static const size_t DefaultMaxSize = 512;
+	static const size_t DefaultMaxSize = RtpPacketHistory::DefaultMaxSize;
 
-	RtcpNackResponder(size_t maxSize = DefaultMaxSize);
+	/// Constructs a responder storing outgoing packets in its own history
+	/// @param maxSize Maximum number of stored packets, rounded up to a power of two (max 32768)
+	/// @param maxAge Retention window for stored packets, zero means packets are only evicted when
+	/// the storage is full
+	RtcpNackResponder(size_t maxSize = DefaultMaxSize,
+	                  std::chrono::milliseconds maxAge = std::chrono::milliseconds::zero());
+
+	/// Constructs a responder answering from a shared history filled by the application
+	/// Outgoing packets are not stored, retransmitted packets are rewritten to the SSRC of the NACK.
+	/// @param history Shared packet history
+	/// @param sourceSsrc SSRC of packets in history, if unset the SSRC of the NACK is used
+	RtcpNackResponder(shared_ptr<RtpPacketHistory> history, optional<SSRC> sourceSsrc = nullopt);
 
 	void media(const Description::Media &desc) override;
 	void incoming(message_vector &messages, const message_callback &send) override;
@@ -33,6 +47,7 @@ public:
 
 private:
 	message_ptr wrapInRtx(const message_ptr &original);
+	message_ptr rewriteSsrc(const message_ptr &original, SSRC ssrc);
 
 	// RTX state populated by media() from SDP inspection
 	optional<SSRC> mRtxSsrc;
@@ -41,45 +56,9 @@ private:
 	bool mRtxEnabled = false;
 	std::mutex mMutex;
 
-	// Packet storage
-	class RTC_CPP_EXPORT Storage {
-
-		/// Packet storage element
-		struct RTC_CPP_EXPORT Element {
-			Element(message_ptr packet, uint16_t sequenceNumber, shared_ptr<Element> next = nullptr);
-			const message_ptr packet;
-			const uint16_t sequenceNumber;
-			/// Pointer to newer element
-			shared_ptr<Element> next = nullptr;
-		};
-
-	private:
-		/// Oldest packet in storage
-		shared_ptr<Element> oldest = nullptr;
-		/// Newest packet in storage
-		shared_ptr<Element> newest = nullptr;
-		/// Inner storage
-		std::unordered_map<uint16_t, shared_ptr<Element>> storage{};
-		std::mutex mutex;
-
-		/// Maximum storage size
-		const size_t maxSize;
-
-		/// Returns current size
-		size_t size();
-
-	public:
-		Storage(size_t _maxSize);
-
-		/// Returns packet with given sequence number
-		message_ptr get(uint16_t sequenceNumber);
-
-		/// Stores packet
-		/// @param packet Packet
-		void store(message_ptr packet);
-	};
-
-	const shared_ptr<Storage> mStorage;
+	const shared_ptr<RtpPacketHistory> mHistory;
+	const bool mSharedHistory;
+	const optional<SSRC> mSourceSsrc;
 };
 
 } // namespace rtc
@@ -18,7 +18,9 @@
 #include "message.hpp"
 #include "rtp.hpp"
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <mutex>
 #include <unordered_map>
 #include <vector>
@@ -49,28 +51,63 @@ public:
 
 	SyncTimestamps getSyncTimestamps();
 
+	// Reception statistics for a remote source
+	struct SourceStats {
+		SSRC ssrc;
+		uint32_t packetsReceived;
+		int32_t packetsLost;           // cumulative, negative if duplicates were received
+		double fractionLost;           // over the last report interval, between 0 and 1
+		uint32_t extendedHighestSeqNo; // cycles count in the upper 16 bits
+		uint32_t jitter;               // interarrival jitter in timestamp units
+		uint32_t clockRate;            // zero if unknown
+	};
+
+	/// Returns a snapshot of the statistics of all remote sources
+	std::vector<SourceStats> getSourceStats();
+
+	inline static const size_t MaxSources = 64;
+	inline static const size_t MaxReportBlocks = 31; // per RR
+	inline static const std::chrono::milliseconds MinReportInterval{500};
+
 protected:
+	// RFC 3550 per-source state, see https://www.rfc-editor.org/rfc/rfc3550.html#appendix-A.1
+	struct Source {
+		bool initialized = false;
+		uint16_t maxSeq = 0;        // highest seq. number seen
+		uint32_t cycles = 0;        // shifted count of seq. number cycles
+		uint32_t baseSeq = 0;       // base seq number
+		uint32_t badSeq = RTP_SEQ_MOD + 1; // last 'bad' seq number + 1
+		uint32_t received = 0;      // packets received
+		uint32_t expectedPrior = 0; // packet expected at last interval
+		uint32_t receivedPrior = 0; // packet received at last interval
+		uint8_t fractionLost = 0;   // at last interval
+		uint32_t transit = 0;       // relative trans time for prev pkt
+		bool hasTransit = false;
+		uint32_t jitter = 0;        // estimated jitter, scaled by 16
+		uint32_t clockRate = 0;
+		uint64_t lastSrNtp = 0;     // NTP timestamp of last SR
+		std::chrono::steady_clock::time_point lastSrTime;
+
+		void initSeq(uint16_t seq);
+		bool updateSeq(uint16_t seq);
+		uint32_t expected() const;
+	};
+
 	void pushREMB(const message_callback &send, unsigned int bitrate);
-	void pushRR(const message_callback &send,unsigned int lastSrDelay);
+	void pushRR(const message_callback &send);
 	void pushPLI(const message_callback &send);
 	void pushFIR(const message_callback &send, const std::vector<SSRC>& targetSSRCs, bool retransmit);
 
-	void initSeq(uint16_t seq);
-	bool updateSeq(uint16_t seq);
-	
+	Source *getSource(SSRC ssrc); // nullptr if there are too many sources
+	void updateJitter(Source &source, const RtpHeader *rtp, std::chrono::steady_clock::time_point now);
+
 	SSRC mSsrc = 0;
-	uint32_t mGreatestSeqNo = 0;
-    uint16_t mMaxSeq = 0;			// highest seq. number seen
-    uint32_t mCycles = 0;			// shifted count of seq. number cycles
-	uint32_t mBaseSeq = 0;			// base seq number
-    uint32_t mBadSeq = 0;			// last 'bad' seq number + 1
-	uint32_t mProbation = 0;		// sequ. packets till source is valid
-    uint32_t mReceived = 0;			// packets received
-    uint32_t mExpectedPrior = 0;	// packet expected at last interval
-    uint32_t mReceivedPrior = 0;	// packet received at last interval
-	uint32_t mTransit = 0;			// relative trans time for prev pkt
-	uint32_t mJitter = 0;	
-	
+	SSRC mLocalSsrc = 0;
+	std::unordered_map<SSRC, Source> mSources;
+	std::array<uint32_t, 128> mClockRates = {}; // by payload type
+	const std::chrono::steady_clock::time_point mEpoch = std::chrono::steady_clock::now();
+	optional<std::chrono::steady_clock::time_point> mLastReportTime;
+
 	SyncTimestamps mSyncTimestamps{0,0};
 
 	std::atomic<unsigned int> mRequestedBitrate = 0;
@@ -45,6 +45,10 @@ struct RTC_CPP_EXPORT RtpExtensionHeader {
 	size_t writeTwoByteHeader(size_t offset, uint8_t id, const byte *value, size_t size);
 	size_t writeHeader(bool twoByteHeader, size_t offset, uint8_t id, const byte *value,
 	                   size_t size);
+
+	// Returns the value of the element with the given id, or nullptr if it is not present
+	[[nodiscard]] const byte *findHeader(uint8_t id, size_t *size = nullptr) const;
+	[[nodiscard]] byte *findHeader(uint8_t id, size_t *size = nullptr);
 };
 
 struct RTC_CPP_EXPORT RtpHeader {
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTP_FORWARDER_H
+#define RTC_RTP_FORWARDER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "rtp.hpp"
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rtc {
+
+class Track;
+
+// Selective forwarding: fans out the incoming RTP stream of a track to any number of subscriber
+// tracks, rewriting SSRC, sequence number, timestamp and payload type per subscriber so each one
+// receives a single continuous stream.
+//
+// For simulcast, each incoming SSRC is a layer and every subscriber receives one layer at a time.
+// Switching layers happens on the next keyframe of the target layer, which is requested from the
+// sender. For temporal scalability (VP8 and VP9), packets above the subscriber's maximum temporal
+// layer are dropped and sequence numbers stay contiguous.
+//
+// The forwarder consumes incoming RTP packets, RTCP packets are passed through.
+class RTC_CPP_EXPORT RtpForwarder final : public MediaHandler {
+public:
+	inline static const std::chrono::milliseconds MinKeyframeRequestInterval{500};
+	inline static const uint8_t AllTemporalLayers = 0xFF;
+
+	RtpForwarder();
+
+	/// Sets the incoming SSRCs of simulcast layers, from the lowest to the highest quality. If no
+	/// layers are set, all incoming RTP packets are considered to be a single layer.
+	void setLayers(std::vector<SSRC> ssrcs);
+
+	using SubscriberId = unsigned int;
+	using packet_callback = std::function<void(binary packet)>;
+
+	/// Adds a subscriber track, starting at the next keyframe of the selected layer
+	/// @param track Subscriber track, packets are forwarded while it is open
+	/// @param ssrc SSRC of the forwarded stream
+	/// @param payloadType Payload type of the forwarded stream, if nullopt it is unchanged
+	/// @param layer Initial layer index, clamped to the highest layer
+	/// @return the subscriber id
+	SubscriberId addSubscriber(shared_ptr<Track> track, SSRC ssrc,
+	                           optional<uint8_t> payloadType = nullopt, unsigned int layer = 0);
+	/// Adds a subscriber receiving rewritten RTP packets through a callback, for instance to relay
+	/// or record the stream
+	SubscriberId addSubscriber(packet_callback callback, SSRC ssrc,
+	                           optional<uint8_t> payloadType = nullopt, unsigned int layer = 0);
+	void removeSubscriber(SubscriberId id);
+	size_t subscriberCount() const;
+
+	/// Selects the layer forwarded to a subscriber, effective at the next keyframe of that layer
+	void setLayer(SubscriberId id, unsigned int layer);
+	/// Selects the maximum temporal layer forwarded to a subscriber, effective at the next frame
+	/// of the base temporal layer
+	void setTemporalLayer(SubscriberId id, uint8_t temporalLayer);
+	/// Requests a keyframe from the sender for the layer forwarded to a subscriber, typically
+	/// called from a PliHandler on the subscriber track
+	/// @return false if the subscriber was removed, in which case nothing is requested
+	bool requestKeyframe(SubscriberId id);
+
+	void media(const Description::Media &desc) override;
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	enum class Codec { Unknown, H264, H265, VP8, VP9, AV1 };
+
+	// Properties of an incoming packet, parsed once and shared by subscribers
+	struct PacketInfo {
+		unsigned int layer;
+		bool keyframe;          // first packet of a keyframe
+		bool frameStart;        // first packet of a frame
+		uint8_t temporalLayer;  // zero if unknown
+	};
+
+	struct Subscriber {
+		SubscriberId id;
+		optional<weak_ptr<Track>> track;
+		shared_ptr<packet_callback> callback;
+		SSRC ssrc;
+		optional<uint8_t> payloadType;
+		unsigned int targetLayer;
+		optional<unsigned int> currentLayer; // nullopt until the first keyframe
+		uint8_t maxTemporalLayer = AllTemporalLayers;
+		uint8_t currentTemporalLayer = AllTemporalLayers;
+		bool started = false;
+		uint16_t seqOffset = 0;
+		uint32_t timestampOffset = 0;
+		uint16_t lastSeq = 0;
+		uint32_t lastTimestamp = 0;
+		std::chrono::steady_clock::time_point lastTime;
+	};
+
+	SubscriberId addSubscriber(Subscriber sub, unsigned int layer);
+	Subscriber &getSubscriber(SubscriberId id);
+	optional<unsigned int> layerOf(SSRC ssrc) const;
+	PacketInfo parse(const RtpHeader *rtp, const byte *payload, size_t size,
+	                 unsigned int layer) const;
+	// Updates the subscriber state and returns true if the packet must be forwarded
+	bool rewrite(Subscriber &sub, const RtpHeader *rtp, const PacketInfo &info,
+	             std::chrono::steady_clock::time_point now, uint16_t &outSeq,
+	             uint32_t &outTimestamp);
+
+	std::vector<SSRC> mLayers;
+	SSRC mLastSsrc = 0; // incoming SSRC if no layers are set
+	std::vector<Subscriber> mSubscribers;
+	SubscriberId mNextSubscriberId = 1;
+	std::unordered_map<uint8_t, Codec> mCodecs;         // by payload type
+	std::unordered_map<uint8_t, uint32_t> mClockRates;  // by payload type
+	std::vector<unsigned int> mPendingKeyframeRequests; // layers
+	std::unordered_map<unsigned int, std::chrono::steady_clock::time_point> mLastKeyframeRequests;
+	mutable std::mutex mMutex;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTP_FORWARDER_H */
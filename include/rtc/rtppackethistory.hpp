@@ -0,0 +1,98 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_RTP_PACKET_HISTORY_H
+#define RTC_RTP_PACKET_HISTORY_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "message.hpp"
+#include "rtp.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace rtc {
+
+/// History of sent RTP packets indexed by SSRC and sequence number, used to answer NACKs.
+/// It can be shared between multiple RtcpNackResponder instances, for instance when a SFU forwards
+/// the same stream to multiple subscribers, so forwarded packets are stored only once.
+class RTC_CPP_EXPORT RtpPacketHistory final {
+public:
+	static const size_t DefaultMaxSize = 512;
+
+	/// @param maxSize Maximum number of packets per SSRC, rounded up to a power of two (max 32768)
+	/// @param maxAge Retention window for stored packets, zero means packets are only evicted when
+	/// the history is full
+	RtpPacketHistory(size_t maxSize = DefaultMaxSize,
+	                 std::chrono::milliseconds maxAge = std::chrono::milliseconds::zero());
+
+	/// Stores packet
+	/// @param packet RTP packet
+	void store(message_ptr packet);
+
+	/// Returns packet with given SSRC and sequence number, or nullptr if it is not in history
+	message_ptr get(SSRC ssrc, uint16_t sequenceNumber);
+
+	/// Removes all packets with given SSRC. Streams with no packet stored for a while are also
+	/// removed automatically.
+	void remove(SSRC ssrc);
+
+private:
+	/// Ring buffer indexed by sequence number & mask
+	class Ring {
+	public:
+		Ring(uint16_t mask);
+
+		message_ptr get(uint16_t sequenceNumber, std::chrono::steady_clock::time_point now,
+		                std::chrono::milliseconds maxAge) const;
+		void store(message_ptr packet, uint16_t sequenceNumber,
+		           std::chrono::steady_clock::time_point now, std::chrono::milliseconds maxAge);
+		std::chrono::steady_clock::time_point lastStored() const;
+
+	private:
+		struct Slot {
+			message_ptr packet;
+			uint16_t sequenceNumber = 0;
+			std::chrono::steady_clock::time_point timestamp;
+		};
+
+		/// Releases all packets
+		void reset();
+		/// Releases packets overwritten or older than maxAge
+		void release(std::chrono::steady_clock::time_point now, std::chrono::milliseconds maxAge);
+
+		std::vector<Slot> mSlots;
+		uint16_t mMask;
+		/// Oldest and newest sequence numbers possibly in storage
+		uint16_t mOldest = 0;
+		uint16_t mNewest = 0;
+		bool mEmpty = true;
+	};
+
+	/// Removes rings of streams idle for longer than the timeout
+	void removeIdle(std::chrono::steady_clock::time_point now);
+
+	const uint16_t mMask;
+	const std::chrono::milliseconds mMaxAge;
+
+	std::unordered_map<SSRC, Ring> mRings;
+	std::chrono::steady_clock::time_point mLastIdleCheck;
+	Ring *mLastRing = nullptr; // cache for the common single-stream case
+	SSRC mLastSsrc = 0;
+	std::mutex mMutex;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_RTP_PACKET_HISTORY_H */
@@ -103,6 +103,11 @@ public:
 	// https://webrtc.googlesource.com/src/+/refs/heads/main/docs/native-code/rtp-hdrext/abs-capture-time
 	uint8_t absCaptureTimeId = 0;
 
+	// Transport-wide sequence number RTP header extension. When transportCcId > 0, the
+	// RtpPacketizer reserves the element so a TransportCcHandler can stamp it in place.
+	// https://datatracker.ietf.org/doc/html/draft-holmer-rmcat-transport-wide-cc-extensions-01
+	uint8_t transportCcId = 0;
+
 	/// Construct RTP configuration used in packetization process
 	/// @param ssrc SSRC of source
 	/// @param cname CNAME of source
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_STATS_H
+#define RTC_STATS_H
+
+#include "candidate.hpp"
+#include "common.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace rtc {
+
+// Statistics modelled on the W3C RTCStatsReport, see https://www.w3.org/TR/webrtc-stats/
+// Counters are cumulative since the object was created and are read without blocking the
+// media or data paths.
+
+// Equivalent to RTCOutboundRtpStreamStats, RTCInboundRtpStreamStats, and
+// RTCRemoteInboundRtpStreamStats for a track
+struct RTC_CPP_EXPORT TrackStats {
+	string mid;
+
+	// Outbound RTP, counted after the media handler chain
+	uint64_t packetsSent = 0;
+	uint64_t bytesSent = 0;
+	uint64_t nackCount = 0; // NACK packets received
+	uint64_t pliCount = 0;  // PLI packets received
+	uint64_t firCount = 0;  // FIR packets received
+
+	// As reported by the remote peer in its last receiver report
+	optional<int64_t> remotePacketsLost;
+	optional<double> remoteJitter; // in seconds, unset if the clock rate is unknown
+
+	// Inbound RTP, counted before the media handler chain
+	uint64_t packetsReceived = 0;
+	uint64_t bytesReceived = 0;
+	uint64_t nackSent = 0;
+	uint64_t pliSent = 0;
+	uint64_t firSent = 0;
+	uint64_t packetsDiscarded = 0; // dropped because the receive queue was full
+
+	// Only available if an RtcpReceivingSession is chained on the track
+	optional<int64_t> packetsLost;
+	optional<double> jitter; // in seconds, unset if the clock rate is unknown
+};
+
+// Equivalent to RTCDataChannelStats
+struct RTC_CPP_EXPORT DataChannelStats {
+	string label;
+	optional<uint16_t> stream;
+	uint64_t messagesSent = 0;
+	uint64_t bytesSent = 0;
+	uint64_t messagesReceived = 0;
+	uint64_t bytesReceived = 0;
+	size_t bufferedAmount = 0;
+};
+
+// Equivalent to RTCTransportStats and RTCIceCandidatePairStats for the selected pair
+struct RTC_CPP_EXPORT TransportStats {
+	// ICE selected candidate pair
+	optional<Candidate> localCandidate;
+	optional<Candidate> remoteCandidate;
+	uint64_t packetsSent = 0;
+	uint64_t bytesSent = 0;
+	uint64_t packetsReceived = 0;
+	uint64_t bytesReceived = 0;
+
+	// SCTP association, only if it is connected
+	optional<std::chrono::milliseconds> sctpRtt; // smoothed round-trip time
+	optional<std::chrono::milliseconds> sctpRto; // retransmission timeout
+	optional<size_t> sctpCongestionWindow;       // in bytes
+	optional<size_t> sctpUnackedChunks;          // DATA chunks awaiting acknowledgment
+
+	// SRTP, only if media is transported
+	uint64_t srtpPacketsTruncated = 0;
+	uint64_t srtpReplays = 0;       // replayed SRTP and SRTCP packets
+	uint64_t srtpAuthFailures = 0;  // SRTP and SRTCP packets failing authentication
+	uint64_t srtpOtherFailures = 0; // other SRTP and SRTCP unprotect errors
+};
+
+struct RTC_CPP_EXPORT StatsReport {
+	std::chrono::steady_clock::time_point timestamp;
+	TransportStats transport;
+	std::vector<TrackStats> tracks;
+	std::vector<DataChannelStats> dataChannels;
+};
+
+} // namespace rtc
+
+#endif
@@ -13,6 +13,7 @@
 #include "common.hpp"
 #include "description.hpp"
 #include "mediahandler.hpp"
+#include "stats.hpp"
 
 #include <vector>
 
@@ -43,6 +44,8 @@ public:
 	bool isClosed(void) const override;
 	size_t maxMessageSize() const override;
 
+	TrackStats stats() const;
+
 	void sendFrame(binary data, FrameInfo info);
 	void sendFrame(const byte *data, size_t size, FrameInfo info);
 	void onFrame(std::function<void(binary data, FrameInfo info)> callback);
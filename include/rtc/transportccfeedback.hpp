@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_TRANSPORT_CC_FEEDBACK_H
+#define RTC_TRANSPORT_CC_FEEDBACK_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "common.hpp"
+#include "message.hpp"
+#include "rtp.hpp"
+
+#include <chrono>
+#include <vector>
+
+namespace rtc {
+
+// RTCP transport-wide congestion control feedback (PT=205, FMT=15)
+// See https://datatracker.ietf.org/doc/html/draft-holmer-rmcat-transport-wide-cc-extensions-01
+struct RTC_CPP_EXPORT TransportCcFeedback {
+	// URI of the transport-wide sequence number RTP header extension
+	inline static const string ExtensionUri =
+	    "http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01";
+
+	inline static const uint8_t PayloadType = 205;
+	inline static const uint8_t Format = 15;
+
+	// Receive deltas are expressed in multiples of 250 us
+	inline static const std::chrono::microseconds DeltaResolution{250};
+	// Reference time is expressed in multiples of 64 ms
+	inline static const std::chrono::microseconds ReferenceTimeResolution{64000};
+
+	struct Packet {
+		uint16_t sequenceNumber = 0;
+		bool received = false;
+		/// Receive delta from the previous received packet, or from the reference time for the
+		/// first one, valid if received
+		std::chrono::microseconds delta = std::chrono::microseconds::zero();
+		/// Arrival time in the remote time base, valid if received
+		std::chrono::microseconds arrivalTime = std::chrono::microseconds::zero();
+	};
+
+	SSRC senderSsrc = 0;
+	SSRC mediaSsrc = 0;
+	uint16_t baseSequenceNumber = 0;
+	int32_t referenceTime = 0; // 24-bit signed, in multiples of 64 ms
+	uint8_t feedbackCount = 0;
+	std::vector<Packet> packets; // consecutive sequence numbers starting at baseSequenceNumber
+
+	/// Returns true if the RTCP packet is transport-wide congestion control feedback
+	static bool IsTransportCc(const RtcpHeader *header);
+
+	/// Parses a single RTCP packet
+	/// @return the feedback or nullopt if the packet is invalid
+	static optional<TransportCcFeedback> Parse(const byte *data, size_t size);
+
+	/// Serializes as a RTCP packet, using packets' arrival times and referenceTime. Receive deltas
+	/// must fit in 16 bits, i.e. arrival times must be within about 8 s of each other.
+	message_ptr serialize() const;
+};
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
+
+#endif /* RTC_TRANSPORT_CC_FEEDBACK_H */
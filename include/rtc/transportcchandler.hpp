@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_TRANSPORT_CC_HANDLER_H
+#define RTC_TRANSPORT_CC_HANDLER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "transportccfeedback.hpp"
+#include "utils.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace rtc {
+
+// Result for a sent packet reported in transport-wide congestion control feedback
+struct RTC_CPP_EXPORT TransportCcPacketResult {
+	uint16_t sequenceNumber; // transport-wide sequence number
+	size_t size;             // packet size in bytes
+	std::chrono::steady_clock::time_point sendTime;
+	optional<std::chrono::microseconds> arrivalTime; // in the remote time base, nullopt if lost
+};
+
+// Transport-wide congestion control state. Sequence numbers are transport-wide, so a single
+// session must be shared by the handlers of all tracks of the same PeerConnection.
+class RTC_CPP_EXPORT TransportCcSession final {
+public:
+	using feedback_callback = std::function<void(std::vector<TransportCcPacketResult> results)>;
+
+	static const size_t DefaultMaxPendingPackets = 200;
+
+	TransportCcSession();
+
+	/// Sets the callback called with per-packet results each time feedback is received
+	void onFeedback(feedback_callback callback);
+
+	// Sender side
+	/// Registers a packet sent now and returns its transport-wide sequence number
+	uint16_t registerSentPacket(size_t size);
+	/// Matches received feedback with sent packets and calls the feedback callback
+	void processFeedback(const TransportCcFeedback &feedback);
+
+	// Receiver side
+	/// Registers a packet received now with the given transport-wide sequence number
+	void registerReceivedPacket(uint16_t sequenceNumber);
+	/// Returns serialized feedback if interval elapsed since the last one or too many packets are
+	/// pending, empty otherwise
+	std::vector<message_ptr> generateFeedback(SSRC senderSsrc, SSRC mediaSsrc,
+	                                          std::chrono::milliseconds interval,
+	                                          size_t maxPendingPackets = DefaultMaxPendingPackets);
+
+private:
+	struct SentPacket {
+		uint16_t sequenceNumber = 0;
+		size_t size = 0;
+		std::chrono::steady_clock::time_point sendTime;
+		bool valid = false;
+	};
+
+	struct ReceivedPacket {
+		int64_t sequenceNumber; // unwrapped
+		std::chrono::steady_clock::time_point arrivalTime;
+	};
+
+	const std::chrono::steady_clock::time_point mEpoch;
+
+	// Sender side
+	std::vector<SentPacket> mSentPackets; // ring buffer indexed by sequence number & mask
+	uint16_t mSequenceNumber = 1;
+	optional<std::pair<uint8_t, uint16_t>> mLastFeedback; // feedback count and base sequence number
+	synchronized_callback<std::vector<TransportCcPacketResult>> mFeedbackCallback;
+
+	// Receiver side
+	std::vector<ReceivedPacket> mReceivedPackets;
+	optional<int64_t> mLastReceivedSequenceNumber;
+	optional<int64_t> mNextBaseSequenceNumber;
+	std::chrono::steady_clock::time_point mLastFeedbackTime;
+	uint8_t mFeedbackCount = 0;
+
+	std::mutex mMutex;
+};
+
+// Sender-side transport-wide congestion control: stamps the transport-wide sequence number header
+// extension in outgoing packets and parses feedback. When chained after a PacingHandler, packets
+// are stamped at the time they are actually sent.
+class RTC_CPP_EXPORT TransportCcHandler final : public MediaHandler {
+public:
+	/// @param session Transport-wide session, shared between tracks of the same PeerConnection
+	/// @param extensionId Header extension id, if zero it is read from the media description
+	TransportCcHandler(shared_ptr<TransportCcSession> session, uint8_t extensionId = 0);
+
+	void media(const Description::Media &desc) override;
+	void incoming(message_vector &messages, const message_callback &send) override;
+	void outgoing(message_vector &messages, const message_callback &send) override;
+
+private:
+	const shared_ptr<TransportCcSession> mSession;
+	const uint8_t mConfiguredExtensionId;
+	std::atomic<uint8_t> mExtensionId;
+};
+
+} // namespace rtc
+
+#endif // RTC_ENABLE_MEDIA
+
+#endif // RTC_TRANSPORT_CC_HANDLER_H
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_TRANSPORT_CC_REPORTER_H
+#define RTC_TRANSPORT_CC_REPORTER_H
+
+#if RTC_ENABLE_MEDIA
+
+#include "mediahandler.hpp"
+#include "transportcchandler.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace rtc {
+
+// Receiver-side transport-wide congestion control: records arrival times of incoming packets
+// carrying the transport-wide sequence number header extension and sends RTCP feedback.
+class RTC_CPP_EXPORT TransportCcReporter final : public MediaHandler {
+public:
+	inline static const std::chrono::milliseconds DefaultInterval{100};
+
+	/// @param session Transport-wide session, shared between tracks of the same PeerConnection
+	/// @param extensionId Header extension id, if zero it is read from the media description
+	/// @param interval Feedback interval
+	TransportCcReporter(shared_ptr<TransportCcSession> session, uint8_t extensionId = 0,
+	                    std::chrono::milliseconds interval = DefaultInterval);
+
+	void media(const Description::Media &desc) override;
+	void incoming(message_vector &messages, const message_callback &send) override;
+
+private:
+	const shared_ptr<TransportCcSession> mSession;
+	const uint8_t mConfiguredExtensionId;
+	const std::chrono::milliseconds mInterval;
+	std::atomic<uint8_t> mExtensionId;
+	std::atomic<SSRC> mLocalSsrc = 1; // used as sender SSRC if the track has no local SSRC
+	std::atomic<SSRC> mMediaSsrc = 0;
+};
+
+} // namespace rtc
+
+#endif // RTC_ENABLE_MEDIA
+
+#endif // RTC_TRANSPORT_CC_REPORTER_H
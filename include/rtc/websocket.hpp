@@ -15,6 +15,7 @@
 #include "common.hpp"
 #include "configuration.hpp"
 
+#include <functional>
 #include <map>
 
 namespace rtc {
@@ -55,12 +56,19 @@ public:
 	bool send(const message_variant data) override;
 	bool send(const byte *data, size_t size) override;
 
+	// Stream a binary message as fragments, without a size limit. The producer is called on the
+	// thread pool for the next chunk whenever the send buffer runs low, and returns nullopt at the
+	// end of the message. Sending other messages meanwhile is not possible.
+	void sendStream(std::function<optional<binary>()> producer);
+
 	optional<string> remoteAddress() const;
 	optional<string> path() const;
 	std::multimap<string, string, case_insensitive_less> requestHeaders() const;
 
 private:
 	using CheshireCat<impl::WebSocket>::impl;
+
+	friend class WebSocketServer; // for broadcast
 };
 
 std::ostream &operator<<(std::ostream &out, WebSocket::State state);
@@ -15,6 +15,8 @@
 #include "configuration.hpp"
 #include "websocket.hpp"
 
+#include <vector>
+
 namespace rtc {
 
 namespace impl {
@@ -35,8 +37,15 @@ public:
 
 	uint16_t port() const;
 
+	// The callback may be called from any accept thread, but never concurrently
 	void onClient(std::function<void(shared_ptr<WebSocket>)> callback);
 
+	// Send the same message to several clients, the frame is encoded once and shared by all
+	// connections. Returns the number of clients the message was sent or buffered to, clients
+	// dropping it under their send buffer policy are not counted. Clients are served in order, so
+	// with the Block policy, one slow client blocks the broadcast to the following ones.
+	size_t broadcast(message_variant data, const std::vector<shared_ptr<WebSocket>> &clients);
+
 private:
 	using CheshireCat<impl::WebSocketServer>::impl;
 };
@@ -0,0 +1,451 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "bandwidthestimator.hpp"
+#include "rtp.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rtc {
+
+namespace {
+
+using std::chrono::duration;
+using std::chrono::milliseconds;
+
+// Packets sent within this interval form a group
+const auto BurstInterval = milliseconds(5);
+
+// Trendline filter
+const double DelaySmoothing = 0.9;
+const size_t TrendlineWindowSize = 20;
+const double ThresholdGain = 4.;
+
+// Overuse detector with adaptive threshold
+const double InitialThreshold = 12.5; // ms
+const double MinThreshold = 6.;
+const double MaxThreshold = 600.;
+const double ThresholdUp = 0.0087;
+const double ThresholdDown = 0.039;
+const double MaxAdaptOffset = 15.;
+const double OverusingTimeThreshold = 10.; // ms
+
+// Rate control
+const double DecreaseFactor = 0.85;
+const double IncreaseFactor = 1.08; // per second
+const auto MinDecreaseInterval = milliseconds(200);
+const auto AckedWindow = milliseconds(500);
+const auto MinAckedWindow = milliseconds(100);
+
+// Loss-based control
+const double LowLoss = 0.02;
+const double HighLoss = 0.10;
+const auto RrLossIgnoreInterval = milliseconds(1000); // when transport-cc feedback is available
+
+// A REMB bitrate no longer caps the target if not refreshed within this interval
+const auto RembTimeout = milliseconds(5000);
+
+// The target is reported only if it changed by more than this ratio
+const double ReportThreshold = 0.01;
+
+double toMs(BandwidthEstimator::clock::duration d) {
+	return duration<double, std::milli>(d).count();
+}
+
+double toMs(std::chrono::microseconds d) { return duration<double, std::milli>(d).count(); }
+
+double toSeconds(BandwidthEstimator::clock::duration d) { return duration<double>(d).count(); }
+
+} // namespace
+
+BandwidthEstimator::BandwidthEstimator(unsigned int startBitrate, unsigned int minBitrate,
+                                       unsigned int maxBitrate)
+    : mMinBitrate(minBitrate), mMaxBitrate(maxBitrate), mThreshold(InitialThreshold) {
+	if (minBitrate == 0 || minBitrate > maxBitrate)
+		throw std::invalid_argument("Invalid bandwidth estimator bitrate bounds");
+
+	double start = std::clamp(double(startBitrate), mMinBitrate, mMaxBitrate);
+	mDelayBasedBitrate = start;
+	mLossBasedBitrate = start;
+	mTargetBitrate = start;
+	mReportedBitrate = unsigned(start);
+}
+
+void BandwidthEstimator::setPacingHandler(shared_ptr<PacingHandler> pacer, double pacingFactor) {
+	unsigned int bitrate;
+	{
+		std::lock_guard lock(mMutex);
+		mPacer = pacer;
+		mPacingFactor = pacingFactor;
+		bitrate = mReportedBitrate;
+	}
+
+	if (pacer)
+		pacer->setBitrate(bitrate * pacingFactor);
+}
+
+void BandwidthEstimator::setTransportCcSession(shared_ptr<TransportCcSession> session) {
+	if (!session)
+		throw std::invalid_argument("Transport-cc session is null");
+
+	session->onFeedback([weak_this = weak_from_this()](std::vector<TransportCcPacketResult> results) {
+		if (auto shared_this = weak_this.lock())
+			static_cast<BandwidthEstimator *>(shared_this.get())->processTransportCcFeedback(results);
+	});
+}
+
+void BandwidthEstimator::onTargetBitrate(std::function<void(unsigned int bitrate)> callback) {
+	mTargetBitrateCallback = std::move(callback);
+}
+
+unsigned int BandwidthEstimator::targetBitrate() const {
+	std::lock_guard lock(mMutex);
+	return unsigned(mTargetBitrate);
+}
+
+void BandwidthEstimator::processTransportCcFeedback(
+    const std::vector<TransportCcPacketResult> &results, clock::time_point now) {
+	if (results.empty())
+		return;
+
+	optional<unsigned int> changed;
+	{
+		std::lock_guard lock(mMutex);
+		mLastTransportCcFeedback = now;
+
+		size_t lost = 0;
+		for (const auto &result : results) {
+			if (!result.arrivalTime) {
+				++lost;
+				continue;
+			}
+
+			auto arrivalTime = *result.arrivalTime;
+			mAcked.emplace_back(arrivalTime, result.size);
+			mAckedBytes += result.size;
+
+			if (!mCurrentGroup) {
+				mCurrentGroup.emplace(PacketGroup{result.sendTime, result.sendTime, arrivalTime});
+				continue;
+			}
+
+			if (result.sendTime < mCurrentGroup->firstSendTime)
+				continue; // reordered
+
+			if (result.sendTime - mCurrentGroup->firstSendTime <= BurstInterval) {
+				mCurrentGroup->lastSendTime = std::max(mCurrentGroup->lastSendTime, result.sendTime);
+				mCurrentGroup->lastArrivalTime = std::max(mCurrentGroup->lastArrivalTime, arrivalTime);
+			} else {
+				processPacketGroup(*mCurrentGroup, now);
+				mCurrentGroup.emplace(PacketGroup{result.sendTime, result.sendTime, arrivalTime});
+			}
+		}
+
+		while (!mAcked.empty() && mAcked.back().first - mAcked.front().first > AckedWindow) {
+			mAckedBytes -= mAcked.front().second;
+			mAcked.pop_front();
+		}
+
+		updateDelayBasedBitrate(now);
+		updateLossBasedBitrate(double(lost) / double(results.size()), now);
+		changed = updateTarget(now);
+	}
+
+	if (changed)
+		notifyTarget(*changed);
+}
+
+void BandwidthEstimator::processRemb(unsigned int bitrate, clock::time_point now) {
+	optional<unsigned int> changed;
+	{
+		std::lock_guard lock(mMutex);
+		mRembBitrate = double(bitrate);
+		mLastRemb = now;
+		changed = updateTarget(now);
+	}
+
+	if (changed)
+		notifyTarget(*changed);
+}
+
+void BandwidthEstimator::processLossReport(uint8_t fractionLost, clock::time_point now) {
+	optional<unsigned int> changed;
+	{
+		std::lock_guard lock(mMutex);
+		// Transport-cc feedback is more accurate and more frequent than report blocks
+		if (mLastTransportCcFeedback && now - *mLastTransportCcFeedback < RrLossIgnoreInterval)
+			return;
+
+		updateLossBasedBitrate(fractionLost / 256., now);
+		changed = updateTarget(now);
+	}
+
+	if (changed)
+		notifyTarget(*changed);
+}
+
+void BandwidthEstimator::media(const Description::Media &desc) {
+	std::lock_guard lock(mMutex);
+	mSsrcs = desc.getSSRCs();
+}
+
+void BandwidthEstimator::incoming(message_vector &messages,
+                                  [[maybe_unused]] const message_callback &send) {
+	optional<unsigned int> remb;
+	optional<uint8_t> fractionLost;
+	std::vector<SSRC> ssrcs;
+	{
+		std::lock_guard lock(mMutex);
+		ssrcs = mSsrcs;
+	}
+
+	auto readReportBlocks = [&](const RtcpReportBlock *blocks, int count) {
+		for (int i = 0; i < count; ++i) {
+			const auto &block = blocks[i];
+			if (!ssrcs.empty() &&
+			    std::find(ssrcs.begin(), ssrcs.end(), block.getSSRC()) == ssrcs.end())
+				continue;
+
+			fractionLost = std::max(fractionLost.value_or(0), block.getFractionLost());
+		}
+	};
+
+	for (const auto &message : messages) {
+		if (message->type != Message::Control)
+			continue;
+
+		size_t offset = 0;
+		while (offset + sizeof(RtcpHeader) <= message->size()) {
+			auto header = reinterpret_cast<const RtcpHeader *>(message->data() + offset);
+			size_t length = header->lengthInBytes();
+			if (offset + length > message->size())
+				break;
+
+			auto payloadType = header->payloadType();
+			int count = header->reportCount();
+			if (payloadType == 200 && length >= RtcpSr::Size(count)) {
+				auto sr = reinterpret_cast<const RtcpSr *>(header);
+				readReportBlocks(sr->getReportBlock(0), count);
+
+			} else if (payloadType == 201 && length >= RtcpRr::SizeWithReportBlocks(uint8_t(count))) {
+				auto rr = reinterpret_cast<const RtcpRr *>(header);
+				readReportBlocks(rr->getReportBlock(0), count);
+
+			} else if (payloadType == 206 && count == 15 && length >= sizeof(RtcpRemb)) {
+				auto rtcpRemb = reinterpret_cast<const RtcpRemb *>(header);
+				if (rtcpRemb->hasValidId())
+					remb = rtcpRemb->getBitrate();
+			}
+
+			offset += length;
+		}
+	}
+
+	auto now = clock::now();
+	if (remb)
+		processRemb(*remb, now);
+
+	if (fractionLost)
+		processLossReport(*fractionLost, now);
+}
+
+void BandwidthEstimator::processPacketGroup(const PacketGroup &group, clock::time_point now) {
+	if (mPreviousGroup) {
+		double sendDeltaMs = toMs(group.lastSendTime - mPreviousGroup->lastSendTime);
+		double arrivalDeltaMs = toMs(group.lastArrivalTime - mPreviousGroup->lastArrivalTime);
+		if (sendDeltaMs > 0)
+			updateTrendline(arrivalDeltaMs - sendDeltaMs, toMs(group.lastArrivalTime), sendDeltaMs,
+			                now);
+	}
+
+	mPreviousGroup = group;
+}
+
+void BandwidthEstimator::updateTrendline(double delayDeltaMs, double arrivalTimeMs,
+                                         double sendDeltaMs, clock::time_point now) {
+	mDeltaCount = std::min(mDeltaCount + 1, 1000u);
+	mAccumulatedDelay += delayDeltaMs;
+	mSmoothedDelay = DelaySmoothing * mSmoothedDelay + (1. - DelaySmoothing) * mAccumulatedDelay;
+
+	if (!mFirstArrivalTimeMs)
+		mFirstArrivalTimeMs = arrivalTimeMs;
+
+	mDelayHistory.emplace_back(arrivalTimeMs - *mFirstArrivalTimeMs, mSmoothedDelay);
+	if (mDelayHistory.size() > TrendlineWindowSize)
+		mDelayHistory.pop_front();
+
+	// Linear regression of the smoothed delay over arrival time
+	double trend = mPreviousTrend;
+	if (mDelayHistory.size() == TrendlineWindowSize) {
+		double meanX = 0., meanY = 0.;
+		for (const auto &[x, y] : mDelayHistory) {
+			meanX += x;
+			meanY += y;
+		}
+		meanX /= double(mDelayHistory.size());
+		meanY /= double(mDelayHistory.size());
+
+		double numerator = 0., denominator = 0.;
+		for (const auto &[x, y] : mDelayHistory) {
+			numerator += (x - meanX) * (y - meanY);
+			denominator += (x - meanX) * (x - meanX);
+		}
+
+		if (denominator != 0.)
+			trend = numerator / denominator;
+	}
+
+	double modifiedTrend = std::min(mDeltaCount, 60u) * trend * ThresholdGain;
+	if (modifiedTrend > mThreshold) {
+		if (mTimeOverusing < 0.)
+			mTimeOverusing = sendDeltaMs / 2.;
+		else
+			mTimeOverusing += sendDeltaMs;
+
+		++mOveruseCount;
+		if (mTimeOverusing > OverusingTimeThreshold && mOveruseCount > 1 &&
+		    trend >= mPreviousTrend) {
+			mTimeOverusing = 0.;
+			mOveruseCount = 0;
+			mUsage = Usage::Overusing;
+		}
+	} else {
+		mTimeOverusing = -1.;
+		mOveruseCount = 0;
+		mUsage = modifiedTrend < -mThreshold ? Usage::Underusing : Usage::Normal;
+	}
+
+	mPreviousTrend = trend;
+	updateThreshold(modifiedTrend, now);
+}
+
+void BandwidthEstimator::updateThreshold(double modifiedTrend, clock::time_point now) {
+	if (!mLastThresholdUpdate)
+		mLastThresholdUpdate = now;
+
+	double absTrend = std::fabs(modifiedTrend);
+	if (absTrend <= mThreshold + MaxAdaptOffset) {
+		double k = absTrend < mThreshold ? ThresholdDown : ThresholdUp;
+		double dt = std::min(toMs(now - *mLastThresholdUpdate), 100.);
+		mThreshold = std::clamp(mThreshold + k * (absTrend - mThreshold) * dt, MinThreshold,
+		                        MaxThreshold);
+	}
+
+	mLastThresholdUpdate = now;
+}
+
+void BandwidthEstimator::updateDelayBasedBitrate(clock::time_point now) {
+	double dt = mLastRateUpdate ? std::min(toSeconds(now - *mLastRateUpdate), 1.) : 0.;
+	mLastRateUpdate = now;
+
+	auto acked = ackedBitrate();
+	switch (mUsage) {
+	case Usage::Overusing:
+		if (!mLastDelayDecrease || now - *mLastDelayDecrease >= MinDecreaseInterval) {
+			mDelayBasedBitrate =
+			    std::min(mDelayBasedBitrate, DecreaseFactor * acked.value_or(mDelayBasedBitrate));
+			mLastDelayDecrease = now;
+		}
+		mRateState = RateState::Hold;
+		break;
+
+	case Usage::Underusing:
+		// Let the queues drain
+		mRateState = RateState::Hold;
+		break;
+
+	case Usage::Normal:
+		if (mRateState == RateState::Hold) {
+			mRateState = RateState::Increase;
+		} else {
+			double increased = mDelayBasedBitrate * std::pow(IncreaseFactor, dt);
+			// Do not increase far beyond what is actually getting through
+			if (acked)
+				increased = std::min(increased, std::max(mDelayBasedBitrate, 1.5 * *acked + 10000.));
+
+			mDelayBasedBitrate = increased;
+		}
+		break;
+	}
+
+	mDelayBasedBitrate = std::clamp(mDelayBasedBitrate, mMinBitrate, mMaxBitrate);
+}
+
+void BandwidthEstimator::updateLossBasedBitrate(double lossFraction, clock::time_point now) {
+	double dt = mLastLossUpdate ? std::min(toSeconds(now - *mLastLossUpdate), 1.) : 0.;
+	mLastLossUpdate = now;
+
+	if (lossFraction > HighLoss) {
+		if (!mLastLossDecrease || now - *mLastLossDecrease >= MinDecreaseInterval) {
+			mLossBasedBitrate = std::min(mLossBasedBitrate, mTargetBitrate) * (1. - 0.5 * lossFraction);
+			mLastLossDecrease = now;
+		}
+	} else if (lossFraction < LowLoss) {
+		mLossBasedBitrate *= std::pow(IncreaseFactor, dt);
+	}
+
+	mLossBasedBitrate = std::clamp(mLossBasedBitrate, mMinBitrate, mMaxBitrate);
+}
+
+optional<double> BandwidthEstimator::ackedBitrate() const {
+	if (mAcked.size() < 2)
+		return nullopt;
+
+	auto window = mAcked.back().first - mAcked.front().first;
+	if (window < MinAckedWindow)
+		return nullopt;
+
+	// The first packet marks the start of the window
+	double bytes = double(mAckedBytes - mAcked.front().second);
+	return bytes * 8. / duration<double>(window).count();
+}
+
+optional<unsigned int> BandwidthEstimator::updateTarget(clock::time_point now) {
+	// The receiver may stop sending REMB, for instance when it switches to transport-cc
+	if (mRembBitrate && now - mLastRemb > RembTimeout)
+		mRembBitrate.reset();
+
+	double target = std::min(mDelayBasedBitrate, mLossBasedBitrate);
+	if (mRembBitrate)
+		target = std::min(target, *mRembBitrate);
+
+	mTargetBitrate = std::clamp(target, mMinBitrate, mMaxBitrate);
+
+	if (std::fabs(mTargetBitrate - mReportedBitrate) < ReportThreshold * mReportedBitrate)
+		return nullopt;
+
+	mReportedBitrate = unsigned(mTargetBitrate);
+	return mReportedBitrate;
+}
+
+void BandwidthEstimator::notifyTarget(unsigned int bitrate) {
+	shared_ptr<PacingHandler> pacer;
+	double pacingFactor;
+	{
+		std::lock_guard lock(mMutex);
+		pacer = mPacer.lock();
+		pacingFactor = mPacingFactor;
+	}
+
+	PLOG_VERBOSE << "Bandwidth estimator target bitrate: " << bitrate;
+
+	if (pacer)
+		pacer->setBitrate(bitrate * pacingFactor);
+
+	mTargetBitrateCallback(bitrate);
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -757,6 +757,32 @@ int rtcGetRemoteMaxMessageSize(int pc) {
 	});
 }
 
+int rtcGetTransportStats(int pc, rtcTransportStats *stats) {
+	return wrap([&] {
+		if (!stats)
+			throw std::invalid_argument("Unexpected null pointer for stats");
+
+		auto peerConnection = getPeerConnection(pc);
+		auto transport = peerConnection->stats().transport;
+		std::memset(stats, 0, sizeof(*stats));
+		stats->packetsSent = transport.packetsSent;
+		stats->bytesSent = transport.bytesSent;
+		stats->packetsReceived = transport.packetsReceived;
+		stats->bytesReceived = transport.bytesReceived;
+		stats->sctpRtt = transport.sctpRtt ? int(transport.sctpRtt->count()) : -1;
+		stats->sctpRto = transport.sctpRto ? int(transport.sctpRto->count()) : -1;
+		stats->sctpCongestionWindow =
+		    transport.sctpCongestionWindow ? int(*transport.sctpCongestionWindow) : -1;
+		stats->sctpUnackedChunks =
+		    transport.sctpUnackedChunks ? int(*transport.sctpUnackedChunks) : -1;
+		stats->srtpPacketsTruncated = transport.srtpPacketsTruncated;
+		stats->srtpReplays = transport.srtpReplays;
+		stats->srtpAuthFailures = transport.srtpAuthFailures;
+		stats->srtpOtherFailures = transport.srtpOtherFailures;
+		return RTC_ERR_SUCCESS;
+	});
+}
+
 int rtcSetOpenCallback(int id, rtcOpenCallbackFunc cb) {
 	return wrap([&] {
 		auto channel = getChannel(id);
@@ -1055,6 +1081,23 @@ int rtcGetDataChannelReliability(int dc, rtcReliability *reliability) {
 	});
 }
 
+int rtcGetDataChannelStats(int dc, rtcDataChannelStats *stats) {
+	return wrap([&] {
+		if (!stats)
+			throw std::invalid_argument("Unexpected null pointer for stats");
+
+		auto dataChannel = getDataChannel(dc);
+		auto channelStats = dataChannel->stats();
+		std::memset(stats, 0, sizeof(*stats));
+		stats->messagesSent = channelStats.messagesSent;
+		stats->bytesSent = channelStats.bytesSent;
+		stats->messagesReceived = channelStats.messagesReceived;
+		stats->bytesReceived = channelStats.bytesReceived;
+		stats->bufferedAmount = channelStats.bufferedAmount;
+		return RTC_ERR_SUCCESS;
+	});
+}
+
 int rtcAddTrack(int pc, const char *mediaDescriptionSdp) {
 	return wrap([&] {
 		if (!mediaDescriptionSdp)
@@ -1219,6 +1262,35 @@ int rtcGetTrackDirection(int tr, rtcDirection *direction) {
 	});
 }
 
+int rtcGetTrackStats(int tr, rtcTrackStats *stats) {
+	return wrap([&] {
+		if (!stats)
+			throw std::invalid_argument("Unexpected null pointer for stats");
+
+		auto track = getTrack(tr);
+		auto trackStats = track->stats();
+		std::memset(stats, 0, sizeof(*stats));
+		stats->packetsSent = trackStats.packetsSent;
+		stats->bytesSent = trackStats.bytesSent;
+		stats->nackCount = trackStats.nackCount;
+		stats->pliCount = trackStats.pliCount;
+		stats->firCount = trackStats.firCount;
+		stats->hasRemoteReport = trackStats.remotePacketsLost.has_value();
+		stats->remotePacketsLost = trackStats.remotePacketsLost.value_or(0);
+		stats->remoteJitter = trackStats.remoteJitter.value_or(-1.0);
+		stats->packetsReceived = trackStats.packetsReceived;
+		stats->bytesReceived = trackStats.bytesReceived;
+		stats->nackSent = trackStats.nackSent;
+		stats->pliSent = trackStats.pliSent;
+		stats->firSent = trackStats.firSent;
+		stats->packetsDiscarded = trackStats.packetsDiscarded;
+		stats->hasReceptionStats = trackStats.packetsLost.has_value();
+		stats->packetsLost = trackStats.packetsLost.value_or(0);
+		stats->jitter = trackStats.jitter.value_or(-1.0);
+		return RTC_ERR_SUCCESS;
+	});
+}
+
 int rtcRequestKeyframe(int tr) {
 	return wrap([&] {
 		auto track = getTrack(tr);
@@ -1827,6 +1899,13 @@ int rtcCreateWebSocketEx(const char *url, const rtcWsConfiguration *config) {
 		if (config->maxMessageSize > 0)
 			c.maxMessageSize = size_t(config->maxMessageSize);
 
+		c.enableKernelTls = config->enableKernelTls;
+
+		if (config->maxBufferedAmount > 0)
+			c.maxBufferedAmount = size_t(config->maxBufferedAmount);
+
+		c.sendBufferPolicy = static_cast<SendBufferPolicy>(config->sendBufferPolicy);
+
 		auto webSocket = std::make_shared<WebSocket>(std::move(c));
 		webSocket->open(url);
 		return emplaceWebSocket(webSocket);
@@ -1885,6 +1964,16 @@ int rtcCreateWebSocketServer(const rtcWsServerConfiguration *config,
 		if (config->maxMessageSize > 0)
 			c.maxMessageSize = size_t(config->maxMessageSize);
 
+		if (config->acceptThreads > 0)
+			c.acceptThreads = static_cast<unsigned int>(config->acceptThreads);
+
+		c.enableKernelTls = config->enableKernelTls;
+
+		if (config->maxBufferedAmount > 0)
+			c.maxBufferedAmount = size_t(config->maxBufferedAmount);
+
+		c.sendBufferPolicy = static_cast<SendBufferPolicy>(config->sendBufferPolicy);
+
 		auto webSocketServer = std::make_shared<WebSocketServer>(std::move(c));
 		int wsserver = emplaceWebSocketServer(webSocketServer);
 
@@ -1975,6 +2064,17 @@ int rtcSetSctpSettings(const rtcSctpSettings *settings) {
 	});
 }
 
+int rtcSetExternalEventLoop(bool enabled) {
+	return wrap([&] {
+		SetExternalEventLoop(enabled);
+		return RTC_ERR_SUCCESS;
+	});
+}
+
+int rtcPoll(int timeout) {
+	return wrap([&] { return Poll(milliseconds(timeout)); });
+}
+
 bool rtcPreload() {
 	try {
 		return rtc::Preload();
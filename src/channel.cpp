@@ -7,13 +7,17 @@
  */
 
 #include "channel.hpp"
+#include "coroutine.hpp"
 
 #include "impl/channel.hpp"
 #include "impl/internals.hpp"
 
 namespace rtc {
 
-Channel::~Channel() { impl()->resetCallbacks(); }
+Channel::~Channel() {
+	impl()->resetCallbacks();
+	impl::CoroutineWaiters::Release(this);
+}
 
 Channel::Channel(impl_ptr<impl::Channel> impl) : CheshireCat<impl::Channel>(std::move(impl)) {}
 
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "coroutine.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace rtc {
+
+namespace {
+
+std::mutex executorMutex;
+CoroutineExecutor executorInstance;
+
+// Waiters by object, they are owned by the callbacks registered on the object
+std::mutex waitersMutex;
+std::unordered_map<const void *, std::weak_ptr<impl::CoroutineWaiters>> waitersMap;
+
+} // namespace
+
+void SetCoroutineExecutor(CoroutineExecutor executor) {
+	std::lock_guard lock(executorMutex);
+	executorInstance = std::move(executor);
+}
+
+namespace impl {
+
+void ExecuteCoroutine(std::function<void()> resume) {
+	CoroutineExecutor executor;
+	{
+		std::lock_guard lock(executorMutex);
+		executor = executorInstance;
+	}
+	if (executor)
+		executor(std::move(resume));
+	else
+		EnqueueTask(std::move(resume));
+}
+
+shared_ptr<CoroutineWaiters> CoroutineWaiters::Get(const void *object, const init_callback &init) {
+	std::lock_guard lock(waitersMutex);
+	if (auto it = waitersMap.find(object); it != waitersMap.end())
+		if (auto waiters = it->second.lock())
+			return waiters;
+
+	// Purge waiters of objects whose callbacks were reset
+	for (auto it = waitersMap.begin(); it != waitersMap.end();)
+		it = it->second.expired() ? waitersMap.erase(it) : std::next(it);
+
+	auto waiters = std::make_shared<CoroutineWaiters>();
+	init(waiters);
+	waitersMap[object] = waiters;
+	return waiters;
+}
+
+void CoroutineWaiters::Release(const void *object) {
+	std::lock_guard lock(waitersMutex);
+	waitersMap.erase(object);
+}
+
+int CoroutineWaiters::add(std::function<void()> notify) {
+	std::lock_guard lock(mMutex);
+	int id = mNextId++;
+	mWaiters.emplace_back(id, std::move(notify));
+	return id;
+}
+
+void CoroutineWaiters::remove(int id) {
+	std::lock_guard lock(mMutex);
+	auto it = std::find_if(mWaiters.begin(), mWaiters.end(),
+	                       [id](const auto &waiter) { return waiter.first == id; });
+	if (it != mWaiters.end())
+		mWaiters.erase(it);
+}
+
+void CoroutineWaiters::notifyAll() {
+	decltype(mWaiters) waiters;
+	{
+		std::lock_guard lock(mMutex);
+		std::swap(waiters, mWaiters);
+	}
+	for (auto &waiter : waiters)
+		waiter.second();
+}
+
+} // namespace impl
+
+} // namespace rtc
@@ -40,6 +40,8 @@ string DataChannel::protocol() const { return impl()->protocol(); }
 
 Reliability DataChannel::reliability() const { return impl()->reliability(); }
 
+DataChannelStats DataChannel::stats() const { return impl()->stats(); }
+
 bool DataChannel::isOpen() const { return impl()->isOpen(); }
 
 bool DataChannel::isClosed() const { return impl()->isClosed(); }
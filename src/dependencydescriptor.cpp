@@ -12,6 +12,7 @@
 #include <cassert>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <stdexcept>
 
 namespace rtc {
@@ -126,6 +127,66 @@ size_t BitWriter::writePartialByte(uint8_t *p, size_t offset, uint64_t v, size_t
 	return need_write_bits;
 }
 
+BitReader BitReader::fromSizeBits(const byte *buf, size_t offsetBits, size_t sizeBits) {
+	BitReader reader;
+	reader.mBuf = buf;
+	reader.mInitialOffset = offsetBits;
+	reader.mOffset = offsetBits;
+	reader.mSize = sizeBits;
+	return reader;
+}
+
+size_t BitReader::getReadBits() const { return mOffset - mInitialOffset; }
+
+size_t BitReader::getRemainingBits() const { return mSize - mOffset; }
+
+bool BitReader::read(size_t bits, uint64_t *v) {
+	if (bits > 64 || mOffset + bits > mSize) {
+		return false;
+	}
+	uint64_t result = 0;
+	while (bits > 0) {
+		auto p = std::to_integer<uint8_t>(mBuf[mOffset / 8]);
+		size_t offset = mOffset % 8;
+		// Read up to the 8-bit boundary
+		size_t count = std::min(8 - offset, bits);
+		uint8_t chunk = uint8_t(p >> (8 - offset - count)) & uint8_t((1 << count) - 1);
+		result = (result << count) | chunk;
+		bits -= count;
+		mOffset += count;
+	}
+	*v = result;
+	return true;
+}
+
+bool BitReader::readNonSymmetric(uint64_t n, uint64_t *v) {
+	if (n <= 1) {
+		*v = 0;
+		return true;
+	}
+	size_t w = 0;
+	uint64_t x = n;
+	while (x != 0) {
+		x = x >> 1;
+		w++;
+	}
+	uint64_t m = (1ULL << w) - n;
+	uint64_t value;
+	if (!read(w - 1, &value)) {
+		return false;
+	}
+	if (value < m) {
+		*v = value;
+		return true;
+	}
+	uint64_t extraBit;
+	if (!read(1, &extraBit)) {
+		return false;
+	}
+	*v = (value << 1) - m + extraBit;
+	return true;
+}
+
 using TemplateIterator = std::vector<FrameDependencyTemplate>::const_iterator;
 
 struct TemplateMatch {
@@ -406,4 +467,226 @@ void DependencyDescriptorWriter::writeNonSymmetric(BitWriter &writer, uint64_t v
 	}
 }
 
+optional<DependencyDescriptor> DependencyDescriptorReader::read(const byte *buf,
+                                                                size_t sizeBytes) {
+	auto r = BitReader::fromSizeBits(buf, 0, sizeBytes * 8);
+	uint64_t startOfFrame, endOfFrame, templateId, frameNumber;
+	// mandatory_descriptor_fields()
+	if (!r.read(1, &startOfFrame) || !r.read(1, &endOfFrame) || !r.read(6, &templateId) ||
+	    !r.read(16, &frameNumber)) {
+		return std::nullopt;
+	}
+
+	DependencyDescriptor descriptor;
+	descriptor.startOfFrame = startOfFrame != 0;
+	descriptor.endOfFrame = endOfFrame != 0;
+	descriptor.frameNumber = int(frameNumber);
+	descriptor.structureAttached = false;
+
+	uint64_t activeDecodeTargetsPresent = 0;
+	uint64_t customDtis = 0, customFdiffs = 0, customChains = 0;
+	if (sizeBytes > 3) {
+		// extended_descriptor_fields()
+		uint64_t structurePresent;
+		if (!r.read(1, &structurePresent) || !r.read(1, &activeDecodeTargetsPresent) ||
+		    !r.read(1, &customDtis) || !r.read(1, &customFdiffs) || !r.read(1, &customChains)) {
+			return std::nullopt;
+		}
+		if (structurePresent) {
+			auto structure = std::make_shared<FrameDependencyStructure>();
+			if (!readStructure(r, *structure)) {
+				return std::nullopt;
+			}
+			mStructure = std::move(structure);
+			mActiveDecodeTargetsBitmask = uint32_t((1ULL << mStructure->decodeTargetCount) - 1);
+			descriptor.structureAttached = true;
+		}
+	}
+
+	if (!mStructure) {
+		return std::nullopt;
+	}
+
+	const auto &structure = *mStructure;
+	if (activeDecodeTargetsPresent) {
+		uint64_t bitmask;
+		if (!r.read(structure.decodeTargetCount, &bitmask)) {
+			return std::nullopt;
+		}
+		mActiveDecodeTargetsBitmask = uint32_t(bitmask);
+	}
+	descriptor.activeDecodeTargetsBitmask = mActiveDecodeTargetsBitmask;
+
+	// frame_dependency_definition()
+	size_t templateIndex =
+	    (templateId + MaxTemplates - uint64_t(structure.templateIdOffset)) % MaxTemplates;
+	if (templateIndex >= structure.templates.size()) {
+		return std::nullopt;
+	}
+	descriptor.dependencyTemplate = structure.templates[templateIndex];
+	auto &frameTemplate = descriptor.dependencyTemplate;
+	if (size_t(frameTemplate.spatialId) < structure.resolutions.size()) {
+		descriptor.resolution = structure.resolutions[frameTemplate.spatialId];
+	}
+
+	if (customDtis) {
+		// frame_dtis()
+		for (auto &dti : frameTemplate.decodeTargetIndications) {
+			uint64_t value;
+			if (!r.read(2, &value)) {
+				return std::nullopt;
+			}
+			dti = static_cast<DecodeTargetIndication>(value);
+		}
+	}
+	if (customFdiffs) {
+		// frame_fdiffs()
+		frameTemplate.frameDiffs.clear();
+		uint64_t fdiffSize;
+		if (!r.read(2, &fdiffSize)) {
+			return std::nullopt;
+		}
+		while (fdiffSize != 0) {
+			uint64_t fdiffMinusOne;
+			if (!r.read(4 * fdiffSize, &fdiffMinusOne) || !r.read(2, &fdiffSize)) {
+				return std::nullopt;
+			}
+			frameTemplate.frameDiffs.push_back(int(fdiffMinusOne + 1));
+		}
+	}
+	if (customChains) {
+		// frame_chains()
+		for (auto &chainDiff : frameTemplate.chainDiffs) {
+			uint64_t value;
+			if (!r.read(8, &value)) {
+				return std::nullopt;
+			}
+			chainDiff = int(value);
+		}
+	}
+
+	return descriptor;
+}
+
+shared_ptr<const FrameDependencyStructure> DependencyDescriptorReader::structure() const {
+	return mStructure;
+}
+
+std::vector<std::pair<int, int>>
+DependencyDescriptorReader::DecodeTargetLayers(const FrameDependencyStructure &structure) {
+	// decode_target_layers()
+	std::vector<std::pair<int, int>> result(structure.decodeTargetCount, std::make_pair(0, 0));
+	for (int i = 0; i < structure.decodeTargetCount; ++i) {
+		for (const auto &frameTemplate : structure.templates) {
+			if (size_t(i) < frameTemplate.decodeTargetIndications.size() &&
+			    frameTemplate.decodeTargetIndications[i] != DecodeTargetIndication::NotPresent) {
+				result[i].first = std::max(result[i].first, frameTemplate.spatialId);
+				result[i].second = std::max(result[i].second, frameTemplate.temporalId);
+			}
+		}
+	}
+	return result;
+}
+
+bool DependencyDescriptorReader::readStructure(BitReader &r, FrameDependencyStructure &structure) {
+	// template_dependency_structure()
+	uint64_t templateIdOffset, decodeTargetCountMinusOne;
+	if (!r.read(6, &templateIdOffset) || !r.read(5, &decodeTargetCountMinusOne)) {
+		return false;
+	}
+	structure.templateIdOffset = int(templateIdOffset);
+	structure.decodeTargetCount = int(decodeTargetCountMinusOne + 1);
+
+	// template_layers()
+	int spatialId = 0;
+	int temporalId = 0;
+	uint64_t nextLayerIdc;
+	do {
+		if (structure.templates.size() >= MaxTemplates) {
+			return false;
+		}
+		FrameDependencyTemplate frameTemplate;
+		frameTemplate.spatialId = spatialId;
+		frameTemplate.temporalId = temporalId;
+		structure.templates.push_back(std::move(frameTemplate));
+		if (!r.read(2, &nextLayerIdc)) {
+			return false;
+		}
+		if (nextLayerIdc == 1) {
+			temporalId++;
+		} else if (nextLayerIdc == 2) {
+			temporalId = 0;
+			spatialId++;
+		}
+	} while (nextLayerIdc != 3);
+
+	// template_dtis()
+	for (auto &frameTemplate : structure.templates) {
+		frameTemplate.decodeTargetIndications.resize(structure.decodeTargetCount);
+		for (auto &dti : frameTemplate.decodeTargetIndications) {
+			uint64_t value;
+			if (!r.read(2, &value)) {
+				return false;
+			}
+			dti = static_cast<DecodeTargetIndication>(value);
+		}
+	}
+
+	// template_fdiffs()
+	for (auto &frameTemplate : structure.templates) {
+		uint64_t fdiffFollows;
+		if (!r.read(1, &fdiffFollows)) {
+			return false;
+		}
+		while (fdiffFollows) {
+			uint64_t fdiffMinusOne;
+			if (!r.read(4, &fdiffMinusOne) || !r.read(1, &fdiffFollows)) {
+				return false;
+			}
+			frameTemplate.frameDiffs.push_back(int(fdiffMinusOne + 1));
+		}
+	}
+
+	// template_chains()
+	uint64_t chainCount;
+	if (!r.readNonSymmetric(structure.decodeTargetCount + 1, &chainCount)) {
+		return false;
+	}
+	structure.chainCount = int(chainCount);
+	if (chainCount != 0) {
+		for (int i = 0; i < structure.decodeTargetCount; ++i) {
+			uint64_t protectedBy;
+			if (!r.readNonSymmetric(chainCount, &protectedBy)) {
+				return false;
+			}
+			structure.decodeTargetProtectedBy.push_back(int(protectedBy));
+		}
+		for (auto &frameTemplate : structure.templates) {
+			for (uint64_t i = 0; i < chainCount; ++i) {
+				uint64_t chainDiff;
+				if (!r.read(4, &chainDiff)) {
+					return false;
+				}
+				frameTemplate.chainDiffs.push_back(int(chainDiff));
+			}
+		}
+	}
+
+	uint64_t resolutionsPresent;
+	if (!r.read(1, &resolutionsPresent)) {
+		return false;
+	}
+	if (resolutionsPresent) {
+		// render_resolutions()
+		for (int i = 0; i <= spatialId; ++i) {
+			uint64_t widthMinusOne, heightMinusOne;
+			if (!r.read(16, &widthMinusOne) || !r.read(16, &heightMinusOne)) {
+				return false;
+			}
+			structure.resolutions.push_back({int(widthMinusOne + 1), int(heightMinusOne + 1)});
+		}
+	}
+	return true;
+}
+
 } // namespace rtc
@@ -17,6 +17,8 @@
 #include "global.hpp"
 
 #include "impl/init.hpp"
+#include "impl/pollservice.hpp"
+#include "impl/threadpool.hpp"
 
 #include <mutex>
 
@@ -84,8 +86,39 @@ void InitLogger(plog::Severity severity, plog::IAppender *appender) {
 }
 
 void SetThreadPoolSize(unsigned int count) { impl::Init::Instance().setThreadPoolSize(count); }
+
+void EnqueueTask(std::function<void()> task) {
+	// Keep the library initialized until the task has run
+	impl::ThreadPool::Instance().enqueue(
+	    [token = impl::Init::Instance().token(), task = std::move(task)]() { task(); });
+}
+
 void SetSctpSettings(SctpSettings s) { impl::Init::Instance().setSctpSettings(std::move(s)); }
 
+void SetExternalEventLoop(bool enabled) { impl::Init::Instance().setExternalEventLoop(enabled); }
+
+int Poll(std::chrono::milliseconds timeout) { return impl::Init::Instance().poll(timeout); }
+int ProcessEvents() { return impl::Init::Instance().poll(std::chrono::milliseconds::zero()); }
+
+std::vector<PollDescriptor> GetPollDescriptors() {
+	std::vector<PollDescriptor> result;
+#if RTC_ENABLE_WEBSOCKET
+	// The first descriptor is the interrupter, so tasks scheduled from other threads wake the loop
+	std::vector<struct pollfd> pfds;
+	optional<impl::PollService::clock::time_point> next;
+	impl::PollService::Instance().descriptors(pfds, next);
+	result.reserve(pfds.size());
+	for (const auto &pfd : pfds)
+		result.push_back({static_cast<intptr_t>(pfd.fd), (pfd.events & POLLIN) != 0,
+		                  (pfd.events & POLLOUT) != 0});
+#endif
+	return result;
+}
+
+optional<std::chrono::milliseconds> GetPollTimeout() {
+	return impl::Init::Instance().pollTimeout();
+}
+
 bool Preload() { return impl::Init::Instance().preload(); }
 std::shared_future<void> Cleanup() { return impl::Init::Instance().cleanup(); }
 
@@ -623,7 +623,20 @@ string make_fingerprint(X509 *x509, CertificateFingerprint::Algorithm fingerprin
 // Common for GnuTLS, Mbed TLS, and OpenSSL
 
 future_certificate_ptr make_certificate(CertificateType type) {
-	return ThreadPool::Instance().enqueue([type, token = Init::Instance().token()]() {
+	// With an external event loop, tasks are run by the application which might wait for the result
+	auto token = Init::Instance().token();
+	if (Init::Instance().isExternalEventLoop()) {
+		std::promise<certificate_ptr> promise;
+		try {
+			promise.set_value(
+			    std::make_shared<Certificate>(Certificate::Generate(type, "libdatachannel")));
+		} catch (...) {
+			promise.set_exception(std::current_exception());
+		}
+		return promise.get_future();
+	}
+
+	return ThreadPool::Instance().enqueue([type, token = std::move(token)]() {
 		return std::make_shared<Certificate>(Certificate::Generate(type, "libdatachannel"));
 	});
 }
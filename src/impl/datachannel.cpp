@@ -146,6 +146,21 @@ Reliability DataChannel::reliability() const {
 	return *mReliability;
 }
 
+DataChannelStats DataChannel::stats() const {
+	DataChannelStats stats;
+	{
+		std::shared_lock lock(mMutex);
+		stats.label = mLabel;
+		stats.stream = mStream;
+	}
+	stats.messagesSent = mMessagesSent.load(std::memory_order_relaxed);
+	stats.bytesSent = mBytesSent.load(std::memory_order_relaxed);
+	stats.messagesReceived = mMessagesReceived.load(std::memory_order_relaxed);
+	stats.bytesReceived = mBytesReceived.load(std::memory_order_relaxed);
+	stats.bufferedAmount = bufferedAmount.load();
+	return stats;
+}
+
 bool DataChannel::isOpen() const { return !mIsClosed && mIsOpen; }
 
 bool DataChannel::isClosed() const { return mIsClosed; }
@@ -201,7 +216,12 @@ bool DataChannel::outgoing(message_ptr message) {
 		message->stream = mStream.value();
 	}
 
-	return transport->send(std::move(message));
+	// Count the message once accepted by the transport, even if it is buffered
+	const size_t size = message->size();
+	bool result = transport->send(std::move(message));
+	mMessagesSent.fetch_add(1, std::memory_order_relaxed);
+	mBytesSent.fetch_add(size, std::memory_order_relaxed);
+	return result;
 }
 
 void DataChannel::incoming(message_ptr message) {
@@ -233,6 +253,8 @@ void DataChannel::incoming(message_ptr message) {
 		break;
 	case Message::String:
 	case Message::Binary:
+		mMessagesReceived.fetch_add(1, std::memory_order_relaxed);
+		mBytesReceived.fetch_add(message->size(), std::memory_order_relaxed);
 		mRecvQueue.push(std::move(message));
 		triggerAvailable(mRecvQueue.size());
 		break;
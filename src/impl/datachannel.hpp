@@ -15,6 +15,7 @@
 #include "queue.hpp"
 #include "reliability.hpp"
 #include "sctptransport.hpp"
+#include "stats.hpp"
 
 #include <atomic>
 #include <shared_mutex>
@@ -43,6 +44,7 @@ struct DataChannel : Channel, std::enable_shared_from_this<DataChannel> {
 	string label() const;
 	string protocol() const;
 	Reliability reliability() const;
+	DataChannelStats stats() const;
 
 	bool isOpen(void) const;
 	bool isClosed(void) const;
@@ -68,6 +70,11 @@ protected:
 
 private:
 	Queue<message_ptr> mRecvQueue;
+
+	std::atomic<uint64_t> mMessagesSent = 0;
+	std::atomic<uint64_t> mBytesSent = 0;
+	std::atomic<uint64_t> mMessagesReceived = 0;
+	std::atomic<uint64_t> mBytesReceived = 0;
 };
 
 struct OutgoingDataChannel final : public DataChannel {
@@ -13,6 +13,7 @@
 
 #if RTC_ENABLE_MEDIA
 
+#include <algorithm>
 #include <cstring>
 #include <exception>
 
@@ -59,11 +60,12 @@ bool DtlsSrtpTransport::IsGcmSupported() {
 DtlsSrtpTransport::DtlsSrtpTransport(shared_ptr<IceTransport> lower,
                                      shared_ptr<Certificate> certificate, optional<size_t> mtu,
                                      CertificateFingerprint::Algorithm fingerprintAlgorithm,
+                                     std::vector<SrtpProfile> srtpProfiles,
                                      verifier_callback verifierCallback,
-                                     message_callback srtpRecvCallback,
-                                     state_callback stateChangeCallback)
-    : DtlsTransport(lower, certificate, mtu, fingerprintAlgorithm, std::move(verifierCallback),
-                    std::move(stateChangeCallback)),
+                                     message_batch_callback srtpRecvCallback,
+                                     state_callback stateChangeCallback, size_t srtpWorkers)
+    : DtlsTransport(lower, certificate, mtu, fingerprintAlgorithm, std::move(srtpProfiles),
+                    std::move(verifierCallback), std::move(stateChangeCallback)),
       mSrtpRecvCallback(std::move(srtpRecvCallback)) { // distinct from Transport recv callback
 
 	PLOG_DEBUG << "Initializing DTLS-SRTP transport";
@@ -75,17 +77,52 @@ DtlsSrtpTransport::DtlsSrtpTransport(shared_ptr<IceTransport> lower,
 		srtp_dealloc(mSrtpIn);
 		throw std::runtime_error("srtp_create failed, status=" + to_string(static_cast<int>(err)));
 	}
+
+	if (srtpWorkers > 0) {
+		PLOG_DEBUG << "Using " << srtpWorkers << " parallel SRTP workers";
+		try {
+			mSrtpInPipeline = std::make_unique<SrtpPipeline>(
+			    srtpWorkers,
+			    [this](srtp_t session, message_ptr &message) {
+				    return unprotectMedia(session, *message);
+			    },
+			    [this](message_vector &messages) { mSrtpRecvCallback(std::move(messages)); });
+			mSrtpOutPipeline = std::make_unique<SrtpPipeline>(
+			    srtpWorkers,
+			    [this](srtp_t session, message_ptr &message) {
+				    try {
+					    protectMedia(session, message);
+					    return true;
+				    } catch (...) {
+					    mAsyncSendFailed = true;
+					    throw; // logged by the pipeline
+				    }
+			    },
+			    [this](message_vector &messages) {
+				    if (!sendProtected(messages))
+					    mAsyncSendFailed = true;
+			    });
+		} catch (...) {
+			mSrtpInPipeline.reset();
+			srtp_dealloc(mSrtpIn);
+			srtp_dealloc(mSrtpOut);
+			throw;
+		}
+	}
 }
 
 DtlsSrtpTransport::~DtlsSrtpTransport() {
 	stop(); // stop before deallocating
 
+	// Wait for pending crypto tasks
+	mSrtpInPipeline.reset();
+	mSrtpOutPipeline.reset();
+
 	srtp_dealloc(mSrtpIn);
 	srtp_dealloc(mSrtpOut);
 }
 
 bool DtlsSrtpTransport::sendMedia(message_ptr message) {
-	std::lock_guard lock(sendMutex);
 	if (!message)
 		return false;
 
@@ -94,16 +131,58 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 		return false;
 	}
 
+	if (mSrtpOutPipeline) {
+		// Protection is asynchronous, so a failure is reported by the next call
+		bool failed = mAsyncSendFailed.exchange(false);
+		mSrtpOutPipeline->push(std::move(message));
+		return !failed;
+	}
+
+	std::lock_guard lock(sendMutex);
+	protectMedia(mSrtpOut, message);
+	return Transport::outgoing(std::move(message)); // bypass DTLS DSCP marking
+}
+
+bool DtlsSrtpTransport::sendMediaBatch(message_vector &messages) {
+	messages.erase(std::remove(messages.begin(), messages.end(), nullptr), messages.end());
+	if (messages.empty())
+		return false;
+
+	if (!mInitDone) {
+		PLOG_ERROR << "SRTP media sent before keys are derived";
+		messages.clear();
+		return false;
+	}
+
+	if (mSrtpOutPipeline) {
+		bool failed = mAsyncSendFailed.exchange(false);
+		mSrtpOutPipeline->push(messages);
+		return !failed;
+	}
+
+	// Protect the whole batch in one pass, then hand it over to the lower transport
+	std::lock_guard lock(sendMutex);
+	for (auto &message : messages)
+		protectMedia(mSrtpOut, message);
+
+	return sendProtected(messages);
+}
+
+void DtlsSrtpTransport::protectMedia(srtp_t session, message_ptr &message) {
 	int size = int(message->size());
 	PLOG_VERBOSE << "Send size=" << size;
 
 	// srtp_protect() and srtp_protect_rtcp() assume that they can write SRTP_MAX_TRAILER_LEN (for
 	// the authentication tag) into the location in memory immediately following the RTP packet.
-	// Copy instead of resizing so we don't interfere with media handlers keeping references
-	message = make_message(size + SRTP_MAX_TRAILER_LEN, message);
+	// Copy instead of resizing if the message is shared so we don't interfere with media handlers
+	// keeping references, like the NACK responder history.
+	if (message.use_count() > 1)
+		message = make_message(size + SRTP_MAX_TRAILER_LEN, message);
+	else
+		message->resize(size + SRTP_MAX_TRAILER_LEN);
 
 	if (IsRtcp(*message)) { // Demultiplex RTCP and RTP using payload type
-		if (srtp_err_status_t err = srtp_protect_rtcp(mSrtpOut, message->data(), &size)) {
+		if (srtp_err_status_t err = srtp_protect_rtcp(session, message->data(), &size)) {
 			if (err == srtp_err_status_replay_fail)
 				throw std::runtime_error("Outgoing SRTCP packet is a replay");
 			else
@@ -113,7 +192,7 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 		PLOG_VERBOSE << "Protected SRTCP packet, size=" << size;
 
 	} else {
-		if (srtp_err_status_t err = srtp_protect(mSrtpOut, message->data(), &size)) {
+		if (srtp_err_status_t err = srtp_protect(session, message->data(), &size)) {
 			if (err == srtp_err_status_replay_fail)
 				throw std::runtime_error("Outgoing SRTP packet is a replay");
 			else
@@ -130,8 +209,24 @@ bool DtlsSrtpTransport::sendMedia(message_ptr message) {
 		// See https://www.rfc-editor.org/rfc/rfc8837.html#section-5
 		message->dscp = 36; // AF42: Assured Forwarding class 4, medium drop probability
 	}
+}
 
-	return Transport::outgoing(std::move(message)); // bypass DTLS DSCP marking
+bool DtlsSrtpTransport::sendProtected(message_vector &messages) {
+	bool result = true;
+	for (auto &message : messages)
+		result = Transport::outgoing(std::move(message)) && result; // bypass DTLS DSCP marking
+
+	messages.clear();
+	return result;
+}
+
+DtlsSrtpTransport::Stats DtlsSrtpTransport::stats() const {
+	Stats stats;
+	stats.truncated = mTruncatedCount.load(std::memory_order_relaxed);
+	stats.replays = mReplayCount.load(std::memory_order_relaxed);
+	stats.authFailures = mAuthFailureCount.load(std::memory_order_relaxed);
+	stats.otherFailures = mOtherFailureCount.load(std::memory_order_relaxed);
+	return stats;
 }
 
 void DtlsSrtpTransport::recvMedia(message_ptr message) {
@@ -140,56 +235,74 @@ void DtlsSrtpTransport::recvMedia(message_ptr message) {
 	int size = int(message->size());
 	if (size < 8) {
 		COUNTER_MEDIA_TRUNCATED++;
+		mTruncatedCount.fetch_add(1, std::memory_order_relaxed);
 		PLOG_VERBOSE << "Incoming SRTP/SRTCP packet too short, size=" << size;
 		return;
 	}
 
-	uint8_t value2 = to_integer<uint8_t>(*(message->begin() + 1)) & 0x7F;
+	if (mSrtpInPipeline) {
+		mSrtpInPipeline->push(std::move(message));
+		return;
+	}
+
+	if (unprotectMedia(mSrtpIn, *message))
+		mSrtpRecvCallback(message_vector{std::move(message)});
+}
+
+bool DtlsSrtpTransport::unprotectMedia(srtp_t session, Message &message) {
+	int size = int(message.size());
+	uint8_t value2 = to_integer<uint8_t>(*(message.begin() + 1)) & 0x7F;
 	PLOG_VERBOSE << "Demultiplexing SRTCP and SRTP with RTP payload type, value="
 	             << unsigned(value2);
 
-	if (IsRtcp(*message)) { // Demultiplex RTCP and RTP using payload type
+	if (IsRtcp(message)) { // Demultiplex RTCP and RTP using payload type
 		PLOG_VERBOSE << "Incoming SRTCP packet, size=" << size;
-		if (srtp_err_status_t err = srtp_unprotect_rtcp(mSrtpIn, message->data(), &size)) {
+		if (srtp_err_status_t err = srtp_unprotect_rtcp(session, message.data(), &size)) {
 			if (err == srtp_err_status_replay_fail) {
 				PLOG_VERBOSE << "Incoming SRTCP packet is a replay";
 				COUNTER_SRTCP_REPLAY++;
+				mReplayCount.fetch_add(1, std::memory_order_relaxed);
 			} else if (err == srtp_err_status_auth_fail) {
 				PLOG_DEBUG << "Incoming SRTCP packet failed authentication check";
 				COUNTER_SRTCP_AUTH_FAIL++;
+				mAuthFailureCount.fetch_add(1, std::memory_order_relaxed);
 			} else {
 				PLOG_DEBUG << "SRTCP unprotect error, status=" << err;
 				COUNTER_SRTCP_FAIL++;
+				mOtherFailureCount.fetch_add(1, std::memory_order_relaxed);
 			}
 
-			return;
+			return false;
 		}
 		PLOG_VERBOSE << "Unprotected SRTCP packet, size=" << size;
-		message->type = Message::Control;
-		message->stream = reinterpret_cast<RtcpSr *>(message->data())->senderSSRC();
+		message.type = Message::Control;
+		message.stream = reinterpret_cast<RtcpSr *>(message.data())->senderSSRC();
 
 	} else {
 		PLOG_VERBOSE << "Incoming SRTP packet, size=" << size;
-		if (srtp_err_status_t err = srtp_unprotect(mSrtpIn, message->data(), &size)) {
+		if (srtp_err_status_t err = srtp_unprotect(session, message.data(), &size)) {
 			if (err == srtp_err_status_replay_fail) {
 				PLOG_VERBOSE << "Incoming SRTP packet is a replay";
 				COUNTER_SRTP_REPLAY++;
+				mReplayCount.fetch_add(1, std::memory_order_relaxed);
 			} else if (err == srtp_err_status_auth_fail) {
 				PLOG_DEBUG << "Incoming SRTP packet failed authentication check";
 				COUNTER_SRTP_AUTH_FAIL++;
+				mAuthFailureCount.fetch_add(1, std::memory_order_relaxed);
 			} else {
 				PLOG_DEBUG << "SRTP unprotect error, status=" << err;
 				COUNTER_SRTP_FAIL++;
+				mOtherFailureCount.fetch_add(1, std::memory_order_relaxed);
 			}
-			return;
+			return false;
 		}
 		PLOG_VERBOSE << "Unprotected SRTP packet, size=" << size;
-		message->type = Message::Binary;
-		message->stream = reinterpret_cast<RtpHeader *>(message->data())->ssrc();
+		message.type = Message::Binary;
+		message.stream = reinterpret_cast<RtpHeader *>(message.data())->ssrc();
 	}
 
-	message->resize(size);
-	mSrtpRecvCallback(message);
+	message.resize(size);
+	return true;
 }
 
 bool DtlsSrtpTransport::demuxMessage(message_ptr message) {
@@ -233,7 +346,24 @@ void DtlsSrtpTransport::postHandshake() {
 #if USE_GNUTLS
 	PLOG_INFO << "Deriving SRTP keying material (GnuTLS)";
 
-	const srtp_profile_t srtpProfile = srtp_profile_aes128_cm_sha1_80;
+	gnutls_srtp_profile_t selectedProfile;
+	gnutls::check(gnutls_srtp_get_selected_profile(mSession, &selectedProfile),
+	              "Failed to get SRTP profile");
+
+	srtp_profile_t srtpProfile;
+	switch (selectedProfile) {
+	case GNUTLS_SRTP_AES128_CM_HMAC_SHA1_80:
+		srtpProfile = srtp_profile_aes128_cm_sha1_80;
+		break;
+	case GNUTLS_SRTP_AES128_CM_HMAC_SHA1_32:
+		srtpProfile = srtp_profile_aes128_cm_sha1_32;
+		break;
+	default:
+		throw std::runtime_error("Unexpected SRTP profile");
+	}
+
+	PLOG_DEBUG << "SRTP profile is: " << gnutls_srtp_get_profile_name(selectedProfile);
+
 	const size_t keySize = SRTP_AES_128_KEY_LEN;
 	const size_t saltSize = SRTP_SALT_LEN;
 	const size_t keySizeWithSalt = SRTP_AES_ICM_128_KEY_LEN_WSALT;
@@ -266,10 +396,18 @@ void DtlsSrtpTransport::postHandshake() {
 
 	mbedtls_dtls_srtp_info srtpInfo;
 	mbedtls_ssl_get_dtls_srtp_negotiation_result(&mSsl, &srtpInfo);
-	if (srtpInfo.MBEDTLS_PRIVATE(chosen_dtls_srtp_profile) != MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80)
+	srtp_profile_t srtpProfile;
+	switch (srtpInfo.MBEDTLS_PRIVATE(chosen_dtls_srtp_profile)) {
+	case MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80:
+		srtpProfile = srtp_profile_aes128_cm_sha1_80;
+		break;
+	case MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_32:
+		srtpProfile = srtp_profile_aes128_cm_sha1_32;
+		break;
+	default:
 		throw std::runtime_error("Failed to get SRTP profile");
+	}
 
-	const srtp_profile_t srtpProfile = srtp_profile_aes128_cm_sha1_80;
 	const size_t keySize = SRTP_AES_128_KEY_LEN;
 	const size_t saltSize = SRTP_SALT_LEN;
 	const size_t keySizeWithSalt = SRTP_AES_ICM_128_KEY_LEN_WSALT;
@@ -349,6 +487,9 @@ void DtlsSrtpTransport::postHandshake() {
 		throw std::runtime_error("SRTP add inbound stream failed, status=" +
 		                         to_string(static_cast<int>(err)));
 
+	if (mSrtpInPipeline)
+		mSrtpInPipeline->addStream(inbound);
+
 	srtp_policy_t outbound = {};
 	if (srtp_crypto_policy_set_from_profile_for_rtp(&outbound.rtp, srtpProfile))
 		throw std::runtime_error("SRTP profile is not supported");
@@ -365,6 +506,9 @@ void DtlsSrtpTransport::postHandshake() {
 		throw std::runtime_error("SRTP add outbound stream failed, status=" +
 		                         to_string(static_cast<int>(err)));
 
+	if (mSrtpOutPipeline)
+		mSrtpOutPipeline->addStream(outbound);
+
 	mInitDone = true;
 }
 
@@ -11,6 +11,7 @@
 
 #include "common.hpp"
 #include "dtlstransport.hpp"
+#include "srtppipeline.hpp"
 
 #if RTC_ENABLE_MEDIA
 
@@ -21,6 +22,8 @@
 #endif
 
 #include <atomic>
+#include <functional>
+#include <memory>
 
 namespace rtc::impl {
 
@@ -30,16 +33,31 @@ public:
 	static void Cleanup();
 	static bool IsGcmSupported();
 
+	using message_batch_callback = std::function<void(message_vector messages)>;
+
 	DtlsSrtpTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
 	                  optional<size_t> mtu, CertificateFingerprint::Algorithm fingerprintAlgorithm,
-	                  verifier_callback verifierCallback, message_callback srtpRecvCallback,
-	                  state_callback stateChangeCallback);
+	                  std::vector<SrtpProfile> srtpProfiles, verifier_callback verifierCallback,
+	                  message_batch_callback srtpRecvCallback, state_callback stateChangeCallback,
+	                  size_t srtpWorkers = 0);
 	~DtlsSrtpTransport();
 
 	bool sendMedia(message_ptr message);
+	bool sendMediaBatch(message_vector &messages); // consumes the messages
+
+	struct Stats {
+		uint64_t truncated;
+		uint64_t replays;
+		uint64_t authFailures;
+		uint64_t otherFailures;
+	};
+	Stats stats() const;
 
 private:
 	void recvMedia(message_ptr message);
+	void protectMedia(srtp_t session, message_ptr &message);
+	bool sendProtected(message_vector &messages);
+	bool unprotectMedia(srtp_t session, Message &message);
 	bool demuxMessage(message_ptr message) override;
 	void postHandshake() override;
 
@@ -53,12 +71,21 @@ private:
 	ProfileParams getProfileParamsFromName(string_view name);
 #endif
 
-	message_callback mSrtpRecvCallback;
+	message_batch_callback mSrtpRecvCallback;
 	srtp_t mSrtpIn, mSrtpOut;
 	std::atomic<bool> mInitDone = false;
 	std::vector<unsigned char> mClientSessionKey;
 	std::vector<unsigned char> mServerSessionKey;
 	std::mutex sendMutex;
+
+	std::atomic<uint64_t> mTruncatedCount = 0;
+	std::atomic<uint64_t> mReplayCount = 0;
+	std::atomic<uint64_t> mAuthFailureCount = 0;
+	std::atomic<uint64_t> mOtherFailureCount = 0;
+
+	// Parallel SRTP crypto, only if workers are enabled
+	unique_ptr<SrtpPipeline> mSrtpInPipeline, mSrtpOutPipeline;
+	std::atomic<bool> mAsyncSendFailed = false;
 };
 
 } // namespace rtc::impl
@@ -29,6 +29,36 @@ using namespace std::chrono;
 
 namespace rtc::impl {
 
+std::vector<SrtpProfile>
+DtlsTransport::SupportedSrtpProfiles(const std::vector<SrtpProfile> &profiles) {
+	std::vector<SrtpProfile> result;
+	for (auto profile : profiles) {
+		if (std::find(result.begin(), result.end(), profile) != result.end())
+			continue;
+
+		bool isGcm = profile == SrtpProfile::AeadAes128Gcm || profile == SrtpProfile::AeadAes256Gcm;
+#if USE_GNUTLS || USE_MBEDTLS
+		if (isGcm) {
+			PLOG_DEBUG << "Ignoring AES-GCM SRTP profile, not supported by the TLS backend";
+			continue;
+		}
+#elif RTC_ENABLE_MEDIA
+		if (isGcm && !DtlsSrtpTransport::IsGcmSupported()) {
+			PLOG_WARNING << "AES-GCM for SRTP is not supported, ignoring profile";
+			continue;
+		}
+#endif
+		result.push_back(profile);
+	}
+
+	// RFC 8827: The DTLS-SRTP protection profile SRTP_AES128_CM_HMAC_SHA1_80 MUST be supported
+	// See https://www.rfc-editor.org/rfc/rfc8827.html#section-6.5
+	if (std::find(result.begin(), result.end(), SrtpProfile::Aes128CmHmacSha1_80) == result.end())
+		result.push_back(SrtpProfile::Aes128CmHmacSha1_80);
+
+	return result;
+}
+
 void DtlsTransport::enqueueRecv() {
 	if (mPendingRecvCount > 0)
 		return;
@@ -52,9 +82,12 @@ void DtlsTransport::Cleanup() { gnutls_global_deinit(); }
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
                              optional<size_t> mtu,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
+                             std::vector<SrtpProfile> srtpProfiles,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
     : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(std::move(certificate)),
-      mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
+      mFingerprintAlgorithm(fingerprintAlgorithm),
+      mSrtpProfiles(SupportedSrtpProfiles(srtpProfiles)),
+      mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
@@ -79,10 +112,17 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		gnutls::check(gnutls_priority_set_direct(mSession, priorities, &err_pos),
 		              "Failed to set TLS priorities");
 
-		// RFC 8827: The DTLS-SRTP protection profile SRTP_AES128_CM_HMAC_SHA1_80 MUST be supported
-		// See https://www.rfc-editor.org/rfc/rfc8827.html#section-6.5
-		gnutls::check(gnutls_srtp_set_profile(mSession, GNUTLS_SRTP_AES128_CM_HMAC_SHA1_80),
-		              "Failed to set SRTP profile");
+		string srtpProfiles;
+		for (auto profile : mSrtpProfiles) {
+			if (!srtpProfiles.empty())
+				srtpProfiles += ':';
+
+			srtpProfiles += profile == SrtpProfile::Aes128CmHmacSha1_32
+			                    ? "SRTP_AES128_CM_HMAC_SHA1_32"
+			                    : "SRTP_AES128_CM_HMAC_SHA1_80";
+		}
+		gnutls::check(gnutls_srtp_set_profile_direct(mSession, srtpProfiles.c_str(), &err_pos),
+		              "Failed to set SRTP profiles");
 
 		gnutls::check(gnutls_credentials_set(mSession, GNUTLS_CRD_CERTIFICATE, creds));
 
@@ -372,17 +412,15 @@ int DtlsTransport::TimeoutCallback(gnutls_transport_ptr_t ptr, unsigned int /* m
 
 #elif USE_MBEDTLS
 
-const mbedtls_ssl_srtp_profile srtpSupportedProtectionProfiles[] = {
-    MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80,
-    MBEDTLS_TLS_SRTP_UNSET,
-};
-
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
                              optional<size_t> mtu,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
+                             std::vector<SrtpProfile> srtpProfiles,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
     : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(std::move(certificate)),
-      mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
+      mFingerprintAlgorithm(fingerprintAlgorithm),
+      mSrtpProfiles(SupportedSrtpProfiles(srtpProfiles)),
+      mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
@@ -410,7 +448,14 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		mbedtls::check(mbedtls_ssl_conf_own_cert(&mConf, crt.get(), pk.get()));
 
 		mbedtls_ssl_conf_dtls_cookies(&mConf, NULL, NULL, NULL);
-		mbedtls_ssl_conf_dtls_srtp_protection_profiles(&mConf, srtpSupportedProtectionProfiles);
+		// The profiles array is referenced by the configuration, so it must outlive it
+		for (auto profile : mSrtpProfiles)
+			mSrtpProtectionProfiles.push_back(profile == SrtpProfile::Aes128CmHmacSha1_32
+			                                      ? MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_32
+			                                      : MBEDTLS_TLS_SRTP_AES128_CM_HMAC_SHA1_80);
+
+		mSrtpProtectionProfiles.push_back(MBEDTLS_TLS_SRTP_UNSET);
+		mbedtls_ssl_conf_dtls_srtp_protection_profiles(&mConf, mSrtpProtectionProfiles.data());
 
 		mbedtls::check(mbedtls_ssl_setup(&mSsl, &mConf));
 
@@ -723,9 +768,12 @@ void DtlsTransport::Cleanup() {
 DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate,
                              optional<size_t> mtu,
                              CertificateFingerprint::Algorithm fingerprintAlgorithm,
+                             std::vector<SrtpProfile> srtpProfiles,
                              verifier_callback verifierCallback, state_callback stateChangeCallback)
     : Transport(lower, std::move(stateChangeCallback)), mMtu(mtu), mCertificate(std::move(certificate)),
-      mFingerprintAlgorithm(fingerprintAlgorithm), mVerifierCallback(std::move(verifierCallback)),
+      mFingerprintAlgorithm(fingerprintAlgorithm),
+      mSrtpProfiles(SupportedSrtpProfiles(srtpProfiles)),
+      mVerifierCallback(std::move(verifierCallback)),
       mIsClient(lower->role() == Description::Role::Active),
       mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
 
@@ -792,24 +840,35 @@ DtlsTransport::DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr cer
 		BIO_set_data(mOutBio, this);
 		SSL_set_bio(mSsl, mInBio, mOutBio);
 
-		// RFC 8827: The DTLS-SRTP protection profile SRTP_AES128_CM_HMAC_SHA1_80 MUST be supported
-		// See https://www.rfc-editor.org/rfc/rfc8827.html#section-6.5
+		string srtpProfiles;
+		for (auto profile : mSrtpProfiles) {
+			if (!srtpProfiles.empty())
+				srtpProfiles += ':';
+
+			switch (profile) {
+			case SrtpProfile::AeadAes128Gcm:
+				srtpProfiles += "SRTP_AEAD_AES_128_GCM";
+				break;
+			case SrtpProfile::AeadAes256Gcm:
+				srtpProfiles += "SRTP_AEAD_AES_256_GCM";
+				break;
+			case SrtpProfile::Aes128CmHmacSha1_32:
+				srtpProfiles += "SRTP_AES128_CM_SHA1_32";
+				break;
+			default:
+				srtpProfiles += "SRTP_AES128_CM_SHA1_80";
+				break;
+			}
+		}
+
 		// Warning: SSL_set_tlsext_use_srtp() returns 0 on success and 1 on error
-#if RTC_ENABLE_MEDIA
-		// Try to use GCM suite
-		if (!DtlsSrtpTransport::IsGcmSupported() ||
-		    SSL_set_tlsext_use_srtp(
-		        mSsl, "SRTP_AEAD_AES_256_GCM:SRTP_AEAD_AES_128_GCM:SRTP_AES128_CM_SHA1_80")) {
-			PLOG_WARNING << "AES-GCM for SRTP is not supported, falling back to default profile";
+		if (SSL_set_tlsext_use_srtp(mSsl, srtpProfiles.c_str())) {
+			PLOG_WARNING << "SRTP profiles \"" << srtpProfiles
+			             << "\" are not supported, falling back to default profile";
 			if (SSL_set_tlsext_use_srtp(mSsl, "SRTP_AES128_CM_SHA1_80"))
 				throw std::runtime_error("Failed to set SRTP profile: " +
 				                         openssl::error_string(ERR_get_error()));
 		}
-#else
-		if (SSL_set_tlsext_use_srtp(mSsl, "SRTP_AES128_CM_SHA1_80"))
-			throw std::runtime_error("Failed to set SRTP profile: " +
-			                         openssl::error_string(ERR_get_error()));
-#endif
 	} catch (...) {
 		if (mSsl)
 			SSL_free(mSsl);
@@ -11,6 +11,7 @@
 
 #include "certificate.hpp"
 #include "common.hpp"
+#include "configuration.hpp"
 #include "queue.hpp"
 #include "tls.hpp"
 #include "transport.hpp"
@@ -19,6 +20,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace rtc::impl {
 
@@ -33,7 +35,8 @@ public:
 
 	DtlsTransport(shared_ptr<IceTransport> lower, certificate_ptr certificate, optional<size_t> mtu,
 	              CertificateFingerprint::Algorithm fingerprintAlgorithm,
-	              verifier_callback verifierCallback, state_callback stateChangeCallback);
+	              std::vector<SrtpProfile> srtpProfiles, verifier_callback verifierCallback,
+	              state_callback stateChangeCallback);
 	~DtlsTransport();
 
 	virtual void start() override;
@@ -51,9 +54,13 @@ protected:
 	void enqueueRecv();
 	void doRecv();
 
+	// Filters out unsupported profiles and adds the mandatory one if missing
+	static std::vector<SrtpProfile> SupportedSrtpProfiles(const std::vector<SrtpProfile> &profiles);
+
 	const optional<size_t> mMtu;
 	const certificate_ptr mCertificate;
 	CertificateFingerprint::Algorithm mFingerprintAlgorithm;
+	const std::vector<SrtpProfile> mSrtpProfiles; // in order of preference
 	const verifier_callback mVerifierCallback;
 	const bool mIsClient;
 
@@ -75,6 +82,7 @@ protected:
 #elif USE_MBEDTLS
 	mbedtls_ssl_config mConf;
 	mbedtls_ssl_context mSsl;
+	std::vector<mbedtls_ssl_srtp_profile> mSrtpProtectionProfiles; // terminated with UNSET
 
 	std::recursive_mutex mSslMutex;
 
@@ -7,11 +7,34 @@
  */
 
 #include "http.hpp"
+#include "internals.hpp"
 
 #include <algorithm>
+#include <cctype>
+#include <cstring>
 
 namespace rtc::impl {
 
+using std::string_view;
+
+namespace {
+
+bool isWhitespace(char c) { return c == ' ' || c == '\t'; }
+
+// Extract the next whitespace-separated token from [cur, end)
+string_view nextToken(const char *&cur, const char *end) {
+	while (cur != end && isWhitespace(*cur))
+		++cur;
+
+	const char *begin = cur;
+	while (cur != end && !isWhitespace(*cur))
+		++cur;
+
+	return string_view(begin, cur - begin);
+}
+
+} // namespace
+
 bool isHttpRequest(const byte *buffer, size_t size) {
 	// Check the buffer starts with a valid-looking HTTP method
 	for (size_t i = 0; i < size; ++i) {
@@ -24,41 +47,141 @@ bool isHttpRequest(const byte *buffer, size_t size) {
 	return true;
 }
 
-size_t parseHttpLines(const byte *buffer, size_t size, std::list<string> &lines) {
-	lines.clear();
-	auto begin = reinterpret_cast<const char *>(buffer);
-	auto end = begin + size;
-	auto cur = begin;
-	while (true) {
-		auto last = cur;
-		cur = std::find(cur, end, '\n');
-		if (cur == end)
-			return 0;
-		string line(last, cur != begin && *std::prev(cur) == '\r' ? std::prev(cur++) : cur++);
-		if (line.empty())
+bool httpTokenEquals(string_view a, string_view b) {
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+		       return std::tolower(static_cast<unsigned char>(x)) ==
+		              std::tolower(static_cast<unsigned char>(y));
+	       });
+}
+
+HttpParser::Error::Error(const string &w, int responseCode)
+    : std::runtime_error(w), mResponseCode(responseCode) {}
+
+int HttpParser::Error::responseCode() const { return mResponseCode; }
+
+HttpParser::HttpParser(Type type) : mType(type) {}
+
+size_t HttpParser::parse(const byte *buffer, size_t size) {
+	mBase = reinterpret_cast<const char *>(buffer);
+	if (mLength > 0)
+		return mLength; // already complete
+
+	// Never look further than the limit, so the caller can stop buffering
+	const char *end = mBase + std::min(size, HTTP_MAX_HEAD_SIZE);
+	const char *cur = mBase + mLineStart;
+	while (cur < end) {
+		auto eol = static_cast<const char *>(std::memchr(cur, '\n', end - cur));
+		if (!eol)
 			break;
-		lines.emplace_back(std::move(line));
+
+		const char *lineEnd = eol != cur && *(eol - 1) == '\r' ? eol - 1 : eol;
+		mLineStart = eol + 1 - mBase;
+
+		if (mHeadersStart == 0) {
+			parseStartLine(cur, lineEnd);
+			mHeadersStart = mLineStart;
+		} else if (lineEnd == cur) {
+			mLength = mLineStart;
+			return mLength;
+		} else if (++mHeadersCount > HTTP_MAX_HEADERS_COUNT) {
+			throw Error("Too many HTTP headers", 431);
+		}
+
+		cur = mBase + mLineStart;
 	}
 
-	return cur - begin;
+	if (size >= HTTP_MAX_HEAD_SIZE)
+		throw Error("HTTP headers are too large", 431);
+
+	return 0;
 }
 
-http_headers parseHttpHeaders(const std::list<string> &lines) {
-	http_headers headers;
-	for (const auto &line : lines) {
-		if (size_t pos = line.find_first_of(':'); pos != string::npos) {
-			string key = line.substr(0, pos);
-			string value = "";
-			if (size_t subPos = line.find_first_not_of(' ', pos + 1); subPos != string::npos) {
-				value = line.substr(subPos);
-			}
-			headers.emplace(std::move(key), std::move(value));
-		} else {
-			headers.emplace(line, "");
-		}
+void HttpParser::reset() {
+	mBase = nullptr;
+	mLength = 0;
+	mLineStart = 0;
+	mHeadersStart = 0;
+	mHeadersCount = 0;
+	mMethod = mTarget = mVersion = Span{};
+	mStatusCode = 0;
+}
+
+string_view HttpParser::method() const { return view(mMethod); }
+
+string_view HttpParser::target() const { return view(mTarget); }
+
+string_view HttpParser::version() const { return view(mVersion); }
+
+unsigned int HttpParser::statusCode() const { return mStatusCode; }
+
+optional<string_view> HttpParser::header(string_view name) const {
+	string_view n, v;
+	size_t offset = mHeadersStart;
+	while ((offset = nextHeader(offset, n, v)) != 0)
+		if (httpTokenEquals(n, name))
+			return v;
+
+	return nullopt;
+}
+
+void HttpParser::parseStartLine(const char *begin, const char *end) {
+	auto span = [this](string_view token) {
+		return Span{uint32_t(token.data() - mBase), uint32_t(token.size())};
+	};
+
+	const char *cur = begin;
+	if (mType == Type::Request) {
+		// Request line: method SP request-target SP HTTP-version
+		mMethod = span(nextToken(cur, end));
+		mTarget = span(nextToken(cur, end));
+		mVersion = span(nextToken(cur, end));
+		if (mMethod.length == 0 || mTarget.length == 0)
+			throw Error("Invalid HTTP request line");
+
+	} else {
+		// Status line: HTTP-version SP status-code SP [ reason-phrase ]
+		mVersion = span(nextToken(cur, end));
+		string_view code = nextToken(cur, end);
+		if (mVersion.length == 0)
+			throw Error("Invalid HTTP status line");
+
+		mStatusCode = 0;
+		if (code.size() == 3 &&
+		    std::all_of(code.begin(), code.end(), [](char c) { return c >= '0' && c <= '9'; }))
+			for (char c : code)
+				mStatusCode = mStatusCode * 10 + unsigned(c - '0');
 	}
+}
+
+string_view HttpParser::view(Span span) const {
+	return mBase ? string_view(mBase + span.offset, span.length) : string_view();
+}
+
+size_t HttpParser::nextHeader(size_t offset, string_view &name, string_view &value) const {
+	// Returns the offset of the following line, or 0 if there is no more header
+	if (!mBase || mLength == 0 || offset >= mLength)
+		return 0;
+
+	const char *begin = mBase + offset;
+	const char *end = mBase + mLength;
+	auto eol = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+	const char *lineEnd = eol != begin && *(eol - 1) == '\r' ? eol - 1 : eol;
+	if (lineEnd == begin)
+		return 0; // empty line ending the head
+
+	// A line without colon is considered a header with an empty value
+	const char *colon = std::find(begin, lineEnd, ':');
+	name = string_view(begin, colon - begin);
+
+	const char *valueBegin = colon != lineEnd ? colon + 1 : lineEnd;
+	const char *valueEnd = lineEnd;
+	while (valueBegin != valueEnd && isWhitespace(*valueBegin))
+		++valueBegin;
+	while (valueEnd != valueBegin && isWhitespace(*(valueEnd - 1)))
+		--valueEnd;
 
-	return headers;
+	value = string_view(valueBegin, valueEnd - valueBegin);
+	return eol + 1 - mBase;
 }
 
 } // namespace rtc::impl
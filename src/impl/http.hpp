@@ -11,8 +11,9 @@
 
 #include "common.hpp"
 
-#include <list>
 #include <map>
+#include <stdexcept>
+#include <string_view>
 
 namespace rtc::impl {
 
@@ -21,11 +22,69 @@ using http_headers = std::multimap<string, string, case_insensitive_less>;
 // Check the buffer contains the beginning of an HTTP request
 bool isHttpRequest(const byte *buffer, size_t size);
 
-// Parse an http message into lines
-size_t parseHttpLines(const byte *buffer, size_t size, std::list<string> &lines);
+// Compare HTTP tokens like header names case-insensitively
+bool httpTokenEquals(std::string_view a, std::string_view b);
 
-// Parse headers of a http message
-http_headers parseHttpHeaders(const std::list<string> &lines);
+// Incremental parser for the head of an HTTP/1.1 request or response, i.e. the start line and
+// the headers. It works in place on received bytes and never allocates: fields are views into the
+// buffer passed to the last call to parse(), valid as long as it is not modified.
+class HttpParser final {
+public:
+	enum class Type { Request, Response };
+
+	class Error : public std::runtime_error {
+	public:
+		explicit Error(const string &w, int responseCode = 400);
+		int responseCode() const;
+
+	private:
+		const int mResponseCode;
+	};
+
+	explicit HttpParser(Type type);
+
+	// The buffer must start with the bytes passed on previous calls, followed by newly received
+	// ones. Lines already parsed are not scanned again. Returns the length of the head when it is
+	// complete, 0 if more data is needed. Throws Error if the head is invalid or too large.
+	size_t parse(const byte *buffer, size_t size);
+	void reset();
+
+	std::string_view method() const;  // request only
+	std::string_view target() const;  // request only
+	std::string_view version() const;
+	unsigned int statusCode() const; // response only, 0 if invalid
+
+	// Header lookups scan the head again, which is faster than building an index for a few
+	// lookups on a small head
+	optional<std::string_view> header(std::string_view name) const;
+	template <typename F> void forEachHeader(F func) const;
+
+private:
+	struct Span {
+		uint32_t offset = 0;
+		uint32_t length = 0;
+	};
+
+	void parseStartLine(const char *begin, const char *end);
+	std::string_view view(Span span) const;
+	size_t nextHeader(size_t offset, std::string_view &name, std::string_view &value) const;
+
+	const Type mType;
+	const char *mBase = nullptr;
+	size_t mLength = 0;    // head length when complete
+	size_t mLineStart = 0; // start of the first line not parsed yet
+	size_t mHeadersStart = 0;
+	size_t mHeadersCount = 0;
+	Span mMethod, mTarget, mVersion;
+	unsigned int mStatusCode = 0;
+};
+
+template <typename F> void HttpParser::forEachHeader(F func) const {
+	std::string_view name, value;
+	size_t offset = mHeadersStart;
+	while ((offset = nextHeader(offset, name, value)) != 0)
+		func(name, value);
+}
 
 } // namespace rtc::impl
 
@@ -21,7 +21,7 @@ using std::chrono::system_clock;
 HttpProxyTransport::HttpProxyTransport(shared_ptr<TcpTransport> lower, std::string hostname,
                                        std::string service, state_callback stateCallback)
     : Transport(lower, std::move(stateCallback)), mHostname(std::move(hostname)),
-      mService(std::move(service)) {
+      mService(std::move(service)), mParser(HttpParser::Type::Response) {
 	PLOG_DEBUG << "Initializing HTTP proxy transport";
 	if (!lower->isActive())
 		throw std::logic_error("HTTP proxy transport expects the lower transport to be active");
@@ -48,6 +48,8 @@ bool HttpProxyTransport::send(message_ptr message) {
 
 bool HttpProxyTransport::isActive() const { return true; }
 
+string HttpProxyTransport::remoteAddress() const { return mHostname + ':' + mService; }
+
 void HttpProxyTransport::incoming(message_ptr message) {
 	auto s = state();
 	if (s != State::Connecting && s != State::Connected)
@@ -102,21 +104,17 @@ string HttpProxyTransport::generateHttpRequest() {
 }
 
 size_t HttpProxyTransport::parseHttpResponse(std::byte *buffer, size_t size) {
-	std::list<string> lines;
-	size_t length = parseHttpLines(buffer, size, lines);
+	size_t length;
+	try {
+		length = mParser.parse(buffer, size);
+	} catch (const HttpParser::Error &e) {
+		throw std::runtime_error(string("Invalid response from HTTP proxy: ") + e.what());
+	}
+
 	if (length == 0)
 		return 0;
 
-	if (lines.empty())
-		throw std::runtime_error("Invalid response from HTTP proxy");
-
-	std::istringstream status(std::move(lines.front()));
-	lines.pop_front();
-
-	string protocol;
-	unsigned int code = 0;
-	status >> protocol >> code;
-
+	unsigned int code = mParser.statusCode();
 	if (code != 200)
 		throw std::runtime_error("Unexpected response code " + to_string(code) +
 		                         " from HTTP proxy");
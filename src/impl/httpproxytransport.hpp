@@ -11,6 +11,7 @@
 #define RTC_IMPL_TCP_PROXY_TRANSPORT_H
 
 #include "common.hpp"
+#include "http.hpp"
 #include "transport.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
@@ -31,6 +32,7 @@ public:
 	bool send(message_ptr message) override;
 
 	bool isActive() const;
+	string remoteAddress() const; // of the target server, not the proxy
 
 private:
 	void incoming(message_ptr message) override;
@@ -41,6 +43,7 @@ private:
 	string mHostname;
 	string mService;
 	binary mBuffer;
+	HttpParser mParser;
 };
 
 } // namespace rtc::impl
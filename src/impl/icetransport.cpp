@@ -290,7 +290,13 @@ bool IceTransport::send(message_ptr message) {
 		return false;
 
 	PLOG_VERBOSE << "Send size=" << message->size();
-	return outgoing(std::move(message));
+	size_t size = message->size();
+	if (!outgoing(std::move(message)))
+		return false;
+
+	mPacketsSent.fetch_add(1, std::memory_order_relaxed);
+	mBytesSent.fetch_add(size, std::memory_order_relaxed);
+	return true;
 }
 
 bool IceTransport::outgoing(message_ptr message) {
@@ -804,7 +810,13 @@ bool IceTransport::send(message_ptr message) {
 		return false;
 
 	PLOG_VERBOSE << "Send size=" << message->size();
-	return outgoing(std::move(message));
+	size_t size = message->size();
+	if (!outgoing(std::move(message)))
+		return false;
+
+	mPacketsSent.fetch_add(1, std::memory_order_relaxed);
+	mBytesSent.fetch_add(size, std::memory_order_relaxed);
+	return true;
 }
 
 bool IceTransport::outgoing(message_ptr message) {
@@ -975,4 +987,22 @@ bool IceTransport::getSelectedCandidatePair(Candidate *local, Candidate *remote)
 
 #endif
 
+void IceTransport::incoming(message_ptr message) {
+	mPacketsReceived.fetch_add(1, std::memory_order_relaxed);
+	mBytesReceived.fetch_add(message->size(), std::memory_order_relaxed);
+	Transport::incoming(std::move(message));
+}
+
+uint64_t IceTransport::packetsSent() const { return mPacketsSent.load(std::memory_order_relaxed); }
+
+uint64_t IceTransport::bytesSent() const { return mBytesSent.load(std::memory_order_relaxed); }
+
+uint64_t IceTransport::packetsReceived() const {
+	return mPacketsReceived.load(std::memory_order_relaxed);
+}
+
+uint64_t IceTransport::bytesReceived() const {
+	return mBytesReceived.load(std::memory_order_relaxed);
+}
+
 } // namespace rtc::impl
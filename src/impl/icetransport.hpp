@@ -59,7 +59,14 @@ public:
 
 	bool getSelectedCandidatePair(Candidate *local, Candidate *remote);
 
+	// Stats
+	uint64_t packetsSent() const;
+	uint64_t bytesSent() const;
+	uint64_t packetsReceived() const;
+	uint64_t bytesReceived() const;
+
 private:
+	void incoming(message_ptr message) override;
 	bool outgoing(message_ptr message) override;
 
 	void changeGatheringState(GatheringState state);
@@ -79,6 +86,11 @@ private:
 	candidate_callback mCandidateCallback;
 	gathering_state_callback mGatheringStateChangeCallback;
 
+	std::atomic<uint64_t> mPacketsSent = 0;
+	std::atomic<uint64_t> mBytesSent = 0;
+	std::atomic<uint64_t> mPacketsReceived = 0;
+	std::atomic<uint64_t> mBytesReceived = 0;
+
 #if !USE_NICE
 	unique_ptr<juice_agent_t, void (*)(juice_agent_t *)> mAgent;
 	int mTurnServersAdded = 0;
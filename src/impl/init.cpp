@@ -23,6 +23,7 @@
 
 #if RTC_ENABLE_MEDIA
 #include "dtlssrtptransport.hpp"
+#include "pacingengine.hpp"
 #endif
 
 #ifdef _WIN32
@@ -112,6 +113,65 @@ void Init::setSctpSettings(SctpSettings s) {
 	mCurrentSctpSettings = std::move(s); // store for next init
 }
 
+void Init::setExternalEventLoop(bool enabled) {
+	std::lock_guard lock(mMutex);
+	mExternalEventLoop = enabled; // applied on next init
+}
+
+bool Init::isExternalEventLoop() const { return mExternalEventLoopRunning; }
+
+int Init::poll(std::chrono::milliseconds timeout) {
+	using clock = ThreadPool::clock;
+	// A negative timeout means waiting indefinitely, as for poll(2)
+	const auto until = timeout >= std::chrono::milliseconds::zero()
+	                       ? std::make_optional(clock::now() + timeout)
+	                       : nullopt;
+	auto &threadPool = ThreadPool::Instance();
+	if (!mExternalEventLoopRunning) {
+		if (!mExternalEventLoop)
+			throw std::logic_error("External event loop is not enabled");
+
+		return threadPool.poll(until); // not initialized yet
+	}
+
+#if RTC_ENABLE_WEBSOCKET
+	// Scheduled tasks interrupt the poll service, so wait for both there
+	auto &pollService = PollService::Instance();
+	int count = threadPool.poll(clock::now());
+	auto limit = count == 0 ? until : clock::now();
+	if (auto next = threadPool.nextTime())
+		limit = limit ? std::min(*limit, *next) : *next;
+
+	optional<clock::duration> pollTimeout;
+	if (limit)
+		pollTimeout = std::max(*limit - clock::now(), clock::duration::zero());
+
+	count += pollService.poll(pollTimeout);
+	count += threadPool.poll(clock::now());
+	return count;
+#else
+	return threadPool.poll(until);
+#endif
+}
+
+optional<std::chrono::milliseconds> Init::pollTimeout() {
+	using clock = ThreadPool::clock;
+	auto next = ThreadPool::Instance().nextTime();
+#if RTC_ENABLE_WEBSOCKET
+	std::vector<struct pollfd> pfds;
+	optional<clock::time_point> pollNext;
+	PollService::Instance().descriptors(pfds, pollNext);
+	if (pollNext)
+		next = next ? std::min(*next, *pollNext) : *pollNext;
+#endif
+	if (!next)
+		return nullopt;
+
+	// Round up so that timers have expired when the application calls back
+	return std::chrono::ceil<std::chrono::milliseconds>(
+	    std::max(*next - clock::now(), clock::duration::zero()));
+}
+
 void Init::doInit() {
 	// mMutex needs to be locked
 
@@ -126,13 +186,25 @@ void Init::doInit() {
 		throw std::runtime_error("WSAStartup failed, error=" + std::to_string(WSAGetLastError()));
 #endif
 
-	unsigned int count = mThreadPoolSize > 0 ? mThreadPoolSize : std::thread::hardware_concurrency();
-	count = std::max(count, MIN_THREADPOOL_SIZE);
-	PLOG_DEBUG << "Spawning " << count << " threads";
-	ThreadPool::Instance().spawn(count);
+	const bool external = mExternalEventLoop;
+	if (external) {
+		// Tasks and socket events are processed when the application calls poll()
+		PLOG_DEBUG << "Using an external event loop";
+	} else {
+		unsigned int count =
+		    mThreadPoolSize > 0 ? mThreadPoolSize : std::thread::hardware_concurrency();
+		count = std::max(count, MIN_THREADPOOL_SIZE);
+		PLOG_DEBUG << "Spawning " << count << " threads";
+		ThreadPool::Instance().spawn(count);
+	}
 
 #if RTC_ENABLE_WEBSOCKET
-	PollService::Instance().start();
+	PollService::Instance().start(external);
+	if (external)
+		ThreadPool::Instance().setInterrupt([]() { PollService::Instance().interrupt(); });
+#endif
+#if RTC_ENABLE_MEDIA
+	PacingEngine::Instance().setExternal(external);
 #endif
 
 #if USE_GNUTLS
@@ -153,6 +225,8 @@ void Init::doInit() {
 	DtlsSrtpTransport::Init();
 #endif
 	IceTransport::Init();
+
+	mExternalEventLoopRunning = external;
 }
 
 void Init::doCleanup() {
@@ -165,11 +239,16 @@ void Init::doCleanup() {
 
 	PLOG_DEBUG << "Global cleanup";
 
+	mExternalEventLoopRunning = false;
 	ThreadPool::Instance().join();
 	ThreadPool::Instance().clear();
+	ThreadPool::Instance().setInterrupt(nullptr);
 #if RTC_ENABLE_WEBSOCKET
 	PollService::Instance().join();
 #endif
+#if RTC_ENABLE_MEDIA
+	PacingEngine::Instance().join();
+#endif
 
 	SctpTransport::Cleanup();
 	DtlsTransport::Cleanup();
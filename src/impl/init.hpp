@@ -12,6 +12,7 @@
 #include "common.hpp"
 #include "global.hpp" // for SctpSettings
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <mutex>
@@ -35,6 +36,13 @@ public:
 
 	void setThreadPoolSize(unsigned int count);
 	void setSctpSettings(SctpSettings s);
+	void setExternalEventLoop(bool enabled);
+	bool isExternalEventLoop() const; // true if initialized with an external event loop
+
+	// For an external event loop
+	int poll(std::chrono::milliseconds timeout); // returns the number of processed events,
+	                                             // waits indefinitely if timeout is negative
+	optional<std::chrono::milliseconds> pollTimeout();
 
 private:
 	Init();
@@ -48,6 +56,8 @@ private:
 	bool mInitialized = false;
 	SctpSettings mCurrentSctpSettings = {};
 	unsigned int mThreadPoolSize = 0;
+	std::atomic<bool> mExternalEventLoop = false;
+	std::atomic<bool> mExternalEventLoopRunning = false;
 	std::mutex mMutex;
 	std::shared_future<void> mCleanupFuture;
 
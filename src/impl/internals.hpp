@@ -42,6 +42,15 @@ const size_t DEFAULT_LOCAL_MAX_MESSAGE_SIZE = 256 * 1024; // Default local max m
 const size_t DEFAULT_REMOTE_MAX_MESSAGE_SIZE = 65536;     // Remote max message size if not in SDP
 
 const size_t DEFAULT_WS_MAX_MESSAGE_SIZE = 256 * 1024;   // Default max message size for WebSockets
+const size_t WS_STREAM_BUFFER_SIZE = 256 * 1024;         // Buffered amount to keep while streaming
+const size_t WS_FRAME_RESERVE_SIZE = 16 * 1024;          // Max buffer reserved for incomplete frames
+
+const size_t HTTP_MAX_HEAD_SIZE = 16 * 1024; // Max size of HTTP request or response headers
+const size_t HTTP_MAX_HEADERS_COUNT = 100;   // Max number of HTTP request or response headers
+
+const size_t TLS_SESSION_CACHE_SIZE = 256;        // Max number of servers with cached TLS sessions
+const size_t TLS_SESSION_CACHE_DEPTH = 4;          // Max number of TLS sessions cached per server
+const unsigned int TLS_TICKET_KEY_LIFETIME = 3600; // Lifetime of TLS session ticket keys (seconds)
 
 const size_t RECV_QUEUE_LIMIT = 1024; // Max per-channel queue size (messages)
 
@@ -49,6 +58,10 @@ const unsigned int MIN_THREADPOOL_SIZE = 2; // Minimum number of threads in the
 
 const size_t DEFAULT_MTU = RTC_DEFAULT_MTU; // defined in rtc.h
 
+const unsigned int RTP_HISTORY_STREAM_TIMEOUT = 10; // Lifetime of idle streams in RTP history (seconds)
+
+const uint16_t PACING_RETRANSMISSION_WINDOW = 4096; // Max age of paced retransmissions (packets)
+
 } // namespace rtc
 
 #endif
@@ -0,0 +1,338 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "pacingengine.hpp"
+#include "threadpool.hpp"
+#include "utils.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include <algorithm>
+
+namespace rtc::impl {
+
+namespace {
+
+bool isRetransmission(PacingFlow &flow, const message_ptr &message) {
+	if (message->type == Message::Control || message->size() < sizeof(RtpHeader))
+		return false;
+
+	auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+	if (flow.retransmissionSsrcs.find(rtp->ssrc()) != flow.retransmissionSsrcs.end())
+		return true;
+
+	// Plain retransmissions reuse the sequence number of the original packet, while a larger jump
+	// backwards means the sequence was restarted
+	uint16_t seq = rtp->seqNumber();
+	auto [it, inserted] = flow.lastSequenceNumbers.emplace(rtp->ssrc(), seq);
+	if (inserted)
+		return false;
+
+	if (uint16_t(it->second - seq) < PACING_RETRANSMISSION_WINDOW)
+		return true;
+
+	it->second = seq;
+	return false;
+}
+
+} // namespace
+
+void TokenBucket::refill(clock::time_point now) {
+	if (now > lastRefill) {
+		double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+		tokens = std::min(tokens + elapsed * bytesPerSecond, burstSize);
+	}
+	lastRefill = now;
+}
+
+void TokenBucket::setRate(double newBytesPerSecond, double newBurstSize, clock::time_point now) {
+	refill(now);
+	bytesPerSecond = newBytesPerSecond;
+	burstSize = newBurstSize;
+	tokens = std::min(tokens, burstSize);
+}
+
+optional<TokenBucket::clock::time_point> TokenBucket::available(clock::time_point now) const {
+	if (tokens > 0.)
+		return now;
+
+	if (bytesPerSecond <= 0.)
+		return nullopt;
+
+	// Wait until the bucket holds at least one byte
+	double seconds = (1. - tokens) / bytesPerSecond;
+	return now +
+	       std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+}
+
+void PacingScheduler::add(shared_ptr<PacingFlow> flow, clock::time_point now) {
+	mBudget.refill(now);
+	mBudget.tokens += flow->bucket.tokens;
+	mFlows.push_back(std::move(flow));
+	updateBudget(now);
+}
+
+void PacingScheduler::remove(const shared_ptr<PacingFlow> &flow, clock::time_point now) {
+	mFlows.erase(std::remove(mFlows.begin(), mFlows.end(), flow), mFlows.end());
+	updateBudget(now);
+}
+
+void PacingScheduler::setRate(const shared_ptr<PacingFlow> &flow, double bytesPerSecond,
+                              double burstSize, clock::time_point now) {
+	flow->bucket.setRate(bytesPerSecond, burstSize, now);
+	updateBudget(now);
+}
+
+void PacingScheduler::updateBudget(clock::time_point now) {
+	double bytesPerSecond = 0.;
+	double burstSize = 0.;
+	for (const auto &flow : mFlows) {
+		bytesPerSecond += flow->bucket.bytesPerSecond;
+		burstSize += flow->bucket.burstSize;
+	}
+
+	mBudget.setRate(bytesPerSecond, burstSize, now);
+}
+
+optional<PacingScheduler::clock::time_point>
+PacingScheduler::process(clock::time_point now, std::vector<Batch> &batches) {
+	// Packets bypassing the bucket of their flow are still limited by the shared budget. A single
+	// packet over budget is allowed.
+	auto take = [&](const shared_ptr<PacingFlow> &flow, std::deque<message_ptr> &queue,
+	                bool bypass) {
+		message_vector *batch = nullptr;
+		while (!queue.empty() && mBudget.tokens > 0. && (bypass || flow->bucket.tokens > 0.)) {
+			if (!batch) {
+				auto it = std::find_if(batches.begin(), batches.end(),
+				                       [&](const Batch &b) { return b.first == flow; });
+				if (it == batches.end())
+					it = batches.emplace(batches.end(), flow, message_vector{});
+
+				batch = &it->second;
+			}
+
+			double size = double(queue.front()->size());
+			flow->bucket.tokens -= size;
+			mBudget.tokens -= size;
+			batch->push_back(std::move(queue.front()));
+			queue.pop_front();
+		}
+	};
+
+	mBudget.refill(now);
+	for (auto &flow : mFlows)
+		flow->bucket.refill(now);
+
+	for (auto &flow : mFlows)
+		if (flow->priority == PacingFlow::Priority::Audio)
+			take(flow, flow->queue, true);
+
+	for (auto &flow : mFlows)
+		take(flow, flow->retransmissionQueue, true);
+
+	for (auto &flow : mFlows)
+		if (flow->priority == PacingFlow::Priority::Video)
+			take(flow, flow->queue, false);
+
+	// Compute when the next packet may be released
+	auto budgetAvailable = mBudget.available(now);
+	if (!budgetAvailable)
+		return nullopt;
+
+	optional<clock::time_point> next;
+	for (const auto &flow : mFlows) {
+		optional<clock::time_point> time;
+		if (!flow->retransmissionQueue.empty() ||
+		    (flow->priority == PacingFlow::Priority::Audio && !flow->queue.empty()))
+			time = budgetAvailable;
+		else if (!flow->queue.empty())
+			if (auto flowAvailable = flow->bucket.available(now))
+				time = std::max(*flowAvailable, *budgetAvailable);
+
+		if (time && (!next || *time < *next))
+			next = time;
+	}
+
+	return next;
+}
+
+PacingEngine &PacingEngine::Instance() {
+	static PacingEngine *instance = new PacingEngine;
+	return *instance;
+}
+
+PacingEngine::PacingEngine() {}
+
+PacingEngine::~PacingEngine() {}
+
+void PacingEngine::setExternal(bool external) {
+	std::unique_lock lock(mMutex);
+	mExternal = external;
+}
+
+void PacingEngine::join() {
+	std::unique_lock lock(mMutex);
+	mScheduled.reset(); // scheduled tasks are cleared with the thread pool
+	if (std::exchange(mStopped, true))
+		return;
+
+	mCondition.notify_all();
+	lock.unlock();
+
+	mThread.join();
+}
+
+shared_ptr<PacingFlow> PacingEngine::add(std::function<void(message_vector &messages)> release,
+                                         double bytesPerSecond, double burstSize) {
+	auto flow = std::make_shared<PacingFlow>();
+	flow->release = std::move(release);
+	flow->bucket.bytesPerSecond = bytesPerSecond;
+	flow->bucket.burstSize = burstSize;
+	flow->bucket.tokens = burstSize;
+
+	std::unique_lock lock(mMutex);
+	auto now = clock::now();
+	flow->bucket.lastRefill = now;
+	mScheduler.add(flow, now);
+
+	// The thread is only started when there is something to pace
+	if (!mExternal && std::exchange(mStopped, false)) {
+		if (mThread.joinable())
+			mThread.join();
+
+		mThread = std::thread(&PacingEngine::runLoop, this);
+	}
+
+	return flow;
+}
+
+void PacingEngine::remove(const shared_ptr<PacingFlow> &flow) {
+	std::unique_lock lock(mMutex);
+	mScheduler.remove(flow, clock::now());
+}
+
+void PacingEngine::setRate(const shared_ptr<PacingFlow> &flow, double bytesPerSecond,
+                           double burstSize) {
+	std::unique_lock lock(mMutex);
+	mScheduler.setRate(flow, bytesPerSecond, burstSize, clock::now());
+	wake(lock);
+}
+
+void PacingEngine::setPriority(const shared_ptr<PacingFlow> &flow, PacingFlow::Priority priority,
+                               std::unordered_set<SSRC> retransmissionSsrcs) {
+	std::unique_lock lock(mMutex);
+	flow->priority = priority;
+	flow->retransmissionSsrcs = std::move(retransmissionSsrcs);
+}
+
+bool PacingEngine::enqueue(const shared_ptr<PacingFlow> &flow, message_vector &messages,
+                           size_t maxQueueSize) {
+	std::unique_lock lock(mMutex);
+	// A packet in an empty queue might be released earlier than the ones already scheduled
+	bool notify = false;
+	for (auto it = messages.begin(); it != messages.end(); ++it) {
+		if (maxQueueSize != 0 &&
+		    flow->queue.size() + flow->retransmissionQueue.size() >= maxQueueSize) {
+			messages.erase(messages.begin(), it);
+			if (notify)
+				wake(lock);
+
+			return false;
+		}
+
+		auto &queue = isRetransmission(*flow, *it) ? flow->retransmissionQueue : flow->queue;
+		notify |= queue.empty();
+		queue.push_back(std::move(*it));
+	}
+
+	messages.clear();
+	if (notify)
+		wake(lock);
+
+	return true;
+}
+
+size_t PacingEngine::queued(const shared_ptr<PacingFlow> &flow) const {
+	std::unique_lock lock(mMutex);
+	return flow->queue.size() + flow->retransmissionQueue.size();
+}
+
+void PacingEngine::runLoop() {
+	utils::this_thread::set_name("RTC pacing");
+	PLOG_DEBUG << "Pacing engine started";
+
+	std::vector<Batch> batches;
+	std::unique_lock lock(mMutex);
+	while (!mStopped) {
+		auto next = mScheduler.process(clock::now(), batches);
+		if (!batches.empty()) {
+			lock.unlock();
+			release(batches);
+			lock.lock();
+			continue;
+		}
+
+		if (next)
+			mCondition.wait_until(lock, *next);
+		else
+			mCondition.wait(lock);
+	}
+
+	PLOG_DEBUG << "Pacing engine stopped";
+}
+
+void PacingEngine::runScheduled(clock::time_point time) {
+	std::vector<Batch> batches;
+	std::unique_lock lock(mMutex);
+	if (mScheduled && *mScheduled == time)
+		mScheduled.reset();
+
+	// Packets due while releasing are left for the next task, so the poll loop is not starved
+	auto next = mScheduler.process(clock::now(), batches);
+	if (next)
+		schedule(lock, *next);
+	else
+		lock.unlock();
+
+	release(batches);
+}
+
+void PacingEngine::wake(std::unique_lock<std::mutex> &lock) {
+	if (mExternal)
+		schedule(lock, clock::now());
+	else
+		mCondition.notify_all();
+}
+
+void PacingEngine::schedule(std::unique_lock<std::mutex> &lock, clock::time_point time) {
+	if (mScheduled && *mScheduled <= time) {
+		lock.unlock();
+		return;
+	}
+
+	mScheduled = time;
+	lock.unlock();
+
+	// The thread pool interrupts the application poll, so it must not be called with mMutex locked
+	ThreadPool::Instance().schedule(time, [this, time]() { runScheduled(time); });
+}
+
+void PacingEngine::release(std::vector<Batch> &batches) {
+	for (auto &[flow, messages] : batches) {
+		try {
+			flow->release(messages);
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "Pacing release failed: " << e.what();
+		}
+	}
+	batches.clear();
+}
+
+} // namespace rtc::impl
+
+#endif
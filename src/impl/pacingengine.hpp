@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_PACING_ENGINE_H
+#define RTC_IMPL_PACING_ENGINE_H
+
+#include "common.hpp"
+#include "internals.hpp"
+#include "message.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtp.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace rtc::impl {
+
+struct TokenBucket {
+	using clock = std::chrono::steady_clock;
+
+	double bytesPerSecond = 0.;
+	double burstSize = 0.; // capacity in bytes
+	double tokens = 0.;
+	clock::time_point lastRefill;
+
+	void refill(clock::time_point now);
+	void setRate(double bytesPerSecond, double burstSize, clock::time_point now);
+
+	// Returns when the bucket will hold tokens, or nullopt if it is never refilled
+	optional<clock::time_point> available(clock::time_point now) const;
+};
+
+// A paced flow, typically the packets of a Track, with its own token bucket
+struct PacingFlow {
+	enum class Priority { Audio, Video };
+
+	std::function<void(message_vector &messages)> release; // called from the pacing thread
+
+	Priority priority = Priority::Video;
+	std::unordered_set<SSRC> retransmissionSsrcs;
+	std::unordered_map<SSRC, uint16_t> lastSequenceNumbers;
+
+	TokenBucket bucket;
+
+	std::deque<message_ptr> queue;
+	std::deque<message_ptr> retransmissionQueue;
+};
+
+// Pacing schedule of flows sharing a budget, refilled at the sum of their rates. Packets are
+// released in priority order: audio, then retransmissions, then video. Audio and retransmissions
+// may exceed the bucket of their flow and only wait for the shared budget, so they delay video
+// of all flows rather than being delayed by it. It is not synchronized.
+class PacingScheduler final {
+public:
+	using clock = std::chrono::steady_clock;
+	using Batch = std::pair<shared_ptr<PacingFlow>, message_vector>;
+
+	void add(shared_ptr<PacingFlow> flow, clock::time_point now);
+	void remove(const shared_ptr<PacingFlow> &flow, clock::time_point now);
+	void setRate(const shared_ptr<PacingFlow> &flow, double bytesPerSecond, double burstSize,
+	             clock::time_point now);
+
+	// Moves packets which may be released at now to batches, and returns when the next packet may
+	// be released, or nullopt if there is none
+	optional<clock::time_point> process(clock::time_point now, std::vector<Batch> &batches);
+
+private:
+	void updateBudget(clock::time_point now);
+
+	std::vector<shared_ptr<PacingFlow>> mFlows;
+	TokenBucket mBudget;
+};
+
+// Shared pacing engine serving all paced flows from a single thread with a precise timer, or from
+// tasks run by the application poll with an external event loop
+class PacingEngine final {
+public:
+	using clock = std::chrono::steady_clock;
+
+	static PacingEngine &Instance();
+
+	PacingEngine(const PacingEngine &) = delete;
+	PacingEngine &operator=(const PacingEngine &) = delete;
+	PacingEngine(PacingEngine &&) = delete;
+	PacingEngine &operator=(PacingEngine &&) = delete;
+
+	void setExternal(bool external); // if external, there is no thread and flows are processed by
+	                                 // thread pool tasks, run when the application polls
+	void join();
+
+	shared_ptr<PacingFlow> add(std::function<void(message_vector &messages)> release,
+	                           double bytesPerSecond, double burstSize);
+	void remove(const shared_ptr<PacingFlow> &flow);
+
+	void setRate(const shared_ptr<PacingFlow> &flow, double bytesPerSecond, double burstSize);
+	void setPriority(const shared_ptr<PacingFlow> &flow, PacingFlow::Priority priority,
+	                 std::unordered_set<SSRC> retransmissionSsrcs);
+
+	// Returns false if the queue is full, in which case the remaining messages are left in place.
+	// RTP packets on retransmission SSRCs or with an already queued sequence number are queued as
+	// retransmissions.
+	bool enqueue(const shared_ptr<PacingFlow> &flow, message_vector &messages, size_t maxQueueSize);
+
+	size_t queued(const shared_ptr<PacingFlow> &flow) const;
+
+private:
+	PacingEngine();
+	~PacingEngine();
+
+	using Batch = PacingScheduler::Batch;
+
+	void runLoop();
+	void runScheduled(clock::time_point time);
+	void wake(std::unique_lock<std::mutex> &lock); // unlocks with an external event loop
+	void schedule(std::unique_lock<std::mutex> &lock, clock::time_point time); // unlocks
+	void release(std::vector<Batch> &batches);
+
+	PacingScheduler mScheduler;
+	std::thread mThread;
+	bool mStopped = true;
+	bool mExternal = false;
+	optional<clock::time_point> mScheduled; // earliest scheduled task with an external event loop
+
+	std::condition_variable mCondition;
+	mutable std::mutex mMutex;
+};
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
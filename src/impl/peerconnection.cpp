@@ -26,7 +26,6 @@
 #include <algorithm>
 #include <array>
 #include <iomanip>
-#include <set>
 #include <sstream>
 #include <thread>
 
@@ -46,6 +45,10 @@ static LogCounter
 
 const string PemBeginCertificateTag = "-----BEGIN CERTIFICATE-----";
 
+const string MidExtensionUri = "urn:ietf:params:rtp-hdrext:sdes:mid";
+const string RidExtensionUri = "urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id";
+const string RepairedRidExtensionUri = "urn:ietf:params:rtp-hdrext:sdes:repaired-rtp-stream-id";
+
 PeerConnection::PeerConnection(Configuration config_) : config(std::move(config_)) {
 	PLOG_VERBOSE << "Creating PeerConnection";
 
@@ -82,6 +85,8 @@ PeerConnection::PeerConnection(Configuration config_) : config(std::move(config_
 PeerConnection::~PeerConnection() {
 	PLOG_VERBOSE << "Destroying PeerConnection";
 	mProcessor.join();
+
+	delete mTrackRoutes.load();
 }
 
 void PeerConnection::close() {
@@ -277,8 +282,9 @@ shared_ptr<DtlsTransport> PeerConnection::initDtlsTransport() {
 
 			// DTLS-SRTP
 			transport = std::make_shared<DtlsSrtpTransport>(
-			    lower, certificate, config.mtu, fingerprintAlgorithm, verifierCallback,
-			    weak_bind(&PeerConnection::forwardMedia, this, _1), dtlsStateChangeCallback);
+			    lower, certificate, config.mtu, fingerprintAlgorithm, config.srtpProfiles,
+			    verifierCallback, weak_bind(&PeerConnection::forwardMedia, this, _1),
+			    dtlsStateChangeCallback, config.srtpWorkers);
 #else
 			PLOG_WARNING << "Ignoring media support (not compiled with media support)";
 #endif
@@ -286,9 +292,9 @@ shared_ptr<DtlsTransport> PeerConnection::initDtlsTransport() {
 
 		if (!transport) {
 			// DTLS only
-			transport = std::make_shared<DtlsTransport>(lower, certificate, config.mtu,
-			                                            fingerprintAlgorithm, verifierCallback,
-			                                            dtlsStateChangeCallback);
+			transport = std::make_shared<DtlsTransport>(
+			    lower, certificate, config.mtu, fingerprintAlgorithm, config.srtpProfiles,
+			    verifierCallback, dtlsStateChangeCallback);
 		}
 
 		return emplaceTransport(this, &mDtlsTransport, std::move(transport));
@@ -528,164 +534,321 @@ void PeerConnection::forwardMessage(message_ptr message) {
 	}
 }
 
-void PeerConnection::forwardMedia([[maybe_unused]] message_ptr message) {
+void PeerConnection::forwardMedia([[maybe_unused]] message_vector messages) {
 #if RTC_ENABLE_MEDIA
-	if (!message)
-		return;
-
 	// TODO: outgoing
 	if (auto handler = getMediaHandler()) {
-		message_vector messages{std::move(message)};
-
+		auto srtpTransport =
+		    std::dynamic_pointer_cast<DtlsSrtpTransport>(std::atomic_load(&mDtlsTransport));
 		try {
-			handler->incomingChain(messages, [this](message_ptr message) {
-				auto transport = std::atomic_load(&mDtlsTransport);
-				if (auto srtpTransport = std::dynamic_pointer_cast<DtlsSrtpTransport>(transport))
-					srtpTransport->send(std::move(message));
+			handler->incomingChain(messages, [srtpTransport](message_ptr message) {
+				if (srtpTransport)
+					srtpTransport->sendMedia(std::move(message));
 			});
 		} catch(const std::exception &e) {
 			PLOG_WARNING << "Exception in global incoming media handler: " << e.what();
 			return;
 		}
-
-		for (auto &m : messages)
-			dispatchMedia(std::move(m));
-
-	} else {
-		dispatchMedia(std::move(message));
 	}
+
+	for (auto &m : messages)
+		dispatchMedia(std::move(m));
 #endif
 }
 
 void PeerConnection::dispatchMedia([[maybe_unused]] message_ptr message) {
 #if RTC_ENABLE_MEDIA
-	std::shared_lock lock(mTracksMutex); // read-only
-	if (mTrackLines.size() == 1) {
-		if (auto track = mTrackLines.front().lock())
+	// Read-only snapshot, no lock is taken on the media path. Registering as a reader before
+	// loading the snapshot prevents it from being freed while in use, see updateTrackRoutes().
+	++mTrackRoutesReaders;
+	scope_guard guard([this]() { --mTrackRoutesReaders; });
+	const TrackRoutes *routes = mTrackRoutes.load();
+	if (!routes)
+		return;
+
+	if (routes->single) {
+		if (auto track = routes->single->lock())
 			track->incoming(message);
 		return;
 	}
-	// Browsers like to compound their packets with a random SSRC.
-	// we have to do this monstrosity to distribute the report blocks
-	if (message->type == Message::Control) {
-		std::set<uint32_t> ssrcs;
-		size_t offset = 0;
-		while (offset + sizeof(RtcpHeader) <= message->size()) {
-			auto header = reinterpret_cast<RtcpHeader *>(message->data() + offset);
-			size_t length = header->lengthInBytes();
-			if (offset + length > message->size()) {
-				COUNTER_MEDIA_TRUNCATED++;
-				break;
+
+	// Browsers like to compound their packets with a random SSRC, so we have to distribute the
+	// packets in the compound to the tracks they concern
+	if (message->type == Message::Control && dispatchRtcp(*routes, message))
+		return;
+
+	uint32_t ssrc = uint32_t(message->stream);
+
+	if (auto it = routes->bySsrc.find(ssrc); it != routes->bySsrc.end()) {
+		if (auto track = it->second.lock())
+			track->incoming(message);
+	} else if (auto track = message->type != Message::Control
+	                            ? findTrackByRtpExtensions(*routes, message)
+	                            : nullptr) {
+		// Unsignaled SSRC, learn the binding so next packets take the fast path
+		learnTrackSsrc(ssrc, track);
+		track->incoming(message);
+	} else {
+		/*
+		 * TODO: So the problem is that when stop sending streams, we stop getting report blocks for
+		 * those streams Therefore when we get compound RTCP packets, they are empty, and we can't
+		 * forward them. Therefore, it is expected that we don't know where to forward packets. Is
+		 * this ideal? No! Do I know how to fix it? No!
+		 */
+		// PLOG_WARNING << "Track not found for SSRC " << ssrc << ", dropping";
+		return;
+	}
+#endif
+}
+
+#if RTC_ENABLE_MEDIA
+
+bool PeerConnection::dispatchRtcp(const TrackRoutes &routes, const message_ptr &message) {
+	// Everything lives on the stack, a message is only allocated for a track which is concerned
+	// by some but not all packets of the compound
+	struct Packet {
+		size_t offset;
+		size_t length;
+		uint32_t targets; // bit mask of indexes in targets
+	};
+	std::array<Packet, MaxCompoundRtcpPackets> packets;
+	std::array<shared_ptr<Track>, MaxCompoundRtcpTargets> targets;
+	size_t packetCount = 0;
+	size_t targetCount = 0;
+	bool overflow = false;
+	std::vector<shared_ptr<Track>> overflowTargets; // past MaxCompoundRtcpTargets
+
+	auto route = [&](Packet &packet, uint32_t ssrc) {
+		auto it = routes.bySsrc.find(ssrc);
+		if (it == routes.bySsrc.end())
+			return;
+
+		auto track = it->second.lock();
+		if (!track)
+			return;
+
+		size_t i = 0;
+		while (i < targetCount && targets[i] != track)
+			++i;
+
+		if (i == targetCount) {
+			if (targetCount == targets.size()) {
+				// Too many tracks for masks, the whole compound packet goes to each of them
+				overflow = true;
+				if (std::find(overflowTargets.begin(), overflowTargets.end(), track) ==
+				    overflowTargets.end())
+					overflowTargets.push_back(std::move(track));
+				return;
 			}
-			switch(header->payloadType()) {
-			case 200: // SR
-				if (length >= sizeof(RtcpSr)) {
-					auto rtcpsr = reinterpret_cast<RtcpSr *>(header);
-					ssrcs.insert(rtcpsr->senderSSRC());
-					for (int i = 0; i < rtcpsr->header.reportCount(); ++i)
-						if (const auto *reportBlock = rtcpsr->getReportBlock(i))
-							ssrcs.insert(reportBlock->getSSRC());
-				}
-				break;
+			targets[targetCount++] = std::move(track);
+		}
+
+		packet.targets |= uint32_t(1) << i;
+	};
 
-			case 201: // RR
-				if (length >= sizeof(RtcpRr)) {
-					auto rtcprr = reinterpret_cast<RtcpRr *>(header);
-					ssrcs.insert(rtcprr->senderSSRC());
-					for (int i = 0; i < rtcprr->header.reportCount(); ++i)
-						if (const auto *reportBlock = rtcprr->getReportBlock(i))
-							ssrcs.insert(reportBlock->getSSRC());
+	size_t offset = 0;
+	while (offset + sizeof(RtcpHeader) <= message->size()) {
+		auto header = reinterpret_cast<const RtcpHeader *>(message->data() + offset);
+		size_t length = header->lengthInBytes();
+		if (offset + length > message->size()) {
+			COUNTER_MEDIA_TRUNCATED++;
+			break;
+		}
+
+		// Past the maximum, packets are still parsed so all their tracks get the whole compound
+		Packet scratch;
+		if (packetCount == packets.size())
+			overflow = true;
+
+		Packet &packet = !overflow ? packets[packetCount++] : scratch;
+		packet.offset = offset;
+		packet.length = length;
+		packet.targets = 0;
+
+		switch (header->payloadType()) {
+		case 200: // SR
+			if (length >= sizeof(RtcpSr)) {
+				auto rtcpsr = reinterpret_cast<const RtcpSr *>(header);
+				route(packet, rtcpsr->senderSSRC());
+				for (int i = 0; i < rtcpsr->header.reportCount(); ++i)
+					if (const auto *reportBlock = rtcpsr->getReportBlock(i))
+						route(packet, reportBlock->getSSRC());
+			}
+			break;
+
+		case 201: // RR
+			if (length >= sizeof(RtcpRr)) {
+				auto rtcprr = reinterpret_cast<const RtcpRr *>(header);
+				route(packet, rtcprr->senderSSRC());
+				for (int i = 0; i < rtcprr->header.reportCount(); ++i)
+					if (const auto *reportBlock = rtcprr->getReportBlock(i))
+						route(packet, reportBlock->getSSRC());
+			}
+			break;
+
+		case 202: // SDES
+			if (length >= sizeof(RtcpSdes)) {
+				auto sdes = reinterpret_cast<const RtcpSdes *>(header);
+				if (!sdes->isValid()) {
+					PLOG_WARNING << "RTCP SDES packet is invalid";
+					break;
 				}
-				break;
+				for (unsigned int i = 0; i < sdes->chunksCount(); i++) {
+					auto chunk = sdes->getChunk(i);
+					route(packet, chunk->ssrc());
+				}
+			}
+			break;
 
-			case 202: // SDES
-				if (length >= sizeof(RtcpSdes)) {
-					auto sdes = reinterpret_cast<RtcpSdes *>(header);
-					if (!sdes->isValid()) {
-						PLOG_WARNING << "RTCP SDES packet is invalid";
-						continue;
-					}
-					for (unsigned int i = 0; i < sdes->chunksCount(); i++) {
-						auto chunk = sdes->getChunk(i);
-						ssrcs.insert(chunk->ssrc());
+		case 205: // FB
+		case 206:
+			if (length >= sizeof(RtcpFbHeader)) {
+				auto rtcpfb = reinterpret_cast<const RtcpFbHeader *>(header);
+				route(packet, rtcpfb->packetSenderSSRC());
+				route(packet, rtcpfb->mediaSourceSSRC());
+				if (header->payloadType() == 206 && header->reportCount() == 15 &&
+				    length >= sizeof(RtcpRemb)) {
+					auto remb = reinterpret_cast<const RtcpRemb *>(header);
+					if (remb->hasValidId())
+						for (int i = 0; i < remb->getSSRCCount(); ++i)
+							route(packet, remb->getSSRC(i));
+				} else if (header->payloadType() == 206 && rtcpfb->header.reportCount() == 4 &&
+				           length >= sizeof(RtcpFir)) {
+					// RFC 5104 FIR (PT=206, FMT=4): have variable number FCIs which is determined by
+					// overall rtcpfb length
+					auto fir = reinterpret_cast<const RtcpFir *>(header);
+					for (int i = 0; i < fir->getFciCount(); i++) {
+						if (const auto *fci = fir->getFci(i))
+							route(packet, fci->getSSRC());
 					}
 				}
-				break;
+			}
+			break;
 
+		case 204: // APP
+			if (length >= RtcpApp::SizeWithData(0)) {
+				auto rtcpapp = reinterpret_cast<const RtcpApp *>(header);
+				route(packet, rtcpapp->ssrc());
+			}
+			break;
 
-			case 205: // FB
-			case 206:
-				if (length >= sizeof(RtcpFbHeader)) {
-					auto rtcpfb = reinterpret_cast<RtcpFbHeader *>(header);
-					ssrcs.insert(rtcpfb->packetSenderSSRC());
-					ssrcs.insert(rtcpfb->mediaSourceSSRC());
-					if (header->payloadType() == 206 && header->reportCount() == 15 &&
-						length >= sizeof(RtcpRemb)) {
-						auto remb = reinterpret_cast<RtcpRemb *>(header);
-						if (remb->hasValidId())
-							for (int i = 0; i < remb->getSSRCCount(); ++i)
-								ssrcs.insert(remb->getSSRC(i));
-					} else if (header->payloadType() == 206 && rtcpfb->header.reportCount() == 4 &&
-						length >= sizeof(RtcpFir)) {
-						// RFC 5104 FIR (PT=206, FMT=4): have variable number FCIs which is determined by
-						// overall rtcpfb length
-						auto fir = reinterpret_cast<const RtcpFir *>(header);
-						for (int i = 0; i < fir->getFciCount(); i++) {
-							if (const auto *fci = fir->getFci(i))
-								ssrcs.insert(fci->getSSRC());
-						}
-					}
-				}
-				break;
+		default:
+			// PT=203 == Goodbye
+			// PT=207 == Extended Report
+			if (header->payloadType() != 203 && header->payloadType() != 207) {
+				COUNTER_UNKNOWN_PACKET_TYPE++;
+			}
+			break;
+		}
 
-			case 204: // APP
-				if (length >= RtcpApp::SizeWithData(0)) {
-					auto rtcpapp = reinterpret_cast<RtcpApp *>(header);
-					ssrcs.insert(rtcpapp->ssrc());
-				}
-				break;
+		offset += length;
+	}
 
-			default:
-				// PT=203 == Goodbye
-				// PT=207 == Extended Report
-				if (header->payloadType() != 203 &&
-				    header->payloadType() != 207) {
-					COUNTER_UNKNOWN_PACKET_TYPE++;
-				}
-				break;
+	if (targetCount == 0)
+		return false;
+
+	if (overflow) {
+		PLOG_VERBOSE << "Compound RTCP packet too large to be split, dispatching it whole";
+		for (size_t i = 0; i < targetCount; ++i)
+			targets[i]->incoming(message);
+
+		for (const auto &track : overflowTargets)
+			track->incoming(message);
+
+		return true;
+	}
+
+	for (size_t i = 0; i < targetCount; ++i) {
+		uint32_t mask = uint32_t(1) << i;
+		size_t size = 0;
+		size_t count = 0;
+		for (size_t j = 0; j < packetCount; ++j) {
+			if (packets[j].targets & mask) {
+				size += packets[j].length;
+				++count;
 			}
-			offset += header->lengthInBytes();
 		}
 
-		if (!ssrcs.empty()) {
-			for (uint32_t ssrc : ssrcs) {
-				if (auto it = mTracksBySsrc.find(ssrc); it != mTracksBySsrc.end()) {
-					if (auto track = it->second.lock())
-						track->incoming(message);
-				}
+		if (count == packetCount) {
+			// The whole compound packet concerns the track
+			targets[i]->incoming(message);
+			continue;
+		}
+
+		auto sub = make_message(size, Message::Control, message->stream);
+		auto it = sub->begin();
+		for (size_t j = 0; j < packetCount; ++j) {
+			if (packets[j].targets & mask) {
+				auto begin = message->begin() + packets[j].offset;
+				it = std::copy(begin, begin + packets[j].length, it);
 			}
-			return;
 		}
+
+		targets[i]->incoming(std::move(sub));
 	}
 
-	uint32_t ssrc = uint32_t(message->stream);
+	return true;
+}
 
-	if (auto it = mTracksBySsrc.find(ssrc); it != mTracksBySsrc.end()) {
-		if (auto track = it->second.lock())
-			track->incoming(message);
-	} else {
-		/*
-		 * TODO: So the problem is that when stop sending streams, we stop getting report blocks for
-		 * those streams Therefore when we get compound RTCP packets, they are empty, and we can't
-		 * forward them. Therefore, it is expected that we don't know where to forward packets. Is
-		 * this ideal? No! Do I know how to fix it? No!
-		 */
-		// PLOG_WARNING << "Track not found for SSRC " << ssrc << ", dropping";
+shared_ptr<Track> PeerConnection::findTrackByRtpExtensions(const TrackRoutes &routes,
+                                                           const message_ptr &message) const {
+	if (!routes.midExtensionId && !routes.ridExtensionId && !routes.repairedRidExtensionId)
+		return nullptr;
+
+	if (message->size() < sizeof(RtpHeader))
+		return nullptr;
+
+	auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+	if (!rtp->extension() || rtp->getSize() + sizeof(RtpExtensionHeader) > message->size() ||
+	    rtp->getBody() > reinterpret_cast<const char *>(message->data() + message->size()))
+		return nullptr;
+
+	auto ext = rtp->getExtensionHeader();
+	auto lookup = [ext](uint8_t id, const std::unordered_map<string, weak_ptr<Track>> &tracks)
+	    -> shared_ptr<Track> {
+		size_t size = 0;
+		auto value = id ? ext->findHeader(id, &size) : nullptr;
+		if (!value || size == 0)
+			return nullptr;
+
+		auto it = tracks.find(string(reinterpret_cast<const char *>(value), size));
+		return it != tracks.end() ? it->second.lock() : nullptr;
+	};
+
+	// The MID identifies the track, the RID identifies the simulcast stream inside the track
+	if (auto track = lookup(routes.midExtensionId, routes.byMid))
+		return track;
+
+	if (auto track = lookup(routes.ridExtensionId, routes.byRid))
+		return track;
+
+	return lookup(routes.repairedRidExtensionId, routes.byRid);
+}
+
+void PeerConnection::learnTrackSsrc(uint32_t ssrc, const shared_ptr<Track> &track) {
+	// Checked before locking since packets on unlearned SSRCs keep coming once the limit is reached
+	if (mLearnedSsrcCount.load() >= MaxLearnedSsrcs) {
+		if (!mLearnedSsrcsWarned.exchange(true))
+			PLOG_WARNING << "Too many unsignaled SSRCs, not learning SSRC " << ssrc
+			             << " nor further ones";
 		return;
 	}
-#endif
+
+	std::unique_lock lock(mTracksMutex); // for safely writing to mTracksBySsrc
+	if (mLearnedSsrcCount.load() >= MaxLearnedSsrcs)
+		return;
+
+	if (!mTracksBySsrc.emplace(ssrc, track).second)
+		return;
+
+	++mLearnedSsrcCount;
+	PLOG_DEBUG << "Learned unsignaled SSRC " << ssrc << " for track, mid=\"" << track->mid()
+	           << "\"";
+	updateTrackRoutes();
 }
 
+#endif
+
 void PeerConnection::forwardBufferedAmount(uint16_t stream, size_t amount) {
 	[[maybe_unused]] auto [channel, found] = findDataChannel(stream);
 	if (channel)
@@ -843,6 +1006,7 @@ shared_ptr<Track> PeerConnection::emplaceTrack(Description::Media description) {
 		track = std::make_shared<Track>(weak_from_this(), std::move(description));
 		mTracks.emplace(track->mid(), track);
 		mTrackLines.emplace_back(track);
+		updateTrackRoutes();
 	}
 
 	auto handler = getMediaHandler();
@@ -1159,6 +1323,7 @@ void PeerConnection::processRemoteDescription(Description description) {
 			auto track = std::make_shared<Track>(weak_from_this(), std::move(reciprocated));
 			mTracks.emplace(track->mid(), track);
 			mTrackLines.emplace_back(track);
+			updateTrackRoutes();
 			triggerTrack(track); // The user may modify the track description
 
 			auto handler = getMediaHandler();
@@ -1452,6 +1617,28 @@ void PeerConnection::updateTrackSsrcCache(const Description &description) {
 		    rtc::overloaded{
 		        [&](Description::Application const *) { return; },
 		        [&](Description::Media const *media) {
+			        for (int id : media->extIds()) {
+				        if (auto extMap = media->extMap(id)) {
+					        if (extMap->uri == MidExtensionUri)
+						        mMidExtensionId = uint8_t(id);
+					        else if (extMap->uri == RidExtensionUri)
+						        mRidExtensionId = uint8_t(id);
+					        else if (extMap->uri == RepairedRidExtensionUri)
+						        mRepairedRidExtensionId = uint8_t(id);
+				        }
+			        }
+
+			        if (auto rids = media->rids(); !rids.empty()) {
+				        if (auto it = mTracks.find(media->mid()); it != mTracks.end()) {
+					        for (const auto &rid : rids) {
+						        // A RID only identifies a track if it is unique
+						        auto [ridIt, inserted] = mTracksByRid.emplace(rid.rid(), it->second);
+						        if (!inserted && ridIt->second.lock() != it->second.lock())
+							        ridIt->second.reset();
+					        }
+				        }
+			        }
+
 			        const auto ssrcs = media->getSSRCs();
 
 			        // Note: We don't want to lock (or do any other lookups), if we
@@ -1476,6 +1663,32 @@ void PeerConnection::updateTrackSsrcCache(const Description &description) {
 		        },
 		    },
 		    description.media(i));
+
+	updateTrackRoutes();
+}
+
+void PeerConnection::updateTrackRoutes() {
+	// mTracksMutex must be locked
+
+	// Routes are copied on write since they are read for every media packet and rarely change
+	auto routes = std::make_unique<TrackRoutes>();
+	routes->bySsrc = mTracksBySsrc;
+	if (mTrackLines.size() == 1)
+		routes->single = mTrackLines.front();
+
+	routes->byMid.insert(mTracks.begin(), mTracks.end());
+	routes->byRid = mTracksByRid;
+	routes->midExtensionId = mMidExtensionId;
+	routes->ridExtensionId = mRidExtensionId;
+	routes->repairedRidExtensionId = mRepairedRidExtensionId;
+
+	if (const TrackRoutes *previous = mTrackRoutes.exchange(routes.release()))
+		mRetiredTrackRoutes.emplace_back(previous);
+
+	// A reader loads the snapshot after registering, so if there is no reader now, later readers
+	// will get the new snapshot and no reader can hold a retired one.
+	if (mTrackRoutesReaders.load() == 0)
+		mRetiredTrackRoutes.clear();
 }
 
 } // namespace rtc::impl
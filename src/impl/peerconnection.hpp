@@ -55,7 +55,7 @@ struct PeerConnection : std::enable_shared_from_this<PeerConnection> {
 	void rollbackLocalDescription();
 	bool checkFingerprint(const std::string &fingerprint);
 	void forwardMessage(message_ptr message);
-	void forwardMedia(message_ptr message);
+	void forwardMedia(message_vector messages);
 	void forwardBufferedAmount(uint16_t stream, size_t amount);
 
 	shared_ptr<DataChannel> emplaceDataChannel(string label, DataChannelInit init);
@@ -132,8 +132,31 @@ struct PeerConnection : std::enable_shared_from_this<PeerConnection> {
 	synchronized_callback<shared_ptr<rtc::Track>> trackCallback;
 
 private:
+	struct TrackRoutes {
+		std::unordered_map<uint32_t, weak_ptr<Track>> bySsrc;
+		optional<weak_ptr<Track>> single; // set if there is a single track
+
+		// RFC 8843 and RFC 8852 routing for unsignaled SSRCs
+		std::unordered_map<string, weak_ptr<Track>> byMid;
+		std::unordered_map<string, weak_ptr<Track>> byRid;
+		uint8_t midExtensionId = 0;
+		uint8_t ridExtensionId = 0;
+		uint8_t repairedRidExtensionId = 0;
+	};
+
+	static const size_t MaxCompoundRtcpPackets = 64;
+	static const size_t MaxCompoundRtcpTargets = 32; // must fit in a 32-bit mask
+	static const size_t MaxLearnedSsrcs = 256;
+
 	void dispatchMedia(message_ptr message);
+#if RTC_ENABLE_MEDIA
+	bool dispatchRtcp(const TrackRoutes &routes, const message_ptr &message);
+	shared_ptr<Track> findTrackByRtpExtensions(const TrackRoutes &routes,
+	                                           const message_ptr &message) const;
+	void learnTrackSsrc(uint32_t ssrc, const shared_ptr<Track> &track);
+#endif
 	void updateTrackSsrcCache(const Description &description);
+	void updateTrackRoutes();
 
 	const init_token mInitToken = Init::Instance().token();
 	future_certificate_ptr mCertificate;
@@ -163,6 +186,18 @@ private:
 	std::unordered_map<uint32_t, weak_ptr<Track>> mTracksBySsrc; // by SSRC
 	std::vector<weak_ptr<Track>> mTrackLines;                    // by SDP order
 	mutable std::shared_mutex mTracksMutex;
+	std::unordered_map<string, weak_ptr<Track>> mTracksByRid;    // by RID, if unique
+	uint8_t mMidExtensionId = 0;
+	uint8_t mRidExtensionId = 0;
+	uint8_t mRepairedRidExtensionId = 0;
+	std::atomic<size_t> mLearnedSsrcCount = 0; // written under mTracksMutex
+	std::atomic<bool> mLearnedSsrcsWarned = false;
+
+	// Read-only snapshot for the media path, swapped atomically. Replaced snapshots are retired
+	// and freed by a later update once no reader is active.
+	std::atomic<const TrackRoutes *> mTrackRoutes = nullptr;
+	std::atomic<unsigned int> mTrackRoutesReaders = 0;
+	std::vector<unique_ptr<const TrackRoutes>> mRetiredTrackRoutes; // under mTracksMutex
 
 	Queue<shared_ptr<DataChannel>> mPendingDataChannels;
 	Queue<shared_ptr<Track>> mPendingTracks;
@@ -30,27 +30,36 @@ PollService::PollService() : mStopped(true) {}
 
 PollService::~PollService() {}
 
-void PollService::start() {
+void PollService::start(bool external) {
 	mSocks = std::make_unique<SocketMap>();
 	mInterrupter = std::make_unique<PollInterrupter>();
+	mExternal = external;
 	mStopped = false;
-	mThread = std::thread(&PollService::runLoop, this);
+	if (external)
+		PLOG_DEBUG << "Poll service started for an external event loop";
+	else
+		mThread = std::thread(&PollService::runLoop, this);
 }
 
 void PollService::join() {
 	std::unique_lock lock(mMutex);
-	if (std::exchange(mStopped, true))
+	if (mStopped.exchange(true))
 		return;
 
 	lock.unlock();
 
 	mInterrupter->interrupt();
-	mThread.join();
+	if (mThread.joinable())
+		mThread.join();
 
+	std::lock_guard externalLock(mExternalMutex); // wait for the application to exit poll()
+	lock.lock();
 	mSocks.reset();
 	mInterrupter.reset();
 }
 
+bool PollService::isExternal() const { return mExternal; }
+
 void PollService::add(socket_t sock, Params params) {
 	assert(sock != INVALID_SOCKET);
 	assert(params.callback);
@@ -77,6 +86,38 @@ void PollService::remove(socket_t sock) {
 	mInterrupter->interrupt();
 }
 
+bool PollService::isPollThread() const { return std::this_thread::get_id() == mThreadId.load(); }
+
+int PollService::poll(optional<clock::duration> timeout) {
+	if (!mExternal)
+		throw std::logic_error("Poll service is not external");
+
+	std::lock_guard lock(mExternalMutex);
+	if (mStopped)
+		return 0;
+
+	// The thread running the external event loop is considered the poll thread
+	mThreadId = std::this_thread::get_id();
+	return iterate(mExternalPollFds, timeout);
+}
+
+void PollService::descriptors(std::vector<struct pollfd> &pfds, optional<clock::time_point> &next) {
+	std::unique_lock lock(mMutex);
+	if (mStopped) {
+		pfds.clear();
+		next.reset();
+		return;
+	}
+
+	prepare(pfds, next);
+}
+
+void PollService::interrupt() {
+	std::unique_lock lock(mMutex);
+	if (!mStopped)
+		mInterrupter->interrupt();
+}
+
 void PollService::prepare(std::vector<struct pollfd> &pfds, optional<clock::time_point> &next) {
 	std::unique_lock lock(mMutex);
 	pfds.resize(1 + mSocks->size());
@@ -104,7 +145,7 @@ void PollService::prepare(std::vector<struct pollfd> &pfds, optional<clock::time
 	}
 }
 
-void PollService::process(std::vector<struct pollfd> &pfds) {
+int PollService::process(std::vector<struct pollfd> &pfds) {
 	using Callback = decltype(std::declval<Params>().callback);
 	std::vector<std::pair<Callback, Event>> todo;
 	{
@@ -163,48 +204,57 @@ void PollService::process(std::vector<struct pollfd> &pfds) {
 	for (auto &[callback, event] : todo) {
 		callback(event);
 	}
+
+	return int(todo.size());
 }
 
-void PollService::runLoop() {
-	utils::this_thread::set_name("RTC poll");
-	PLOG_DEBUG << "Poll service started";
+int PollService::iterate(std::vector<struct pollfd> &pfds, optional<clock::duration> timeout) {
+	optional<clock::time_point> next;
+	prepare(pfds, next);
+
+	int ret;
+	do {
+		int msecs = -1;
+		if (next) {
+			auto remaining = duration_cast<milliseconds>(
+			    std::max(clock::duration::zero(), *next - clock::now() + 1ms));
+			msecs = static_cast<int>(remaining.count());
+		}
+		if (timeout) {
+			auto limit = static_cast<int>(
+			    duration_cast<milliseconds>(std::max(clock::duration::zero(), *timeout)).count());
+			msecs = msecs >= 0 ? std::min(msecs, limit) : limit;
+		}
 
-	try {
-		assert(mSocks);
-		std::vector<struct pollfd> pfds;
-		optional<clock::time_point> next;
-		while (!mStopped) {
-			prepare(pfds, next);
-
-			int ret;
-			do {
-				int timeout;
-				if (next) {
-					auto msecs = duration_cast<milliseconds>(
-					    std::max(clock::duration::zero(), *next - clock::now() + 1ms));
-					PLOG_VERBOSE << "Entering poll, timeout=" << msecs.count() << "ms";
-					timeout = static_cast<int>(msecs.count());
-				} else {
-					PLOG_VERBOSE << "Entering poll";
-					timeout = -1;
-				}
+		PLOG_VERBOSE << "Entering poll, timeout=" << msecs << "ms";
 
-				ret = ::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), timeout);
+		ret = ::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), msecs);
 
-				PLOG_VERBOSE << "Exiting poll";
+		PLOG_VERBOSE << "Exiting poll";
 
-			} while (ret < 0 && (sockerrno == SEINTR || sockerrno == SEAGAIN));
+	} while (ret < 0 && (sockerrno == SEINTR || sockerrno == SEAGAIN));
 
-			if (ret < 0) {
+	if (ret < 0) {
 #ifdef _WIN32
-				if (sockerrno == WSAENOTSOCK)
-					continue; // prepare again as the fd has been removed
+		if (sockerrno == WSAENOTSOCK)
+			return 0; // prepare again as the fd has been removed
 #endif
-				throw std::runtime_error("poll failed, errno=" + std::to_string(sockerrno));
-			}
+		throw std::runtime_error("poll failed, errno=" + std::to_string(sockerrno));
+	}
 
-			process(pfds);
-		}
+	return process(pfds);
+}
+
+void PollService::runLoop() {
+	utils::this_thread::set_name("RTC poll");
+	mThreadId = std::this_thread::get_id();
+	PLOG_DEBUG << "Poll service started";
+
+	try {
+		assert(mSocks);
+		std::vector<struct pollfd> pfds;
+		while (!mStopped)
+			iterate(pfds, nullopt);
 	} catch (const std::exception &e) {
 		PLOG_FATAL << "Poll service failed: " << e.what();
 	}
@@ -16,6 +16,7 @@
 
 #if RTC_ENABLE_WEBSOCKET
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <mutex>
@@ -36,8 +37,9 @@ public:
 	PollService(PollService &&) = delete;
 	PollService &operator=(PollService &&) = delete;
 
-	void start();
+	void start(bool external = false); // if external, there is no thread and poll() is called
 	void join();
+	bool isExternal() const;
 
 	enum class Direction { Both, In, Out };
 	enum class Event { None, Error, Timeout, In, Out };
@@ -51,12 +53,20 @@ public:
 	void add(socket_t sock, Params params);
 	void remove(socket_t sock);
 
+	bool isPollThread() const; // waiting for socket events in the poll thread would deadlock
+
+	// For an external event loop
+	int poll(optional<clock::duration> timeout); // returns the number of processed events
+	void descriptors(std::vector<struct pollfd> &pfds, optional<clock::time_point> &next);
+	void interrupt();
+
 private:
 	PollService();
 	~PollService();
 
 	void prepare(std::vector<struct pollfd> &pfds, optional<clock::time_point> &next);
-	void process(std::vector<struct pollfd> &pfds);
+	int process(std::vector<struct pollfd> &pfds);
+	int iterate(std::vector<struct pollfd> &pfds, optional<clock::duration> timeout);
 	void runLoop();
 
 	struct SocketEntry {
@@ -70,7 +80,12 @@ private:
 
 	std::recursive_mutex mMutex;
 	std::thread mThread;
-	bool mStopped;
+	std::atomic<std::thread::id> mThreadId;
+	std::atomic<bool> mStopped;
+	bool mExternal = false;
+
+	std::vector<struct pollfd> mExternalPollFds;
+	std::mutex mExternalMutex; // held while the application polls
 };
 
 std::ostream &operator<<(std::ostream &out, PollService::Direction direction);
@@ -10,12 +10,22 @@
 
 namespace rtc::impl {
 
+using namespace std::chrono_literals;
+
 Processor::Processor(size_t limit) : mTasks(limit) {}
 
 Processor::~Processor() { join(); }
 
 void Processor::join() {
 	std::unique_lock lock(mMutex);
+
+	// With an external event loop, tasks must be run here if joining from the loop thread
+	while (ThreadPool::Instance().isPollThread() && (mPending || !mTasks.empty())) {
+		lock.unlock();
+		ThreadPool::Instance().poll(ThreadPool::clock::now() + 10ms);
+		lock.lock();
+	}
+
 	mCondition.wait(lock, [this]() { return !mPending && mTasks.empty(); });
 }
 
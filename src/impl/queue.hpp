@@ -34,15 +34,17 @@ public:
 	size_t size() const;   // elements
 	size_t amount() const; // amount
 	void push(T element);
-	bool tryPush(T element);
+	optional<size_t> tryPush(T element); // returns the new size, or nullopt if full
 	optional<T> pop();
 	optional<T> peek();
 	optional<T> exchange(T element);
+	void shrink(); // releases the storage if empty, typically once idle
 
 private:
 	const size_t mLimit;
 	size_t mAmount;
-	std::queue<T> mQueue;
+	optional<std::queue<T>> mQueue; // allocated on first push and released by shrink(), as an
+	                                // empty deque is not free
 	std::condition_variable mPushCondition;
 	amount_function mAmountFunction;
 	bool mStopping = false;
@@ -65,22 +67,22 @@ template <typename T> void Queue<T>::stop() {
 
 template <typename T> bool Queue<T>::running() const {
 	std::lock_guard lock(mMutex);
-	return !mQueue.empty() || !mStopping;
+	return (mQueue && !mQueue->empty()) || !mStopping;
 }
 
 template <typename T> bool Queue<T>::empty() const {
 	std::lock_guard lock(mMutex);
-	return mQueue.empty();
+	return !mQueue || mQueue->empty();
 }
 
 template <typename T> bool Queue<T>::full() const {
 	std::lock_guard lock(mMutex);
-	return mLimit > 0 && mQueue.size() >= mLimit;
+	return mLimit > 0 && mQueue && mQueue->size() >= mLimit;
 }
 
 template <typename T> size_t Queue<T>::size() const {
 	std::lock_guard lock(mMutex);
-	return mQueue.size();
+	return mQueue ? mQueue->size() : 0;
 }
 
 template <typename T> size_t Queue<T>::amount() const {
@@ -90,50 +92,64 @@ template <typename T> size_t Queue<T>::amount() const {
 
 template <typename T> void Queue<T>::push(T element) {
 	std::unique_lock lock(mMutex);
-	mPushCondition.wait(lock, [this]() { return mLimit == 0 || mQueue.size() < mLimit || mStopping; });
+	mPushCondition.wait(lock, [this]() {
+		return mLimit == 0 || !mQueue || mQueue->size() < mLimit || mStopping;
+	});
 	if (mStopping)
 		return;
 
+	if (!mQueue)
+		mQueue.emplace();
+
 	mAmount += mAmountFunction(element);
-	mQueue.emplace(std::move(element));
+	mQueue->emplace(std::move(element));
 }
 
-template <typename T> bool Queue<T>::tryPush(T element) {
+template <typename T> optional<size_t> Queue<T>::tryPush(T element) {
 	std::unique_lock lock(mMutex);
-	if ((mLimit > 0 && mQueue.size() >= mLimit) || mStopping)
-		return false;
+	if ((mLimit > 0 && mQueue && mQueue->size() >= mLimit) || mStopping)
+		return nullopt;
+
+	if (!mQueue)
+		mQueue.emplace();
 
 	mAmount += mAmountFunction(element);
-	mQueue.emplace(std::move(element));
-	return true;
+	mQueue->emplace(std::move(element));
+	return mQueue->size();
 }
 
 template <typename T> optional<T> Queue<T>::pop() {
 	std::unique_lock lock(mMutex);
-	if (mQueue.empty())
+	if (!mQueue || mQueue->empty())
 		return nullopt;
 
-	mAmount -= mAmountFunction(mQueue.front());
-	optional<T> element{std::move(mQueue.front())};
-	mQueue.pop();
+	mAmount -= mAmountFunction(mQueue->front());
+	optional<T> element{std::move(mQueue->front())};
+	mQueue->pop();
 	mPushCondition.notify_one();
 	return element;
 }
 
 template <typename T> optional<T> Queue<T>::peek() {
 	std::unique_lock lock(mMutex);
-	return !mQueue.empty() ? std::make_optional(mQueue.front()) : nullopt;
+	return mQueue && !mQueue->empty() ? std::make_optional(mQueue->front()) : nullopt;
 }
 
 template <typename T> optional<T> Queue<T>::exchange(T element) {
 	std::unique_lock lock(mMutex);
-	if (mQueue.empty())
+	if (!mQueue || mQueue->empty())
 		return nullopt;
 
-	std::swap(mQueue.front(), element);
+	std::swap(mQueue->front(), element);
 	return std::make_optional(std::move(element));
 }
 
+template <typename T> void Queue<T>::shrink() {
+	std::unique_lock lock(mMutex);
+	if (mQueue && mQueue->empty())
+		mQueue.reset();
+}
+
 } // namespace rtc::impl
 
 #endif
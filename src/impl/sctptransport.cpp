@@ -952,6 +952,13 @@ size_t SctpTransport::bytesSent() { return mBytesSent; }
 size_t SctpTransport::bytesReceived() { return mBytesReceived; }
 
 optional<milliseconds> SctpTransport::rtt() {
+	if (auto s = status())
+		return s->rtt;
+
+	return nullopt;
+}
+
+optional<SctpTransport::Status> SctpTransport::status() {
 	if (state() != State::Connected)
 		return nullopt;
 
@@ -960,7 +967,12 @@ optional<milliseconds> SctpTransport::rtt() {
 	if (usrsctp_getsockopt(mSock, IPPROTO_SCTP, SCTP_STATUS, &status, &len))
 		return nullopt;
 
-	return milliseconds(status.sstat_primary.spinfo_srtt);
+	Status result;
+	result.rtt = milliseconds(status.sstat_primary.spinfo_srtt);
+	result.rto = milliseconds(status.sstat_primary.spinfo_rto);
+	result.congestionWindow = size_t(status.sstat_primary.spinfo_cwnd);
+	result.unackedChunks = size_t(status.sstat_unackdata);
+	return result;
 }
 
 void SctpTransport::UpcallCallback(struct socket *, void *arg, int /* flags */) {
@@ -60,6 +60,14 @@ public:
 	size_t bytesReceived();
 	optional<std::chrono::milliseconds> rtt();
 
+	struct Status {
+		std::chrono::milliseconds rtt;
+		std::chrono::milliseconds rto;
+		size_t congestionWindow;
+		size_t unackedChunks;
+	};
+	optional<Status> status(); // nullopt if not connected
+
 private:
 	// Order seems wrong but these are the actual values
 	// See https://datatracker.ietf.org/doc/html/draft-ietf-rtcweb-data-channel-13#section-8
@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "srtppipeline.hpp"
+#include "internals.hpp"
+#include "rtp.hpp"
+
+
+#if RTC_ENABLE_MEDIA
+
+using std::to_integer;
+using std::to_string;
+
+namespace rtc::impl {
+
+namespace {
+
+// SSRC of the stream, which is not encrypted in SRTP and SRTCP packets
+SSRC streamOf(const message_ptr &message) {
+	size_t offset = IsRtcp(*message) ? 4 : 8; // sender SSRC for RTCP
+	if (message->size() < offset + 4)
+		return 0;
+
+	SSRC ssrc = 0;
+	for (size_t i = 0; i < 4; ++i)
+		ssrc = (ssrc << 8) | to_integer<uint8_t>((*message)[offset + i]);
+
+	return ssrc;
+}
+
+} // namespace
+
+SrtpPipeline::SrtpPipeline(size_t shards, process_callback process, deliver_callback deliver)
+    : mProcess(std::move(process)), mDeliver(std::move(deliver)) {
+	if (shards == 0)
+		throw std::invalid_argument("SRTP pipeline needs at least one shard");
+
+	mShards.reserve(shards);
+	for (size_t i = 0; i < shards; ++i) {
+		auto shard = std::make_unique<Shard>();
+		if (srtp_err_status_t err = srtp_create(&shard->session, nullptr))
+			throw std::runtime_error("srtp_create failed, status=" +
+			                         to_string(static_cast<int>(err)));
+
+		mShards.push_back(std::move(shard));
+	}
+}
+
+SrtpPipeline::~SrtpPipeline() {
+	join();
+
+	for (auto &shard : mShards)
+		srtp_dealloc(shard->session);
+}
+
+size_t SrtpPipeline::shardCount() const { return mShards.size(); }
+
+void SrtpPipeline::addStream(const srtp_policy_t &policy) {
+	for (auto &shard : mShards) {
+		srtp_policy_t copy = policy; // libSRTP does not take the policy as const
+		copy.next = nullptr;
+		if (srtp_err_status_t err = srtp_add_stream(shard->session, &copy))
+			throw std::runtime_error("SRTP add stream failed, status=" +
+			                         to_string(static_cast<int>(err)));
+	}
+}
+
+void SrtpPipeline::push(message_ptr message) {
+	auto &shard = shardOf(message);
+	std::lock_guard lock(shard.mutex);
+	enqueue(shard, std::move(message));
+	schedule(shard);
+}
+
+void SrtpPipeline::push(message_vector &messages) {
+	// Packets of a frame usually share the same SSRC, so lock each shard once per run
+	auto it = messages.begin();
+	while (it != messages.end()) {
+		auto &shard = shardOf(*it);
+		std::lock_guard lock(shard.mutex);
+		do {
+			enqueue(shard, std::move(*it++));
+		} while (it != messages.end() && &shardOf(*it) == &shard);
+
+		schedule(shard);
+	}
+	messages.clear();
+}
+
+void SrtpPipeline::join() {
+	for (auto &shard : mShards)
+		shard->processor.join();
+}
+
+SrtpPipeline::Shard &SrtpPipeline::shardOf(const message_ptr &message) {
+	return *mShards[streamOf(message) % mShards.size()];
+}
+
+void SrtpPipeline::enqueue(Shard &shard, message_ptr message) {
+	// The sequence number only orders the delivery, shards may process messages in any order
+	uint64_t sequence = mNextSequence.fetch_add(1, std::memory_order_relaxed);
+	shard.pending.push_back(Pending{sequence, std::move(message)});
+}
+
+void SrtpPipeline::schedule(Shard &shard) {
+	if (!shard.draining && !shard.pending.empty()) {
+		shard.draining = true;
+		shard.processor.enqueue(&SrtpPipeline::drain, this, &shard);
+	}
+}
+
+void SrtpPipeline::drain(Shard *shard) {
+	std::vector<Pending> batch;
+	while (true) {
+		{
+			std::lock_guard lock(shard->mutex);
+			batch.clear();
+			batch.swap(shard->pending);
+			if (batch.empty()) {
+				shard->draining = false;
+				return;
+			}
+		}
+
+		// The session is only used by the draining task, so it is not locked
+		for (auto &p : batch) {
+			try {
+				if (!mProcess(shard->session, p.message))
+					p.message.reset();
+
+			} catch (const std::exception &e) {
+				PLOG_WARNING << e.what();
+				p.message.reset();
+			}
+		}
+
+		complete(batch);
+	}
+}
+
+void SrtpPipeline::complete(std::vector<Pending> &batch) {
+	std::unique_lock lock(mDeliveryMutex);
+	for (auto &p : batch) {
+		size_t index = size_t(p.sequence - mDeliverySequence);
+		if (index >= mReorder.size())
+			mReorder.resize(index + 1);
+
+		mReorder[index].done = true;
+		mReorder[index].message = std::move(p.message);
+	}
+
+	// If another task is delivering, it will pick up the messages
+	if (mDelivering)
+		return;
+
+	mDelivering = true;
+	message_vector messages;
+	while (true) {
+		while (!mReorder.empty() && mReorder.front().done) {
+			if (auto &message = mReorder.front().message)
+				messages.push_back(std::move(message));
+
+			mReorder.pop_front();
+			++mDeliverySequence;
+		}
+
+		if (messages.empty()) {
+			mDelivering = false;
+			return;
+		}
+
+		lock.unlock();
+		try {
+			mDeliver(messages);
+		} catch (const std::exception &e) {
+			PLOG_WARNING << e.what();
+		}
+		messages.clear();
+		lock.lock();
+	}
+}
+
+} // namespace rtc::impl
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef RTC_IMPL_SRTP_PIPELINE_H
+#define RTC_IMPL_SRTP_PIPELINE_H
+
+#include "common.hpp"
+#include "message.hpp"
+#include "processor.hpp"
+
+#if RTC_ENABLE_MEDIA
+
+#if RTC_SYSTEM_SRTP
+#include <srtp2/srtp.h>
+#else
+#include "srtp.h"
+#endif
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rtc::impl {
+
+// Runs SRTP crypto on the thread pool. Packets are sharded by SSRC over separate libSRTP sessions
+// sharing the same policies, so different SSRCs are processed in parallel while packets of the
+// same SSRC are processed in order by a single session, which keeps the rollover counter and the
+// replay window consistent and never reuses a keystream. Packets queued while a shard is busy are
+// processed as a batch by the same task.
+// Processed packets are then put back in push order and delivered by one task at a time, so the
+// receiver never sees concurrent calls, for instance for a track with simulcast or RTX SSRCs.
+class SrtpPipeline final {
+public:
+	// Processes a message with the session of its shard, returns false or throws to drop it
+	using process_callback = std::function<bool(srtp_t session, message_ptr &message)>;
+	// Delivers processed messages in push order, calls are serialized, exceptions are logged
+	using deliver_callback = std::function<void(message_vector &messages)>;
+
+	SrtpPipeline(size_t shards, process_callback process, deliver_callback deliver);
+	~SrtpPipeline();
+
+	SrtpPipeline(const SrtpPipeline &) = delete;
+	SrtpPipeline &operator=(const SrtpPipeline &) = delete;
+
+	size_t shardCount() const;
+	void addStream(const srtp_policy_t &policy); // to all sessions, before pushing messages
+	void push(message_ptr message);
+	void push(message_vector &messages); // consumes the messages
+	void join();
+
+private:
+	struct Pending {
+		uint64_t sequence;
+		message_ptr message;
+	};
+
+	struct Shard {
+		srtp_t session = nullptr;
+		std::vector<Pending> pending;
+		bool draining = false;
+		std::mutex mutex;
+		Processor processor;
+	};
+
+	struct Processed {
+		bool done = false;
+		message_ptr message; // null if dropped
+	};
+
+	Shard &shardOf(const message_ptr &message);
+	void enqueue(Shard &shard, message_ptr message); // shard must be locked
+	void schedule(Shard &shard);                     // shard must be locked
+	void drain(Shard *shard);
+	void complete(std::vector<Pending> &batch);
+
+	const process_callback mProcess;
+	const deliver_callback mDeliver;
+	std::vector<std::unique_ptr<Shard>> mShards;
+	std::atomic<uint64_t> mNextSequence = 0;
+
+	std::mutex mDeliveryMutex;
+	std::deque<Processed> mReorder; // front is the message with sequence mDeliverySequence
+	uint64_t mDeliverySequence = 0;
+	bool mDelivering = false;
+};
+
+} // namespace rtc::impl
+
+#endif
+
+#endif
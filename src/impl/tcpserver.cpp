@@ -8,6 +8,7 @@
 
 #include "tcpserver.hpp"
 #include "internals.hpp"
+#include "pollservice.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
@@ -21,9 +22,18 @@
 
 namespace rtc::impl {
 
-TcpServer::TcpServer(uint16_t port, const char *bindAddress) {
+bool TcpServer::IsReusePortSupported() {
+	// Only Linux balances incoming connections between SO_REUSEPORT listeners
+#if defined(__linux__) && defined(SO_REUSEPORT)
+	return true;
+#else
+	return false;
+#endif
+}
+
+TcpServer::TcpServer(uint16_t port, const char *bindAddress, bool reusePort) {
 	PLOG_DEBUG << "Initializing TCP server";
-	listen(port, bindAddress);
+	listen(port, bindAddress, reusePort);
 }
 
 TcpServer::~TcpServer() { close(); }
@@ -60,40 +70,72 @@ shared_ptr<TcpTransport> TcpServer::accept() {
 			throw std::runtime_error("Invalid socket");
 		}
 
-		if (pfd[1].revents & POLLIN || pfd[1].revents & POLLERR) {
-			struct sockaddr_storage addr;
-			socklen_t addrlen = sizeof(addr);
-			socket_t incomingSock = ::accept(mSock, (struct sockaddr *)&addr, &addrlen);
-
-			if (incomingSock != INVALID_SOCKET) {
-				try {
-					return std::make_shared<TcpTransport>(incomingSock, nullptr); // no state callback
-				} catch(const std::exception &e) {
-					PLOG_WARNING << e.what();
-					::closesocket(incomingSock);
-				}
-			} else if (sockerrno != SEAGAIN && sockerrno != SEWOULDBLOCK) {
-				PLOG_ERROR << "TCP server failed, errno=" << sockerrno;
-				throw std::runtime_error("TCP server failed");
-			}
-		}
+		if (pfd[1].revents & POLLIN || pfd[1].revents & POLLERR)
+			if (auto incoming = acceptPending())
+				return incoming;
 	}
 
 	PLOG_DEBUG << "TCP server closed";
 	return nullptr;
 }
 
+shared_ptr<TcpTransport> TcpServer::tryAccept() {
+	std::unique_lock lock(mSockMutex);
+	return mSock != INVALID_SOCKET ? acceptPending() : nullptr;
+}
+
 void TcpServer::close() {
 	std::unique_lock lock(mSockMutex);
 	if (mSock != INVALID_SOCKET) {
 		PLOG_DEBUG << "Closing TCP server socket";
+		if (std::exchange(mPolled, false))
+			PollService::Instance().remove(mSock);
+
 		::closesocket(mSock);
 		mSock = INVALID_SOCKET;
 		mInterrupter.interrupt();
 	}
 }
 
-void TcpServer::listen(uint16_t port, const char *bindAddress) {
+void TcpServer::setPendingCallback(std::function<void()> callback) {
+	std::unique_lock lock(mSockMutex);
+	if (mSock == INVALID_SOCKET)
+		throw std::logic_error("TCP server is closed");
+
+	PollService::Instance().add(
+	    mSock, {PollService::Direction::In, nullopt,
+	            [callback = std::move(callback)](PollService::Event event) {
+		            if (event == PollService::Event::In)
+			            callback();
+		            else
+			            PLOG_ERROR << "TCP server failed while polling";
+	            }});
+
+	mPolled = true;
+}
+
+shared_ptr<TcpTransport> TcpServer::acceptPending() {
+	// mSockMutex must be locked
+	struct sockaddr_storage addr;
+	socklen_t addrlen = sizeof(addr);
+	socket_t incomingSock = ::accept(mSock, (struct sockaddr *)&addr, &addrlen);
+
+	if (incomingSock != INVALID_SOCKET) {
+		try {
+			return std::make_shared<TcpTransport>(incomingSock, nullptr); // no state callback
+		} catch(const std::exception &e) {
+			PLOG_WARNING << e.what();
+			::closesocket(incomingSock);
+		}
+	} else if (sockerrno != SEAGAIN && sockerrno != SEWOULDBLOCK) {
+		PLOG_ERROR << "TCP server failed, errno=" << sockerrno;
+		throw std::runtime_error("TCP server failed");
+	}
+
+	return nullptr;
+}
+
+void TcpServer::listen(uint16_t port, const char *bindAddress, bool reusePort) {
 	PLOG_DEBUG << "Listening on port " << port;
 
 	struct addrinfo hints = {};
@@ -134,6 +176,18 @@ void TcpServer::listen(uint16_t port, const char *bindAddress) {
 		::setsockopt(mSock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&enabled),
 		             sizeof(enabled));
 
+		// Enable REUSEPORT so several listeners share the port
+		if (reusePort) {
+			if (!IsReusePortSupported())
+				throw std::logic_error("SO_REUSEPORT is not supported");
+
+#ifdef SO_REUSEPORT
+			if (::setsockopt(mSock, SOL_SOCKET, SO_REUSEPORT,
+			                 reinterpret_cast<const char *>(&enabled), sizeof(enabled)) < 0)
+				throw std::runtime_error("Failed to enable SO_REUSEPORT on TCP server socket");
+#endif
+		}
+
 		// Listen on both IPv6 and IPv4
 		if (ai->ai_family == AF_INET6)
 			::setsockopt(mSock, IPPROTO_IPV6, IPV6_V6ONLY,
@@ -152,7 +206,8 @@ void TcpServer::listen(uint16_t port, const char *bindAddress) {
 		}
 
 		// Listen
-		const int backlog = 10;
+		// Reconnect storms need a deep queue of pending connections
+		const int backlog = SOMAXCONN;
 		if (::listen(mSock, backlog) < 0) {
 			PLOG_WARNING << "TCP server socket listening failed, errno=" << sockerrno;
 			throw std::runtime_error("TCP server socket listening failed");
@@ -21,24 +21,32 @@ namespace rtc::impl {
 
 class TcpServer final {
 public:
-	TcpServer(uint16_t port, const char *bindAddress = nullptr);
+	static bool IsReusePortSupported();
+
+	TcpServer(uint16_t port, const char *bindAddress = nullptr, bool reusePort = false);
 	~TcpServer();
 
 	TcpServer(const TcpServer &other) = delete;
 	void operator=(const TcpServer &other) = delete;
 
-	shared_ptr<TcpTransport> accept();
+	shared_ptr<TcpTransport> accept();    // blocking, returns nullptr when closed
+	shared_ptr<TcpTransport> tryAccept(); // returns nullptr if no connection is pending
 	void close();
 
+	// For an external event loop, call back from the poll service when connections are pending
+	void setPendingCallback(std::function<void()> callback);
+
 	uint16_t port() const { return mPort; }
 
 private:
-	void listen(uint16_t port, const char *bindAddress);
+	void listen(uint16_t port, const char *bindAddress, bool reusePort);
+	shared_ptr<TcpTransport> acceptPending();
 
 	uint16_t mPort;
 	socket_t mSock = INVALID_SOCKET;
 	std::mutex mSockMutex;
 	PollInterrupter mInterrupter;
+	bool mPolled = false;
 };
 
 } // namespace rtc::impl
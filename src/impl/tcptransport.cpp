@@ -14,9 +14,24 @@
 
 #ifndef _WIN32
 #include <fcntl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #endif
 
+#if defined(__linux__) && __has_include(<linux/tls.h>)
+#define RTC_KERNEL_TLS 1
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#else
+#define RTC_KERNEL_TLS 0
+#endif
+
 #include <chrono>
 
 namespace rtc::impl {
@@ -28,6 +43,13 @@ using std::chrono::milliseconds;
 
 namespace {
 
+// Maximum number of queued messages gathered in a single vectored write
+#ifdef IOV_MAX
+const size_t MaxSendBuffers = IOV_MAX < 64 ? IOV_MAX : 64;
+#else
+const size_t MaxSendBuffers = 64;
+#endif
+
 bool unmap_inet6_v4mapped(struct sockaddr *sa, socklen_t *len) {
 	if (sa->sa_family != AF_INET6)
 		return false;
@@ -120,6 +142,30 @@ bool TcpTransport::send(message_ptr message) {
 	return outgoing(std::move(message));
 }
 
+bool TcpTransport::send(message_vector &messages) {
+	std::lock_guard lock(mSendMutex);
+
+	if (state() != State::Connected)
+		throw std::runtime_error("Connection is not open");
+
+	size_t size = 0;
+	for (auto &message : messages) {
+		if (!message || message->size() == 0)
+			continue;
+
+		size += message->size();
+		mSendQueue.push_back(std::move(message));
+	}
+	messages.clear();
+
+	PLOG_VERBOSE << "Send size=" << size;
+	if (trySendQueue(size))
+		return true;
+
+	setPoll(PollService::Direction::Both);
+	return false;
+}
+
 void TcpTransport::incoming(message_ptr message) {
 	if (!message)
 		return;
@@ -130,13 +176,12 @@ void TcpTransport::incoming(message_ptr message) {
 
 bool TcpTransport::outgoing(message_ptr message) {
 	// mSendMutex must be locked
-	// Flush the queue, and if nothing is pending, try to send directly
-	if (trySendQueue() && trySendMessage(message))
+	// Queue the message and flush the queue, so that it is coalesced with pending messages
+	const size_t size = message->size();
+	mSendQueue.push_back(std::move(message));
+	if (trySendQueue(size))
 		return true;
 
-	const size_t size = message->size();
-	mSendQueue.push(std::move(message));
-	updateBufferedAmount(ptrdiff_t(size));
 	setPoll(PollService::Direction::Both);
 	return false;
 }
@@ -145,6 +190,32 @@ bool TcpTransport::isActive() const { return mIsActive; }
 
 string TcpTransport::remoteAddress() const { return mHostname + ':' + mService; }
 
+bool TcpTransport::enableKernelTls([[maybe_unused]] const void *cryptoInfo,
+                                   [[maybe_unused]] size_t size) {
+#if RTC_KERNEL_TLS
+	std::lock_guard lock(mSendMutex);
+	if (mSock == INVALID_SOCKET || !mSendQueue.empty())
+		return false;
+
+	// The upper layer protocol requires the tls kernel module
+	if (!mKernelTls && ::setsockopt(mSock, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) < 0) {
+		PLOG_DEBUG << "Kernel TLS is unavailable, errno=" << sockerrno;
+		return false;
+	}
+
+	if (::setsockopt(mSock, SOL_TLS, TLS_TX, cryptoInfo, socklen_t(size)) < 0) {
+		PLOG_WARNING << "Failed to set kernel TLS keys, errno=" << sockerrno;
+		return false;
+	}
+
+	PLOG_DEBUG << "Enabled kernel TLS";
+	mKernelTls = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
 void TcpTransport::connect() {
 	if (state() == State::Connecting)
 		throw std::logic_error("TCP connection is already in progress");
@@ -309,53 +380,107 @@ void TcpTransport::close() {
 	changeState(State::Disconnected);
 }
 
-bool TcpTransport::trySendQueue() {
+bool TcpTransport::trySendQueue(size_t queued) {
 	// mSendMutex must be locked
-	while (auto next = mSendQueue.peek()) {
-		message_ptr message = std::move(*next);
-		size_t size = message->size();
-		if (!trySendMessage(message)) { // replaces message
-			mSendQueue.exchange(message);
-			updateBufferedAmount(-ptrdiff_t(size) + ptrdiff_t(message->size()));
-			return false;
+	// queued is the size of messages just pushed and not yet counted in the buffered amount
+	size_t sent = 0;
+	bool flushed = true;
+	while (!mSendQueue.empty()) {
+		size_t len = trySendBuffers();
+		if (len == 0) {
+			flushed = false;
+			break;
 		}
 
-		mSendQueue.pop();
-		updateBufferedAmount(-ptrdiff_t(size));
+		sent += len;
+
+		// Pop entirely sent messages, the last one might have been partially sent
+		while (len > 0) {
+			size_t left = mSendQueue.front()->size() - mSendOffset;
+			if (len < left) {
+				mSendOffset += len;
+				break;
+			}
+
+			len -= left;
+			mSendQueue.pop_front();
+			mSendOffset = 0;
+		}
 	}
 
-	return true;
+	updateBufferedAmount(ptrdiff_t(queued) - ptrdiff_t(sent));
+	return flushed;
 }
 
-bool TcpTransport::trySendMessage(message_ptr &message) {
+size_t TcpTransport::trySendBuffers() {
 	// mSendMutex must be locked
+	// Gather queued messages into a single vectored write to save syscalls and copies
+#ifdef _WIN32
+	WSABUF buffers[MaxSendBuffers];
+#else
+	struct iovec buffers[MaxSendBuffers];
+#endif
+	size_t count = 0;
+	size_t offset = mSendOffset;
+	for (auto it = mSendQueue.begin(); it != mSendQueue.end() && count < MaxSendBuffers; ++it) {
+		// With kernel TLS, a control message is sent alone as it makes a record of its own
+		if (mKernelTls && count > 0 && (*it)->type == Message::Control)
+			break;
 
-	auto data = reinterpret_cast<const char *>(message->data());
-	auto size = message->size();
-	while (size) {
-#if defined(__APPLE__) || defined(_WIN32)
-		int flags = 0;
+		auto data = (*it)->data() + offset;
+		auto size = (*it)->size() - offset;
+#ifdef _WIN32
+		buffers[count].buf = reinterpret_cast<CHAR *>(data);
+		buffers[count].len = ULONG(size);
 #else
-		int flags = MSG_NOSIGNAL;
+		buffers[count].iov_base = data;
+		buffers[count].iov_len = size;
 #endif
-		int len = ::send(mSock, data, int(size), flags);
-		if (len < 0) {
-			if (sockerrno == SEAGAIN || sockerrno == SEWOULDBLOCK) {
-				if (size < message->size())
-					message = make_message(message->end() - size, message->end());
-
-				return false;
-			} else {
-				PLOG_ERROR << "Connection closed, errno=" << sockerrno;
-				throw std::runtime_error("Connection closed");
-			}
-		}
+		++count;
+		offset = 0;
 
-		data += len;
-		size -= len;
+		if (mKernelTls && (*it)->type == Message::Control)
+			break;
 	}
-	message = nullptr;
-	return true;
+
+#ifdef _WIN32
+	DWORD len = 0;
+	if (::WSASend(mSock, buffers, DWORD(count), &len, 0, NULL, NULL) == SOCKET_ERROR) {
+#else
+#ifdef __APPLE__
+	int flags = 0;
+#else
+	int flags = MSG_NOSIGNAL;
+#endif
+	struct msghdr msg = {};
+	msg.msg_iov = buffers;
+	msg.msg_iovlen = decltype(msg.msg_iovlen)(count);
+#if RTC_KERNEL_TLS
+	char control[CMSG_SPACE(sizeof(uint8_t))];
+	if (mKernelTls && mSendQueue.front()->type == Message::Control && mSendOffset == 0) {
+		// Set the record type, e.g. alert or handshake. If the record was partially sent, the
+		// kernel already has its type and the remainder must be sent without it.
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_TLS;
+		cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+		*CMSG_DATA(cmsg) = static_cast<unsigned char>(mSendQueue.front()->stream);
+	}
+#endif
+	ssize_t len = ::sendmsg(mSock, &msg, flags);
+	if (len < 0) {
+#endif
+		if (sockerrno == SEAGAIN || sockerrno == SEWOULDBLOCK)
+			return 0;
+
+		PLOG_ERROR << "Connection closed, errno=" << sockerrno;
+		throw std::runtime_error("Connection closed");
+	}
+
+	PLOG_VERBOSE << "Sent " << count << " buffers, size=" << len;
+	return size_t(len);
 }
 
 void TcpTransport::updateBufferedAmount(ptrdiff_t delta) {
@@ -11,13 +11,13 @@
 
 #include "common.hpp"
 #include "pollservice.hpp"
-#include "queue.hpp"
 #include "socket.hpp"
 #include "transport.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
 #include <chrono>
+#include <deque>
 #include <list>
 #include <mutex>
 #include <tuple>
@@ -38,6 +38,7 @@ public:
 
 	void start() override;
 	bool send(message_ptr message) override;
+	bool send(message_vector &messages); // consumes the messages
 
 	void incoming(message_ptr message) override;
 	bool outgoing(message_ptr message) override;
@@ -45,6 +46,11 @@ public:
 	bool isActive() const;
 	string remoteAddress() const;
 
+	// Install TLS transmit keys into the kernel (Linux only), so that queued data is then sent in
+	// TLS records. Control messages are sent in a record of their own, with message->stream as type.
+	// It fails if data is still pending.
+	bool enableKernelTls(const void *cryptoInfo, size_t size);
+
 private:
 	void connect();
 	void resolve();
@@ -54,8 +60,8 @@ private:
 	void setPoll(PollService::Direction direction);
 	void close();
 
-	bool trySendQueue();
-	bool trySendMessage(message_ptr &message);
+	bool trySendQueue(size_t queued = 0);
+	size_t trySendBuffers();
 	void updateBufferedAmount(ptrdiff_t delta);
 	void triggerBufferedAmount(size_t amount);
 
@@ -71,8 +77,10 @@ private:
 	std::list<std::tuple<struct sockaddr_storage, socklen_t>> mResolved;
 
 	socket_t mSock;
-	Queue<message_ptr> mSendQueue;
+	std::deque<message_ptr> mSendQueue;
+	size_t mSendOffset = 0; // already sent bytes of the first queued message
 	size_t mBufferedAmount = 0;
+	bool mKernelTls = false;
 	std::mutex mSendMutex;
 };
 
@@ -70,6 +70,54 @@ bool ThreadPool::runOne() {
 	return false;
 }
 
+int ThreadPool::poll(optional<clock::time_point> until) {
+	// The thread running the external event loop is considered the poll thread
+	mPollThreadId = std::this_thread::get_id();
+
+	std::unique_lock lock(mMutex);
+	while (true) {
+		auto now = clock::now();
+		if (!mTasks.empty() && mTasks.top().time <= now)
+			break;
+
+		if (until && now >= *until)
+			return 0;
+
+		if (!mTasks.empty())
+			mTasksCondition.wait_until(lock, until ? std::min(mTasks.top().time, *until)
+			                                       : mTasks.top().time);
+		else if (until)
+			mTasksCondition.wait_until(lock, *until);
+		else
+			mTasksCondition.wait(lock);
+	}
+
+	// Tasks scheduled by the ones run here are left for the next call, so the loop is not starved
+	const auto now = clock::now();
+	int count = 0;
+	while (!mTasks.empty() && mTasks.top().time <= now) {
+		auto func = std::move(mTasks.top().func);
+		mTasks.pop();
+		lock.unlock();
+		func();
+		++count;
+		lock.lock();
+	}
+	return count;
+}
+
+bool ThreadPool::isPollThread() const { return std::this_thread::get_id() == mPollThreadId.load(); }
+
+optional<ThreadPool::clock::time_point> ThreadPool::nextTime() const {
+	std::unique_lock lock(mMutex);
+	return !mTasks.empty() ? std::make_optional(mTasks.top().time) : nullopt;
+}
+
+void ThreadPool::setInterrupt(std::function<void()> interrupt) {
+	std::unique_lock lock(mMutex);
+	mInterrupt = std::move(interrupt);
+}
+
 std::function<void()> ThreadPool::dequeue() {
 	std::unique_lock lock(mMutex);
 	while (!mJoining) {
@@ -48,6 +48,13 @@ public:
 	void run();
 	bool runOne();
 
+	// For an external event loop, when there is no worker
+	int poll(optional<clock::time_point> until); // run due tasks, waiting until the time point if
+	                                             // none, indefinitely if unset
+	bool isPollThread() const; // true on the thread running the external event loop
+	optional<clock::time_point> nextTime() const;
+	void setInterrupt(std::function<void()> interrupt); // called when a task is scheduled
+
 	template <class F, class... Args>
 	auto enqueue(F &&f, Args &&...args) noexcept -> invoke_future_t<F, Args...>;
 
@@ -68,6 +75,7 @@ private:
 	std::vector<std::thread> mWorkers;
 	std::atomic<int> mBusyWorkers = 0;
 	std::atomic<bool> mJoining = false;
+	std::atomic<std::thread::id> mPollThreadId;
 
 	struct Task {
 		clock::time_point time;
@@ -76,6 +84,7 @@ private:
 		bool operator<(const Task &other) const { return time < other.time; }
 	};
 	std::priority_queue<Task, std::deque<Task>, std::greater<Task>> mTasks;
+	std::function<void()> mInterrupt;
 
 	std::condition_variable mTasksCondition, mWaitingCondition;
 	mutable std::mutex mMutex, mWorkersMutex;
@@ -110,6 +119,13 @@ auto ThreadPool::schedule(clock::time_point time, F &&f, Args &&...args) noexcep
 
 	mTasks.push({time, [task = std::move(task)]() { return (*task)(); }});
 	mTasksCondition.notify_one();
+
+	// The interrupt must not be called with mMutex locked as it locks the poll service
+	auto interrupt = mInterrupt;
+	lock.unlock();
+	if (interrupt)
+		interrupt();
+
 	return result;
 }
 
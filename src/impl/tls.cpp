@@ -263,6 +263,10 @@ void SSL_CTX_add_cert_to_store_from_pem(SSL_CTX *ctx, const string &pem) {
 		throw std::runtime_error("Failed to get certificate store");
 	}
 
+	X509_STORE_add_cert_from_pem(store, pem);
+}
+
+void X509_STORE_add_cert_from_pem(X509_STORE *store, const string &pem) {
 	BIO *bio = BIO_new(BIO_s_mem());
 	BIO_write(bio, pem.data(), int(pem.size()));
 	STACK_OF(X509_INFO) *certs = PEM_X509_INFO_read_bio(bio, nullptr, nullptr, nullptr);
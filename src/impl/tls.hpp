@@ -41,6 +41,7 @@ gnutls_datum_t make_datum(char *data, size_t size);
 #elif USE_MBEDTLS
 
 #include "mbedtls/ssl.h"
+#include "mbedtls/ssl_ticket.h"
 #include "mbedtls/error.h"
 #include "mbedtls/pk.h"
 #include "mbedtls/x509_crt.h"
@@ -88,6 +89,15 @@ std::shared_ptr<mbedtls_x509_crt> new_x509_crt();
 #define BIO_EOF -1
 #endif
 
+// Kernel TLS offload requires OpenSSL 3.0 or 3.1 built with kernel TLS support on Linux, as the
+// BIO controls used to set it up are internal to OpenSSL and changed in 3.2
+#if defined(__linux__) && __has_include(<linux/tls.h>) && OPENSSL_VERSION_NUMBER >= 0x30000000 && \
+    OPENSSL_VERSION_NUMBER < 0x30200000 && !defined(OPENSSL_NO_KTLS)
+#define RTC_OPENSSL_KTLS 1
+#else
+#define RTC_OPENSSL_KTLS 0
+#endif
+
 namespace rtc::openssl {
 
 void init();
@@ -99,6 +109,7 @@ bool check_error(int err, const string &message = "OpenSSL error");
 BIO *BIO_new_from_file(const string &filename);
 
 void SSL_CTX_add_cert_to_store_from_pem(SSL_CTX *ctx, const string &pem);
+void X509_STORE_add_cert_from_pem(X509_STORE *store, const string &pem);
 
 } // namespace rtc::openssl
 
@@ -16,12 +16,97 @@
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <deque>
 #include <exception>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std::chrono;
 
 namespace rtc::impl {
 
+namespace {
+
+// Client sessions kept for resumption, as transports don't share a TLS context. A TLS 1.3 ticket
+// should only be used once (RFC 8446 C.4), so a session is taken out of the cache to be resumed and
+// several are kept per key for concurrent connections. The server issues new tickets afterwards.
+template <typename Session> class SessionCache final {
+public:
+	static SessionCache &Instance() {
+		static SessionCache instance;
+		return instance;
+	}
+
+	void store(const string &key, Session session) {
+		std::lock_guard lock(mMutex);
+		auto it = mSessions.find(key);
+		if (it == mSessions.end()) {
+			if (mSessions.size() >= TLS_SESSION_CACHE_SIZE)
+				mSessions.erase(mSessions.begin());
+
+			it = mSessions.emplace(key, std::deque<Session>()).first;
+		}
+
+		auto &sessions = it->second;
+		if (sessions.size() >= TLS_SESSION_CACHE_DEPTH)
+			sessions.pop_front(); // drop the oldest
+
+		sessions.push_back(std::move(session));
+	}
+
+	optional<Session> take(const string &key) {
+		std::lock_guard lock(mMutex);
+		auto it = mSessions.find(key);
+		if (it == mSessions.end())
+			return nullopt;
+
+		// The cache never keeps an empty entry
+		auto &sessions = it->second;
+		Session session = std::move(sessions.back()); // the newest
+		sessions.pop_back();
+		if (sessions.empty())
+			mSessions.erase(it);
+
+		return session;
+	}
+
+private:
+	std::mutex mMutex;
+	std::unordered_map<string, std::deque<Session>> mSessions;
+};
+
+// A session must only be resumed with the same server and with the same client certificate
+string make_session_cache_key(
+    const variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> &lower,
+    const string &host, const certificate_ptr &certificate) {
+	string key = host + '|' + std::visit([](auto l) { return l->remoteAddress(); }, lower);
+	if (certificate)
+		key += '|' + certificate->fingerprint().value;
+
+	return key;
+}
+
+} // namespace
+
+bool TlsTransport::send(message_vector &messages) {
+#if RTC_OPENSSL_KTLS
+	if (mKernelTls) {
+		if (state() != State::Connected)
+			throw std::runtime_error("TLS is not open");
+
+		// The kernel encrypts records, so messages are passed through without copy
+		std::lock_guard lock(mSslMutex);
+		return mTcpTransport->send(messages);
+	}
+#endif
+	bool result = true;
+	for (auto &message : messages)
+		result = send(std::move(message));
+
+	messages.clear();
+	return result;
+}
+
 void TlsTransport::enqueueRecv() {
 	if (mPendingRecvCount > 0)
 		return;
@@ -49,6 +134,22 @@ gnutls_certificate_credentials_t default_certificate_credentials() {
 	return *creds;
 }
 
+// Master key for session tickets, GnuTLS derives the actual encryption keys from it and rotates
+// them according to the session expiration time
+std::mutex session_ticket_key_mutex;
+gnutls_datum_t session_ticket_key = {nullptr, 0};
+
+const gnutls_datum_t *get_session_ticket_key() {
+	std::lock_guard lock(session_ticket_key_mutex);
+	if (!session_ticket_key.data)
+		gnutls::check(gnutls_session_ticket_key_generate(&session_ticket_key),
+		              "Failed to generate session ticket key");
+
+	return &session_ticket_key;
+}
+
+using SessionData = binary;
+
 } // namespace
 
 void TlsTransport::Init() {
@@ -56,12 +157,17 @@ void TlsTransport::Init() {
 }
 
 void TlsTransport::Cleanup() {
-	// Nothing to do
+	std::lock_guard lock(session_ticket_key_mutex);
+	if (session_ticket_key.data) {
+		gnutls_memset(session_ticket_key.data, 0, session_ticket_key.size);
+		gnutls_free(session_ticket_key.data);
+		session_ticket_key = {nullptr, 0};
+	}
 }
 
 TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
                            optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
+                           state_callback callback, bool enableKernelTls)
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(callback)),
       mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
@@ -69,6 +175,9 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 
 	PLOG_DEBUG << "Initializing TLS transport (GnuTLS)";
 
+	if (enableKernelTls)
+		PLOG_WARNING << "Kernel TLS is only supported with OpenSSL";
+
 	unsigned int flags = GNUTLS_NONBLOCK | (mIsClient ? GNUTLS_CLIENT : GNUTLS_SERVER);
 	gnutls::check(gnutls_init(&mSession, flags));
 
@@ -85,6 +194,17 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 		if (mIsClient && mHost) {
 			PLOG_VERBOSE << "Server Name Indication: " << *mHost;
 			gnutls_server_name_set(mSession, GNUTLS_NAME_DNS, mHost->data(), mHost->size());
+			mSessionCacheKey = make_session_cache_key(lower, *mHost, certificate);
+		}
+
+		if (mIsClient) {
+			// TLS 1.3 tickets are received after the handshake
+			gnutls_handshake_set_hook_function(mSession, GNUTLS_HANDSHAKE_NEW_SESSION_TICKET,
+			                                   GNUTLS_HOOK_POST, HandshakeHookCallback);
+		} else {
+			gnutls::check(gnutls_session_ticket_enable_server(mSession, get_session_ticket_key()),
+			              "Failed to enable session tickets");
+			gnutls_db_set_cache_expiration(mSession, TLS_TICKET_KEY_LIFETIME);
 		}
 
 		gnutls_session_set_ptr(mSession, this);
@@ -110,6 +230,15 @@ void TlsTransport::start() {
 	PLOG_DEBUG << "Starting TLS transport";
 	registerIncoming();
 	changeState(State::Connecting);
+
+	if (!mSessionCacheKey.empty()) {
+		if (auto data = SessionCache<SessionData>::Instance().take(mSessionCacheKey)) {
+			PLOG_DEBUG << "Trying to resume TLS session";
+			if (gnutls_session_set_data(mSession, data->data(), data->size()) != GNUTLS_E_SUCCESS)
+				PLOG_WARNING << "Failed to set TLS session data";
+		}
+	}
+
 	enqueueRecv(); // to initiate the handshake
 }
 
@@ -182,6 +311,14 @@ void TlsTransport::doRecv() {
 			} while (!gnutls::check(ret, "Handshake failed")); // Re-call on non-fatal error
 
 			PLOG_INFO << "TLS handshake finished";
+			if (gnutls_session_is_resumed(mSession)) {
+				PLOG_DEBUG << "TLS session resumed";
+				mSessionResumed = true;
+			}
+
+			if (gnutls_protocol_get_version(mSession) != GNUTLS_TLS1_3)
+				storeSession();
+
 			changeState(State::Connected);
 			postHandshake();
 		}
@@ -190,8 +327,14 @@ void TlsTransport::doRecv() {
 			while (true) {
 				ssize_t ret = gnutls_record_recv(mSession, buffer, bufferSize);
 
-				if (ret == GNUTLS_E_AGAIN)
+				if (ret == GNUTLS_E_AGAIN) {
+					// Processing a post-handshake message like a TLS 1.3 ticket also returns
+					// GNUTLS_E_AGAIN, while the next records might already have been received
+					if (TimeoutCallback(this, 0) > 0)
+						continue;
+
 					return;
+				}
 
 				// Consider premature termination as remote closing
 				if (ret == GNUTLS_E_PREMATURE_TERMINATION) {
@@ -259,7 +402,9 @@ ssize_t TlsTransport::ReadCallback(gnutls_transport_ptr_t ptr, void *data, size_
 				if (message->size() > 0)
 					break;
 
-				t->recv(std::move(message)); // Pass zero-sized messages through
+				// Zero-sized messages mean TCP is idle, pass them through
+				t->mIncomingQueue.shrink();
+				t->recv(std::move(message));
 				message.reset();
 			}
 		}
@@ -287,6 +432,34 @@ ssize_t TlsTransport::ReadCallback(gnutls_transport_ptr_t ptr, void *data, size_
 	}
 }
 
+void TlsTransport::storeSession() {
+	if (mSessionCacheKey.empty())
+		return;
+
+	gnutls_datum_t data;
+	if (gnutls_session_get_data2(mSession, &data) != GNUTLS_E_SUCCESS)
+		return;
+
+	try {
+		auto *b = reinterpret_cast<const byte *>(data.data);
+		SessionCache<SessionData>::Instance().store(mSessionCacheKey, SessionData(b, b + data.size));
+	} catch (const std::exception &e) {
+		PLOG_WARNING << "Failed to store TLS session: " << e.what();
+	}
+	gnutls_free(data.data);
+}
+
+int TlsTransport::HandshakeHookCallback(gnutls_session_t session, unsigned int /* htype */,
+                                        unsigned int /* when */, unsigned int /* incoming */,
+                                        const gnutls_datum_t * /* msg */) {
+	// TLS 1.2 sessions are stored once the handshake is finished
+	if (gnutls_protocol_get_version(session) == GNUTLS_TLS1_3) {
+		TlsTransport *t = static_cast<TlsTransport *>(gnutls_session_get_ptr(session));
+		t->storeSession();
+	}
+	return 0;
+}
+
 int TlsTransport::TimeoutCallback(gnutls_transport_ptr_t ptr, unsigned int /* ms */) {
 	TlsTransport *t = static_cast<TlsTransport *>(ptr);
 	try {
@@ -306,17 +479,60 @@ int TlsTransport::TimeoutCallback(gnutls_transport_ptr_t ptr, unsigned int /* ms
 
 #elif USE_MBEDTLS
 
+namespace {
+
+using SessionData = shared_ptr<mbedtls_ssl_session>;
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_SRV_C)
+// Context for session tickets, Mbed TLS rotates its keys every TLS_TICKET_KEY_LIFETIME seconds
+std::mutex session_ticket_mutex;
+unique_ptr<mbedtls_ssl_ticket_context> session_ticket_context;
+
+mbedtls_ssl_ticket_context *get_session_ticket_context() {
+	std::lock_guard lock(session_ticket_mutex);
+	if (!session_ticket_context) {
+		auto ctx = std::make_unique<mbedtls_ssl_ticket_context>();
+		mbedtls_ssl_ticket_init(ctx.get());
+		try {
+#if MBEDTLS_VERSION_MAJOR >= 4
+			mbedtls::check(mbedtls_ssl_ticket_setup(ctx.get(), PSA_ALG_GCM, PSA_KEY_TYPE_AES, 256,
+			                                        TLS_TICKET_KEY_LIFETIME),
+			               "Failed to set up session tickets");
+#else
+			mbedtls::check(mbedtls_ssl_ticket_setup(ctx.get(), &mbedtls::random_func, nullptr,
+			                                        MBEDTLS_CIPHER_AES_256_GCM,
+			                                        TLS_TICKET_KEY_LIFETIME),
+			               "Failed to set up session tickets");
+#endif
+		} catch (...) {
+			mbedtls_ssl_ticket_free(ctx.get());
+			throw;
+		}
+		session_ticket_context = std::move(ctx);
+	}
+	return session_ticket_context.get();
+}
+#endif
+
+} // namespace
+
 void TlsTransport::Init() {
 	// Nothing to do
 }
 
 void TlsTransport::Cleanup() {
-	// Nothing to do
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_SRV_C)
+	std::lock_guard lock(session_ticket_mutex);
+	if (session_ticket_context) {
+		mbedtls_ssl_ticket_free(session_ticket_context.get());
+		session_ticket_context.reset();
+	}
+#endif
 }
 
 TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
                            optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
+                           state_callback callback, bool enableKernelTls)
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(callback)),
       mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
@@ -324,6 +540,9 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 
 	PLOG_DEBUG << "Initializing TLS transport (MbedTLS)";
 
+	if (enableKernelTls)
+		PLOG_WARNING << "Kernel TLS is only supported with OpenSSL";
+
 	mbedtls_ssl_init(&mSsl);
 	mbedtls_ssl_config_init(&mConf);
 
@@ -346,8 +565,16 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 		if (mIsClient && mHost) {
 			PLOG_VERBOSE << "Server Name Indication: " << *mHost;
 			mbedtls_ssl_set_hostname(&mSsl, mHost->c_str());
+			mSessionCacheKey = make_session_cache_key(lower, *mHost, certificate);
 		}
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_SRV_C)
+		if (!mIsClient)
+			mbedtls_ssl_conf_session_tickets_cb(&mConf, mbedtls_ssl_ticket_write,
+			                                    mbedtls_ssl_ticket_parse,
+			                                    get_session_ticket_context());
+#endif
+
 		mbedtls::check(mbedtls_ssl_setup(&mSsl, &mConf));
 		mbedtls_ssl_set_bio(&mSsl, static_cast<void *>(this), WriteCallback, ReadCallback, NULL);
 
@@ -370,6 +597,16 @@ void TlsTransport::start() {
 	PLOG_DEBUG << "Starting TLS transport";
 	registerIncoming();
 	changeState(State::Connecting);
+
+	if (!mSessionCacheKey.empty()) {
+		if (auto session = SessionCache<SessionData>::Instance().take(mSessionCacheKey)) {
+			PLOG_DEBUG << "Trying to resume TLS session";
+			std::lock_guard lock(mSslMutex);
+			if (mbedtls_ssl_set_session(&mSsl, session->get()) != 0)
+				PLOG_WARNING << "Failed to set TLS session";
+		}
+	}
+
 	enqueueRecv(); // to initiate the handshake
 }
 
@@ -450,6 +687,7 @@ void TlsTransport::doRecv() {
 
 				if (mbedtls::check(ret, "Handshake failed")) {
 					PLOG_INFO << "TLS handshake finished";
+					storeSession();
 					changeState(State::Connected);
 					postHandshake();
 					break;
@@ -499,6 +737,29 @@ void TlsTransport::doRecv() {
 	}
 }
 
+void TlsTransport::storeSession() {
+	if (mSessionCacheKey.empty())
+		return;
+
+	auto *s = new mbedtls_ssl_session;
+	mbedtls_ssl_session_init(s);
+	auto session = SessionData(s, [](mbedtls_ssl_session *s) {
+		mbedtls_ssl_session_free(s);
+		delete s;
+	});
+
+	int ret;
+	{
+		std::lock_guard lock(mSslMutex);
+		ret = mbedtls_ssl_get_session(&mSsl, session.get());
+	}
+
+	if (ret == 0)
+		SessionCache<SessionData>::Instance().store(mSessionCacheKey, std::move(session));
+	else
+		PLOG_DEBUG << "TLS session is not resumable";
+}
+
 int TlsTransport::WriteCallback(void *ctx, const unsigned char *buf, size_t len) {
 	auto *t = static_cast<TlsTransport *>(ctx);
 	auto *b = reinterpret_cast<const byte *>(buf);
@@ -523,7 +784,9 @@ int TlsTransport::ReadCallback(void *ctx, unsigned char *buf, size_t len) {
 				if (message->size() > 0)
 					break;
 
-				t->recv(std::move(message)); // Pass zero-sized messages through
+				// Zero-sized messages mean TCP is idle, pass them through
+				t->mIncomingQueue.shrink();
+				t->recv(std::move(message));
 				message.reset();
 			}
 		}
@@ -548,7 +811,175 @@ int TlsTransport::ReadCallback(void *ctx, unsigned char *buf, size_t len) {
 
 #else
 
+#include <openssl/buffer.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#if RTC_OPENSSL_KTLS
+#include <linux/tls.h>
+#endif
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+#include <openssl/core_names.h>
+#else
+#include <openssl/hmac.h>
+#endif
+
+namespace {
+
+using SessionData = shared_ptr<SSL_SESSION>;
+
+// Keys to encrypt session tickets, shared by all server transports and rotated every
+// TLS_TICKET_KEY_LIFETIME seconds. The previous key is kept to accept tickets issued before the
+// last rotation.
+class SessionTicketKeys final {
+public:
+	struct Key {
+		unsigned char name[16];
+		unsigned char aesKey[32];
+		unsigned char hmacKey[32];
+	};
+
+	static SessionTicketKeys &Instance() {
+		static SessionTicketKeys instance;
+		return instance;
+	}
+
+	Key current() {
+		std::lock_guard lock(mMutex);
+		auto now = steady_clock::now();
+		if (!mCurrent || now - mCreated >= seconds(TLS_TICKET_KEY_LIFETIME)) {
+			if (mPrevious)
+				OPENSSL_cleanse(&*mPrevious, sizeof(Key));
+
+			mPrevious = std::exchange(mCurrent, generate());
+			mCreated = now;
+		}
+		return *mCurrent;
+	}
+
+	// Returns the key and whether it is the current one
+	optional<std::pair<Key, bool>> find(const unsigned char *name) {
+		std::lock_guard lock(mMutex);
+		if (mCurrent && std::memcmp(mCurrent->name, name, sizeof(Key::name)) == 0)
+			return std::make_pair(*mCurrent, true);
+		if (mPrevious && std::memcmp(mPrevious->name, name, sizeof(Key::name)) == 0)
+			return std::make_pair(*mPrevious, false);
+
+		return nullopt;
+	}
+
+private:
+	static Key generate() {
+		Key key;
+		openssl::check(RAND_bytes(reinterpret_cast<unsigned char *>(&key), sizeof(Key)),
+		               "Failed to generate session ticket key");
+		return key;
+	}
+
+	std::mutex mMutex;
+	optional<Key> mCurrent, mPrevious;
+	steady_clock::time_point mCreated;
+};
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+int session_ticket_key_callback(SSL *ssl, unsigned char *keyName, unsigned char *iv,
+                                EVP_CIPHER_CTX *cipherCtx, EVP_MAC_CTX *macCtx, int enc) {
+#else
+int session_ticket_key_callback(SSL *ssl, unsigned char *keyName, unsigned char *iv,
+                                EVP_CIPHER_CTX *cipherCtx, HMAC_CTX *macCtx, int enc) {
+#endif
+	try {
+		auto &keys = SessionTicketKeys::Instance();
+		SessionTicketKeys::Key key;
+		bool isCurrent = true;
+		if (enc) {
+			key = keys.current();
+			std::memcpy(keyName, key.name, sizeof(key.name));
+			if (RAND_bytes(iv, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) <= 0)
+				return -1;
+		} else {
+			auto found = keys.find(keyName);
+			if (!found)
+				return 0; // Unknown key, fall back to a full handshake
+
+			std::tie(key, isCurrent) = *found;
+		}
+
+		if (!EVP_CipherInit_ex(cipherCtx, EVP_aes_256_cbc(), NULL, key.aesKey, iv, enc))
+			return -1;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+		OSSL_PARAM params[] = {
+		    OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, key.hmacKey, sizeof(key.hmacKey)),
+		    OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char *>("SHA256"), 0),
+		    OSSL_PARAM_construct_end()};
+		if (!EVP_MAC_CTX_set_params(macCtx, params))
+			return -1;
+#else
+		if (!HMAC_Init_ex(macCtx, key.hmacKey, sizeof(key.hmacKey), EVP_sha256(), NULL))
+			return -1;
+#endif
+		OPENSSL_cleanse(&key, sizeof(key));
+
+		// 2 means the ticket must be renewed. Clients use a TLS 1.3 ticket only once, so a new one
+		// is always issued on resumption, otherwise OpenSSL would not send any.
+		bool renew = !isCurrent || SSL_version(ssl) == TLS1_3_VERSION;
+		return renew ? 2 : 1;
+	} catch (const std::exception &e) {
+		PLOG_WARNING << e.what();
+		return -1;
+	}
+}
+
+// A memory BIO never shrinks, so free the buffer once drained to keep idle connections small
+void release_mem_bio_buffer(BIO *bio) {
+	BUF_MEM *mem = nullptr;
+	if (BIO_ctrl_pending(bio) > 0 || BIO_get_mem_ptr(bio, &mem) <= 0 || !mem || mem->max == 0)
+		return;
+
+	if (BUF_MEM *empty = BUF_MEM_new())
+		BIO_set_mem_buf(bio, empty, BIO_CLOSE); // frees the previous buffer
+}
+
+#if RTC_OPENSSL_KTLS
+// Controls used by OpenSSL 3.0 and 3.1 to set up kernel TLS on the BIO, they are internal so the
+// library version is checked at runtime before enabling it
+const int BIO_CTRL_SET_KTLS_ = 72;
+const int BIO_CTRL_SET_KTLS_SEND_CTRL_MSG_ = 74;
+const int BIO_CTRL_CLEAR_KTLS_CTRL_MSG_ = 75;
+
+bool kernel_tls_supported() {
+	// The library might not be the version the headers are from
+	unsigned long version = OpenSSL_version_num();
+	return version >= 0x30000000 && version < 0x30200000;
+}
+
+size_t kernel_tls_crypto_info_size(const struct tls_crypto_info *info) {
+	switch (info->cipher_type) {
+	case TLS_CIPHER_AES_GCM_128:
+		return sizeof(struct tls12_crypto_info_aes_gcm_128);
+	case TLS_CIPHER_AES_GCM_256:
+		return sizeof(struct tls12_crypto_info_aes_gcm_256);
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+	case TLS_CIPHER_CHACHA20_POLY1305:
+		return sizeof(struct tls12_crypto_info_chacha20_poly1305);
+#endif
+	default:
+		return 0;
+	}
+}
+#endif
+
+} // namespace
+
 int TlsTransport::TransportExIndex = -1;
+SSL_CTX *TlsTransport::SharedContexts[2] = {nullptr, nullptr};
+std::mutex TlsTransport::SharedContextsMutex;
+
+#if RTC_OPENSSL_KTLS
+BIO_METHOD *TlsTransport::TcpBioMethod = nullptr;
+#endif
 
 void TlsTransport::Init() {
 	openssl::init();
@@ -556,64 +987,129 @@ void TlsTransport::Init() {
 	if (TransportExIndex < 0) {
 		TransportExIndex = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
 	}
+
+#if RTC_OPENSSL_KTLS
+	if (!TcpBioMethod) {
+		TcpBioMethod = BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "TCP transport");
+		if (!TcpBioMethod)
+			throw std::runtime_error("Failed to create BIO method");
+
+		BIO_meth_set_create(TcpBioMethod, TcpBioCreate);
+		BIO_meth_set_write(TcpBioMethod, TcpBioWrite);
+		BIO_meth_set_ctrl(TcpBioMethod, TcpBioCtrl);
+	}
+#endif
 }
 
 void TlsTransport::Cleanup() {
-	// Nothing to do
-}
+	{
+		std::lock_guard lock(SharedContextsMutex);
+		for (auto &ctx : SharedContexts) {
+			SSL_CTX_free(ctx); // transports still alive hold a reference
+			ctx = nullptr;
+		}
+	}
 
-TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
-                           optional<string> host, certificate_ptr certificate,
-                           state_callback callback)
-    : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
-                std::move(callback)),
-      mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
-      mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
+#if RTC_OPENSSL_KTLS
+	BIO_meth_free(TcpBioMethod);
+	TcpBioMethod = nullptr;
+#endif
+}
 
-	PLOG_DEBUG << "Initializing TLS transport (OpenSSL)";
+SSL_CTX *TlsTransport::CreateContext(bool isClient) {
+	SSL_CTX *ctx = SSL_CTX_new(TLS_method()); // version-flexible
+	if (!ctx)
+		throw std::runtime_error("Failed to create SSL context");
 
 	try {
-		if (!(mCtx = SSL_CTX_new(TLS_method()))) // version-flexible
-			throw std::runtime_error("Failed to create SSL context");
-
-		openssl::check(SSL_CTX_set_cipher_list(mCtx, "ALL:!LOW:!EXP:!RC4:!MD5:@STRENGTH"),
+		openssl::check(SSL_CTX_set_cipher_list(ctx, "ALL:!LOW:!EXP:!RC4:!MD5:@STRENGTH"),
 		               "Failed to set SSL priorities");
 
 #if OPENSSL_VERSION_NUMBER >= 0x30000000
-		openssl::check(SSL_CTX_set1_groups_list(mCtx, "P-256"), "Failed to set SSL groups");
+		openssl::check(SSL_CTX_set1_groups_list(ctx, "P-256"), "Failed to set SSL groups");
 #else
 		auto ecdh = unique_ptr<EC_KEY, decltype(&EC_KEY_free)>(
 		    EC_KEY_new_by_curve_name(NID_X9_62_prime256v1), EC_KEY_free);
-		SSL_CTX_set_tmp_ecdh(mCtx, ecdh.get());
+		SSL_CTX_set_tmp_ecdh(ctx, ecdh.get());
 #endif
 
-		if(mIsClient) {
-			if (!SSL_CTX_set_default_verify_paths(mCtx)) {
-				PLOG_WARNING << "SSL root CA certificates unavailable";
-			}
+		if (isClient) {
+			// Sessions are cached by NewSessionCallback, keyed per transport
+			SSL_CTX_set_session_cache_mode(ctx,
+			                               SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+			SSL_CTX_sess_set_new_cb(ctx, NewSessionCallback);
+		} else {
+			// Issue stateless session tickets encrypted with the shared keys
+			SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+			SSL_CTX_set_timeout(ctx, TLS_TICKET_KEY_LIFETIME);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000
+			SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, session_ticket_key_callback);
+#else
+			SSL_CTX_set_tlsext_ticket_key_cb(ctx, session_ticket_key_callback);
+#endif
 		}
 
-		if (certificate) {
-			auto [x509, pkey] = certificate->credentials();
-			SSL_CTX_use_certificate(mCtx, x509);
-			SSL_CTX_use_PrivateKey(mCtx, pkey);
+		SSL_CTX_set_options(ctx, SSL_OP_NO_SSLv3 | SSL_OP_NO_RENEGOTIATION);
+		SSL_CTX_set_min_proto_version(ctx, TLS1_VERSION);
+		SSL_CTX_set_read_ahead(ctx, 1);
+		// Free the record buffers when there is no pending data
+		SSL_CTX_set_mode(ctx, SSL_MODE_RELEASE_BUFFERS);
+		SSL_CTX_set_quiet_shutdown(ctx, 0); // send the close_notify alert
+		SSL_CTX_set_info_callback(ctx, InfoCallback);
+		SSL_CTX_set_verify(ctx, SSL_VERIFY_NONE, NULL);
 
-			for (auto c : certificate->chain())
-				SSL_CTX_add1_chain_cert(mCtx, c); // add1 increments reference count
-		}
+	} catch (...) {
+		SSL_CTX_free(ctx);
+		throw;
+	}
 
-		SSL_CTX_set_options(mCtx, SSL_OP_NO_SSLv3 | SSL_OP_NO_RENEGOTIATION);
-		SSL_CTX_set_min_proto_version(mCtx, TLS1_VERSION);
-		SSL_CTX_set_read_ahead(mCtx, 1);
-		SSL_CTX_set_quiet_shutdown(mCtx, 0); // send the close_notify alert
-		SSL_CTX_set_info_callback(mCtx, InfoCallback);
-		SSL_CTX_set_verify(mCtx, SSL_VERIFY_NONE, NULL);
+	return ctx;
+}
+
+TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
+                           optional<string> host, certificate_ptr certificate,
+                           state_callback callback, bool enableKernelTls)
+    : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
+                std::move(callback)),
+      mHost(std::move(host)), mIsClient(std::visit([](auto l) { return l->isActive(); }, lower)),
+      mIncomingQueue(RECV_QUEUE_LIMIT, message_size_func) {
+
+	PLOG_DEBUG << "Initializing TLS transport (OpenSSL)";
+
+	try {
+		{
+			std::lock_guard lock(SharedContextsMutex);
+			auto &ctx = SharedContexts[mIsClient ? 1 : 0];
+			if (!ctx)
+				ctx = CreateContext(mIsClient);
+
+			SSL_CTX_up_ref(ctx);
+			mCtx = ctx;
+		}
 
 		if (!(mSsl = SSL_new(mCtx)))
 			throw std::runtime_error("Failed to create SSL instance");
 
 		SSL_set_ex_data(mSsl, TransportExIndex, this);
 
+		if (certificate) {
+			auto [x509, pkey] = certificate->credentials();
+			SSL_use_certificate(mSsl, x509);
+			SSL_use_PrivateKey(mSsl, pkey);
+
+			for (auto c : certificate->chain())
+				SSL_add1_chain_cert(mSsl, c); // add1 increments reference count
+
+			if (!mIsClient) {
+				// Bind sessions to the certificate so they can't be resumed on another server
+				unsigned char digest[EVP_MAX_MD_SIZE];
+				unsigned int len = 0;
+				openssl::check(X509_digest(x509, EVP_sha256(), digest, &len) &&
+				                   SSL_set_session_id_context(mSsl, digest, len),
+				               "Failed to set SSL session id context");
+			}
+		}
+
 		if (mIsClient && mHost) {
 			SSL_set_hostflags(mSsl, 0);
 #if OPENSSL_VERSION_NUMBER >= 0x40000000
@@ -623,6 +1119,7 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 #endif
 			PLOG_VERBOSE << "Server Name Indication: " << *mHost;
 			SSL_set_tlsext_host_name(mSsl, mHost->c_str());
+			mSessionCacheKey = make_session_cache_key(lower, *mHost, certificate);
 		}
 
 		if (mIsClient)
@@ -630,11 +1127,38 @@ TlsTransport::TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProx
 		else
 			SSL_set_accept_state(mSsl);
 
-		if (!(mInBio = BIO_new(BIO_s_mem())) || !(mOutBio = BIO_new(BIO_s_mem())))
+		if (!(mInBio = BIO_new(BIO_s_mem())))
 			throw std::runtime_error("Failed to create BIO");
 
 		BIO_set_mem_eof_return(mInBio, BIO_EOF);
-		BIO_set_mem_eof_return(mOutBio, BIO_EOF);
+
+#if RTC_OPENSSL_KTLS
+		auto tcpTransport = std::get_if<shared_ptr<TcpTransport>>(&lower);
+		if (enableKernelTls && tcpTransport && !kernel_tls_supported()) {
+			PLOG_WARNING << "Kernel TLS is not supported with " << OpenSSL_version(OPENSSL_VERSION);
+
+		} else if (enableKernelTls && tcpTransport) {
+			// OpenSSL passes the transmit keys to the BIO, which installs them on the socket, then
+			// writes records in plaintext. Received records are still decrypted by OpenSSL.
+			mTcpTransport = *tcpTransport;
+			if (!(mOutBio = BIO_new(TcpBioMethod)))
+				throw std::runtime_error("Failed to create BIO");
+
+			BIO_set_data(mOutBio, this);
+			SSL_set_options(mSsl, SSL_OP_ENABLE_KTLS);
+		}
+#else
+		if (enableKernelTls)
+			PLOG_WARNING << "Kernel TLS is not supported on this platform";
+#endif
+
+		if (!mOutBio) {
+			if (!(mOutBio = BIO_new(BIO_s_mem())))
+				throw std::runtime_error("Failed to create BIO");
+
+			BIO_set_mem_eof_return(mOutBio, BIO_EOF);
+		}
+
 		SSL_set_bio(mSsl, mInBio, mOutBio);
 
 	} catch (...) {
@@ -663,6 +1187,20 @@ void TlsTransport::start() {
 	int ret, err;
 	{
 		std::lock_guard lock(mSslMutex);
+		if (!mSessionCacheKey.empty()) {
+			auto &cache = SessionCache<SessionData>::Instance();
+			if (auto session = cache.take(mSessionCacheKey)) {
+				PLOG_DEBUG << "Trying to resume TLS session";
+				if (!SSL_set_session(mSsl, session->get())) // increments reference count
+					PLOG_WARNING << "Failed to set TLS session";
+
+				// Before TLS 1.3, the server might not issue a new ticket on resumption, and the
+				// session may be resumed again, so it is kept
+				if (SSL_SESSION_get_protocol_version(session->get()) < TLS1_3_VERSION)
+					cache.store(mSessionCacheKey, std::move(*session));
+			}
+		}
+
 		ret = SSL_do_handshake(mSsl);
 		err = SSL_get_error(mSsl, ret);
 		flushOutput();
@@ -687,13 +1225,30 @@ bool TlsTransport::send(message_ptr message) {
 
 	PLOG_VERBOSE << "Send size=" << message->size();
 
-	int err;
-	bool result;
+#if RTC_OPENSSL_KTLS
+	if (mKernelTls) {
+		// The kernel encrypts records, so the message is passed through without copy
+		std::lock_guard lock(mSslMutex);
+		return outgoing(std::move(message));
+	}
+#endif
+
+	int err = SSL_ERROR_NONE;
+	bool result = true;
 	{
 		std::lock_guard lock(mSslMutex);
-		int ret = SSL_write(mSsl, message->data(), int(message->size()));
-		err = SSL_get_error(mSsl, ret);
-		result = flushOutput();
+		// Write and flush a record at a time, so the output buffer stays small
+		size_t offset = 0;
+		while (offset < message->size() && err == SSL_ERROR_NONE) {
+			size_t len = std::min(message->size() - offset, size_t(SSL3_RT_MAX_PLAIN_LENGTH));
+			int ret = SSL_write(mSsl, message->data() + offset, int(len));
+			err = SSL_get_error(mSsl, ret);
+			result = flushOutput();
+			offset += len;
+		}
+
+		if (!mKernelTls)
+			release_mem_bio_buffer(mOutBio);
 	}
 
 	if (!openssl::check_error(err))
@@ -734,12 +1289,21 @@ void TlsTransport::doRecv() {
 		// Read incoming messages
 		while (mIncomingQueue.running()) {
 			auto next = mIncomingQueue.pop();
-			if (!next)
+			if (!next) {
+				// No more data for now
+				std::lock_guard lock(mSslMutex);
+				release_mem_bio_buffer(mInBio);
+				if (!mKernelTls)
+					release_mem_bio_buffer(mOutBio);
+
 				return;
+			}
 
 			message_ptr message = std::move(*next);
 			if (message->size() == 0) {
-				recv(std::move(message)); // Pass zero-sized messages through
+				// Zero-sized messages mean TCP is idle, pass them through
+				mIncomingQueue.shrink();
+				recv(std::move(message));
 				continue;
 			}
 
@@ -758,6 +1322,11 @@ void TlsTransport::doRecv() {
 
 				if (openssl::check_error(err, "Handshake failed")) {
 					PLOG_INFO << "TLS handshake finished";
+					if (SSL_session_reused(mSsl)) {
+						PLOG_DEBUG << "TLS session resumed";
+						mSessionResumed = true;
+					}
+
 					changeState(State::Connected);
 					postHandshake();
 				}
@@ -812,6 +1381,11 @@ void TlsTransport::doRecv() {
 
 bool TlsTransport::flushOutput() {
 	// Requires mSslMutex to be locked
+#if RTC_OPENSSL_KTLS
+	if (mTcpTransport)
+		return mOutgoingResult; // records are written directly by the BIO
+#endif
+
 	bool result = true;
 	const size_t bufferSize = 4096;
 	byte buffer[bufferSize];
@@ -822,6 +1396,82 @@ bool TlsTransport::flushOutput() {
 	return result;
 }
 
+int TlsTransport::NewSessionCallback(SSL *ssl, SSL_SESSION *session) {
+	TlsTransport *t =
+	    static_cast<TlsTransport *>(SSL_get_ex_data(ssl, TlsTransport::TransportExIndex));
+
+	if (t && !t->mSessionCacheKey.empty() && SSL_SESSION_is_resumable(session)) {
+		try {
+			SSL_SESSION_up_ref(session);
+			auto data = SessionData(session, SSL_SESSION_free);
+			SessionCache<SessionData>::Instance().store(t->mSessionCacheKey, std::move(data));
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "Failed to store TLS session: " << e.what();
+		}
+	}
+	return 0; // The cache holds its own reference
+}
+
+#if RTC_OPENSSL_KTLS
+int TlsTransport::TcpBioCreate(BIO *bio) {
+	BIO_set_init(bio, 1);
+	return 1;
+}
+
+int TlsTransport::TcpBioWrite(BIO *bio, const char *data, int len) {
+	// Requires mSslMutex to be locked
+	TlsTransport *t = static_cast<TlsTransport *>(BIO_get_data(bio));
+	try {
+		auto *b = reinterpret_cast<const byte *>(data);
+		auto message = t->mControlRecordType
+		                   ? make_message(b, b + len, Message::Control, *t->mControlRecordType)
+		                   : make_message(b, b + len);
+
+		t->mOutgoingResult = t->outgoing(std::move(message));
+		return len;
+
+	} catch (const std::exception &e) {
+		PLOG_WARNING << e.what();
+		return -1;
+	}
+}
+
+long TlsTransport::TcpBioCtrl(BIO *bio, int cmd, long larg, void *parg) {
+	TlsTransport *t = static_cast<TlsTransport *>(BIO_get_data(bio));
+	switch (cmd) {
+	case BIO_CTRL_FLUSH:
+		return 1; // records are never buffered
+
+	case BIO_CTRL_GET_KTLS_SEND:
+		return t->mKernelTls ? 1 : 0;
+
+	case BIO_CTRL_SET_KTLS_: {
+		if (!larg)
+			return 0; // receiving is not offloaded
+
+		auto *info = static_cast<const struct tls_crypto_info *>(parg);
+		size_t size = kernel_tls_crypto_info_size(info);
+		if (size == 0 || !t->mTcpTransport->enableKernelTls(info, size))
+			return 0; // OpenSSL falls back to encrypting records itself
+
+		t->mKernelTls = true;
+		return 1;
+	}
+
+	case BIO_CTRL_SET_KTLS_SEND_CTRL_MSG_:
+		t->mControlRecordType = int(larg);
+		return 1;
+
+	case BIO_CTRL_CLEAR_KTLS_CTRL_MSG_:
+		t->mControlRecordType.reset();
+		return 1;
+
+	default:
+		return 0;
+	}
+}
+#endif
+
 void TlsTransport::InfoCallback(const SSL *ssl, int where, int ret) {
 	TlsTransport *t =
 	    static_cast<TlsTransport *>(SSL_get_ex_data(ssl, TlsTransport::TransportExIndex));
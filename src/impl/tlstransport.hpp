@@ -31,14 +31,18 @@ public:
 	static void Cleanup();
 
 	TlsTransport(variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower,
-	             optional<string> host, certificate_ptr certificate, state_callback callback);
+	             optional<string> host, certificate_ptr certificate, state_callback callback,
+	             bool enableKernelTls = false);
 	virtual ~TlsTransport();
 
 	void start() override;
 	void stop() override;
 	bool send(message_ptr message) override;
+	bool send(message_vector &messages); // consumes the messages
 
 	bool isClient() const { return mIsClient; }
+	bool isKernelTls() const { return mKernelTls; }
+	bool isSessionResumed() const { return mSessionResumed; } // always false with Mbed TLS
 
 protected:
 	virtual void incoming(message_ptr message) override;
@@ -51,6 +55,14 @@ protected:
 	const optional<string> mHost;
 	const bool mIsClient;
 
+	// Key for the client session cache, sessions are not cached if empty
+	string mSessionCacheKey;
+
+	// With kernel TLS, the kernel encrypts outgoing records on the TCP socket
+	std::atomic<bool> mKernelTls = false;
+
+	std::atomic<bool> mSessionResumed = false;
+
 	Queue<message_ptr> mIncomingQueue;
 	std::atomic<int> mPendingRecvCount = 0;
 	std::mutex mRecvMutex;
@@ -66,6 +78,12 @@ protected:
 	static ssize_t ReadCallback(gnutls_transport_ptr_t ptr, void *data, size_t maxlen);
 	static int TimeoutCallback(gnutls_transport_ptr_t ptr, unsigned int ms);
 
+	void storeSession();
+
+	static int HandshakeHookCallback(gnutls_session_t session, unsigned int htype,
+	                                 unsigned int when, unsigned int incoming,
+	                                 const gnutls_datum_t *msg);
+
 #elif USE_MBEDTLS
 	mbedtls_ssl_config mConf;
 	mbedtls_ssl_context mSsl;
@@ -79,17 +97,38 @@ protected:
 	static int WriteCallback(void *ctx, const unsigned char *buf, size_t len);
 	static int ReadCallback(void *ctx, unsigned char *buf, size_t len);
 
+	void storeSession();
+
 #else
-	SSL_CTX *mCtx;
-	SSL *mSsl;
-	BIO *mInBio, *mOutBio;
+	SSL_CTX *mCtx = nullptr;
+	SSL *mSsl = nullptr;
+	BIO *mInBio = nullptr, *mOutBio = nullptr;
 	std::mutex mSslMutex;
 
 	bool flushOutput();
 
 	static int TransportExIndex;
 
+	// Creating a context is expensive, so transports with the same role share one, and settings
+	// specific to a connection like the certificate are applied on the SSL instance
+	static SSL_CTX *SharedContexts[2]; // server, client
+	static std::mutex SharedContextsMutex;
+	static SSL_CTX *CreateContext(bool isClient);
+
 	static void InfoCallback(const SSL *ssl, int where, int ret);
+	static int NewSessionCallback(SSL *ssl, SSL_SESSION *session);
+
+#if RTC_OPENSSL_KTLS
+	// If kernel TLS is enabled, records are written to the TCP transport with a custom BIO
+	shared_ptr<TcpTransport> mTcpTransport;
+	optional<int> mControlRecordType; // type of the control record being written
+	bool mOutgoingResult = true;
+
+	static BIO_METHOD *TcpBioMethod;
+	static int TcpBioCreate(BIO *bio);
+	static int TcpBioWrite(BIO *bio, const char *data, int len);
+	static long TcpBioCtrl(BIO *bio, int cmd, long larg, void *parg);
+#endif
 #endif
 };
 
@@ -12,6 +12,12 @@
 #include "peerconnection.hpp"
 #include "rtp.hpp"
 
+#if RTC_ENABLE_MEDIA
+#include "rtcpreceivingsession.hpp"
+#endif
+
+#include <algorithm>
+
 namespace rtc::impl {
 
 static LogCounter COUNTER_MEDIA_BAD_DIRECTION(plog::warning,
@@ -23,6 +29,8 @@ Track::Track(weak_ptr<PeerConnection> pc, Description::Media desc)
     : mPeerConnection(std::move(pc)), mMediaDescription(std::move(desc)),
       mRecvQueue(RECV_QUEUE_LIMIT, [](const message_ptr &m) { return m->size(); }) {
 
+	updateMediaState();
+
 	// Discard messages by default if track is send only
 	if (mMediaDescription.direction() == Description::Direction::SendOnly)
 		messageCallback = [](message_variant) {};
@@ -35,6 +43,8 @@ Track::~Track() {
 	} catch (const std::exception &e) {
 		PLOG_ERROR << e.what();
 	}
+
+	delete mMediaState.load();
 }
 
 string Track::mid() const {
@@ -43,8 +53,7 @@ string Track::mid() const {
 }
 
 Description::Direction Track::direction() const {
-	std::shared_lock lock(mMutex);
-	return mMediaDescription.direction();
+	return loadMediaState().direction;
 }
 
 Description::Media Track::description() const {
@@ -59,6 +68,7 @@ void Track::setDescription(Description::Media desc) {
 			throw std::logic_error("Media description mid does not match track mid");
 
 		mMediaDescription = std::move(desc);
+		updateMediaState();
 	}
 
 	if (auto handler = getMediaHandler())
@@ -134,15 +144,24 @@ void Track::incoming(message_ptr message) {
 	if (!message)
 		return;
 
-	auto dir = direction();
+	// Load the state once, the receive path must not take mMutex
+	const auto state = loadMediaState();
+	auto dir = state.direction;
 	if ((dir == Description::Direction::SendOnly || dir == Description::Direction::Inactive) &&
 	    message->type != Message::Control) {
 		COUNTER_MEDIA_BAD_DIRECTION++;
 		return;
 	}
 
+	if (message->type == Message::Control) {
+		countRtcp(*message, false);
+	} else {
+		mCounters.packetsReceived.fetch_add(1, std::memory_order_relaxed);
+		mCounters.bytesReceived.fetch_add(message->size(), std::memory_order_relaxed);
+	}
+
 	message_vector messages{std::move(message)};
-	if (auto handler = getMediaHandler()) {
+	if (const auto &handler = state.handler) {
 		try {
 			handler->incomingChain(messages, [weak_this = weak_from_this()](message_ptr m) {
 				if (auto locked = weak_this.lock()) {
@@ -155,15 +174,16 @@ void Track::incoming(message_ptr message) {
 		}
 	}
 
-	for (auto &m : messages) {
+	for (auto it = messages.begin(); it != messages.end(); ++it) {
 		// Tail drop if queue is full
-		if (mRecvQueue.full()) {
+		auto size = mRecvQueue.tryPush(std::move(*it));
+		if (!size) {
 			COUNTER_QUEUE_FULL++;
+			mCounters.packetsDiscarded.fetch_add(messages.end() - it, std::memory_order_relaxed);
 			return;
 		}
 
-		mRecvQueue.push(m);
-		triggerAvailable(mRecvQueue.size());
+		triggerAvailable(*size);
 	}
 }
 
@@ -171,13 +191,14 @@ bool Track::outgoing(message_ptr message) {
 	if (mIsClosed)
 		throw std::runtime_error("Track is closed");
 
-	auto handler = getMediaHandler();
+	const auto state = loadMediaState();
+	const auto &handler = state.handler;
 
 	// If there is no handler, the track expects RTP or RTCP packets
 	if (!handler && IsRtcp(*message))
 		message->type = Message::Control; // to allow sending RTCP packets irrelevant of direction
 
-	auto dir = direction();
+	auto dir = state.direction;
 	if ((dir == Description::Direction::RecvOnly || dir == Description::Direction::Inactive) &&
 	    message->type != Message::Control) {
 		COUNTER_MEDIA_BAD_DIRECTION++;
@@ -192,11 +213,8 @@ bool Track::outgoing(message_ptr message) {
 			}
 		});
 
-		bool ret = false;
-		for (auto &m : messages)
-			ret = transportSend(std::move(m));
-
-		return ret;
+		// Packets of a frame are sent as a batch
+		return !messages.empty() && transportSend(messages);
 
 	} else {
 		return transportSend(std::move(message));
@@ -220,7 +238,32 @@ bool Track::transportSend([[maybe_unused]] message_ptr message) {
 			message->dscp = 36; // AF42: Assured Forwarding class 4, medium drop probability
 	}
 
-	return transport->sendMedia(message);
+	countOutgoing(*message);
+	return transport->sendMedia(std::move(message));
+#else
+	throw std::runtime_error("Track is disabled (not compiled with media support)");
+#endif
+}
+
+bool Track::transportSend([[maybe_unused]] message_vector &messages) {
+#if RTC_ENABLE_MEDIA
+	shared_ptr<DtlsSrtpTransport> transport;
+	{
+		std::shared_lock lock(mMutex);
+		transport = mDtlsSrtpTransport.lock();
+		if (!transport)
+			throw std::runtime_error("Track is not open");
+
+		// Set recommended DSCP values, see transportSend(message_ptr) above
+		unsigned int dscp = mMediaDescription.type() == "audio" ? 46 : 36;
+		for (auto &message : messages)
+			message->dscp = dscp;
+	}
+
+	for (const auto &message : messages)
+		countOutgoing(*message);
+
+	return transport->sendMediaBatch(messages);
 #else
 	throw std::runtime_error("Track is disabled (not compiled with media support)");
 #endif
@@ -230,6 +273,7 @@ void Track::setMediaHandler(shared_ptr<MediaHandler> handler) {
 	{
 		std::unique_lock lock(mMutex);
 		mMediaHandler = handler;
+		updateMediaState();
 	}
 
 	if (handler)
@@ -237,8 +281,127 @@ void Track::setMediaHandler(shared_ptr<MediaHandler> handler) {
 }
 
 shared_ptr<MediaHandler> Track::getMediaHandler() {
-	std::shared_lock lock(mMutex);
-	return mMediaHandler;
+	return loadMediaState().handler;
+}
+
+Track::MediaState Track::loadMediaState() const {
+	// Registering as a reader before loading prevents the state from being freed while it is
+	// copied, see updateMediaState(). No lock is taken.
+	++mMediaStateReaders;
+	MediaState state = *mMediaState.load();
+	--mMediaStateReaders;
+	return state;
+}
+
+void Track::updateMediaState() {
+	auto state = std::make_unique<MediaState>();
+	state->direction = mMediaDescription.direction();
+	state->handler = mMediaHandler;
+	if (const MediaState *previous = mMediaState.exchange(state.release()))
+		mRetiredMediaStates.emplace_back(previous);
+
+	// A reader loads the state after registering, so if there is no reader now, later readers
+	// will get the new state and no reader can hold a retired one.
+	if (mMediaStateReaders.load() == 0)
+		mRetiredMediaStates.clear();
+}
+
+void Track::countOutgoing(const Message &message) {
+	if (message.type == Message::Control || IsRtcp(message)) {
+		countRtcp(message, true);
+	} else {
+		mCounters.packetsSent.fetch_add(1, std::memory_order_relaxed);
+		mCounters.bytesSent.fetch_add(message.size(), std::memory_order_relaxed);
+	}
+}
+
+void Track::countRtcp(const Message &message, bool outgoing) {
+	// Walk the compound packet, see https://www.rfc-editor.org/rfc/rfc3550.html#section-6.1
+	size_t offset = 0;
+	while (offset + sizeof(RtcpHeader) <= message.size()) {
+		auto header = reinterpret_cast<const RtcpHeader *>(message.data() + offset);
+		size_t length = header->lengthInBytes();
+		if (length < sizeof(RtcpHeader) || offset + length > message.size())
+			break;
+
+		uint8_t payloadType = header->payloadType();
+		uint8_t format = header->reportCount();
+		if (payloadType == 205 && format == 1) { // Generic NACK
+			(outgoing ? mCounters.nackSent : mCounters.nackReceived)++;
+		} else if (payloadType == 206 && format == 1) { // PLI
+			(outgoing ? mCounters.pliSent : mCounters.pliReceived)++;
+		} else if (payloadType == 206 && format == 4) { // FIR
+			(outgoing ? mCounters.firSent : mCounters.firReceived)++;
+		} else if (!outgoing && format > 0 && (payloadType == 200 || payloadType == 201)) {
+			const RtcpReportBlock *block = nullptr;
+			if (payloadType == 200 && length >= RtcpSr::Size(1))
+				block = reinterpret_cast<const RtcpSr *>(header)->getReportBlock(0);
+			else if (payloadType == 201 && length >= RtcpRr::SizeWithReportBlocks(1))
+				block = reinterpret_cast<const RtcpRr *>(header)->getReportBlock(0);
+
+			if (block) {
+				// The cumulative number of packets lost is a signed 24-bit value
+				uint32_t lost = block->getPacketsLostCount();
+				mCounters.remotePacketsLost = int32_t(lost << 8) >> 8;
+				mCounters.remoteJitter = block->jitter();
+				mCounters.hasRemoteReport = true;
+			}
+		}
+		offset += length;
+	}
+}
+
+TrackStats Track::stats() const {
+	TrackStats stats;
+	uint32_t clockRate = 0;
+	{
+		std::shared_lock lock(mMutex);
+		stats.mid = mMediaDescription.mid();
+		for (int pt : mMediaDescription.payloadTypes())
+			if (auto rtpMap = mMediaDescription.rtpMap(pt); rtpMap->clockRate > 0) {
+				clockRate = uint32_t(rtpMap->clockRate);
+				break;
+			}
+	}
+
+	stats.packetsSent = mCounters.packetsSent.load(std::memory_order_relaxed);
+	stats.bytesSent = mCounters.bytesSent.load(std::memory_order_relaxed);
+	stats.nackCount = mCounters.nackReceived.load(std::memory_order_relaxed);
+	stats.pliCount = mCounters.pliReceived.load(std::memory_order_relaxed);
+	stats.firCount = mCounters.firReceived.load(std::memory_order_relaxed);
+	if (mCounters.hasRemoteReport) {
+		stats.remotePacketsLost = mCounters.remotePacketsLost.load();
+		if (clockRate > 0)
+			stats.remoteJitter = double(mCounters.remoteJitter.load()) / clockRate;
+	}
+
+	stats.packetsReceived = mCounters.packetsReceived.load(std::memory_order_relaxed);
+	stats.bytesReceived = mCounters.bytesReceived.load(std::memory_order_relaxed);
+	stats.nackSent = mCounters.nackSent.load(std::memory_order_relaxed);
+	stats.pliSent = mCounters.pliSent.load(std::memory_order_relaxed);
+	stats.firSent = mCounters.firSent.load(std::memory_order_relaxed);
+	stats.packetsDiscarded = mCounters.packetsDiscarded.load(std::memory_order_relaxed);
+
+#if RTC_ENABLE_MEDIA
+	// Reception statistics are maintained by the receiving session, if any
+	for (auto handler = loadMediaState().handler; handler; handler = handler->next()) {
+		if (auto session = std::dynamic_pointer_cast<RtcpReceivingSession>(handler)) {
+			int64_t packetsLost = 0;
+			optional<double> jitter; // unknown without clock rate
+			for (const auto &source : session->getSourceStats()) {
+				packetsLost += source.packetsLost;
+				if (source.clockRate > 0)
+					jitter = std::max(jitter.value_or(0.0),
+					                  double(source.jitter) / source.clockRate);
+			}
+			stats.packetsLost = packetsLost;
+			stats.jitter = jitter;
+			break;
+		}
+	}
+#endif
+
+	return stats;
 }
 
 void Track::flushPendingMessages() {
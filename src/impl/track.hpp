@@ -14,6 +14,7 @@
 #include "description.hpp"
 #include "mediahandler.hpp"
 #include "queue.hpp"
+#include "stats.hpp"
 
 #if RTC_ENABLE_MEDIA
 #include "dtlssrtptransport.hpp"
@@ -60,10 +61,24 @@ public:
 #endif
 
 	bool transportSend(message_ptr message);
+	bool transportSend(message_vector &messages); // consumes the messages
+
+	TrackStats stats() const;
 
 	synchronized_callback<binary, FrameInfo> frameCallback;
 
 private:
+	// Read-only state for the media path, swapped atomically so packets are handled without locking
+	struct MediaState {
+		Description::Direction direction;
+		shared_ptr<MediaHandler> handler;
+	};
+
+	MediaState loadMediaState() const;
+	void updateMediaState(); // mMutex must be locked
+	void countOutgoing(const Message &message);
+	void countRtcp(const Message &message, bool outgoing);
+
 	const weak_ptr<PeerConnection> mPeerConnection;
 #if RTC_ENABLE_MEDIA
 	weak_ptr<DtlsSrtpTransport> mDtlsSrtpTransport;
@@ -72,12 +87,34 @@ private:
 	Description::Media mMediaDescription;
 	shared_ptr<MediaHandler> mMediaHandler;
 
+	// Replaced states are retired and freed by a later update once no reader is active
+	std::atomic<const MediaState *> mMediaState = nullptr;
+	mutable std::atomic<unsigned int> mMediaStateReaders = 0;
+	std::vector<unique_ptr<const MediaState>> mRetiredMediaStates; // under mMutex
+
 	mutable std::shared_mutex mMutex;
 
 	std::atomic<bool> mIsClosed = false;
 
 	Queue<message_ptr> mRecvQueue;
 
+	// Counters are updated on the media path, they are only ever read atomically
+	struct Counters {
+		std::atomic<uint64_t> packetsSent = 0;
+		std::atomic<uint64_t> bytesSent = 0;
+		std::atomic<uint64_t> nackReceived = 0;
+		std::atomic<uint64_t> pliReceived = 0;
+		std::atomic<uint64_t> firReceived = 0;
+		std::atomic<uint64_t> packetsReceived = 0;
+		std::atomic<uint64_t> bytesReceived = 0;
+		std::atomic<uint64_t> nackSent = 0;
+		std::atomic<uint64_t> pliSent = 0;
+		std::atomic<uint64_t> firSent = 0;
+		std::atomic<uint64_t> packetsDiscarded = 0;
+		std::atomic<bool> hasRemoteReport = false;
+		std::atomic<int32_t> remotePacketsLost = 0;
+		std::atomic<uint32_t> remoteJitter = 0; // in timestamp units
+	} mCounters;
 };
 
 } // namespace rtc::impl
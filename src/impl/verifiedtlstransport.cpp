@@ -8,6 +8,8 @@
 
 #include "verifiedtlstransport.hpp"
 #include "common.hpp"
+#include "sha.hpp"
+#include "utils.hpp"
 
 #if RTC_ENABLE_WEBSOCKET
 
@@ -15,13 +17,43 @@ namespace rtc::impl {
 
 static const string PemBeginCertificateTag = "-----BEGIN CERTIFICATE-----";
 
+#if !USE_GNUTLS && !USE_MBEDTLS
+namespace {
+
+// Loading the root CA certificates is expensive, so the default store is shared by transports
+X509_STORE *default_cert_store() {
+	static std::mutex mutex;
+	static shared_ptr<X509_STORE> store;
+
+	std::lock_guard lock(mutex);
+	if (!store) {
+		store = shared_ptr<X509_STORE>(X509_STORE_new(), X509_STORE_free);
+		if (!store)
+			throw std::runtime_error("Failed to create certificate store");
+
+		if (!X509_STORE_set_default_paths(store.get()))
+			PLOG_WARNING << "SSL root CA certificates unavailable";
+	}
+	return store.get();
+}
+
+} // namespace
+#endif
+
 VerifiedTlsTransport::VerifiedTlsTransport(
     variant<shared_ptr<TcpTransport>, shared_ptr<HttpProxyTransport>> lower, string host,
-    certificate_ptr certificate, state_callback callback, [[maybe_unused]] optional<string> cacert)
-    : TlsTransport(std::move(lower), std::move(host), std::move(certificate), std::move(callback)) {
+    certificate_ptr certificate, state_callback callback, [[maybe_unused]] optional<string> cacert,
+    bool enableKernelTls)
+    : TlsTransport(std::move(lower), std::move(host), std::move(certificate), std::move(callback),
+                   enableKernelTls) {
 
 	PLOG_DEBUG << "Setting up TLS certificate verification";
 
+	// Never resume a session established without the same verification, i.e. with another CA
+	mSessionCacheKey += "|verified";
+	if (cacert)
+		mSessionCacheKey += '|' + utils::base64_encode(Sha1(*cacert));
+
 #if USE_GNUTLS
 	gnutls_session_set_verify_cert(mSession, mHost->c_str(), 0);
 #elif USE_MBEDTLS
@@ -45,20 +77,32 @@ VerifiedTlsTransport::VerifiedTlsTransport(
 		throw;
 	}
 #else
+	// The SSL context is shared, so the store is set on the SSL instance
 	if (cacert) {
+		auto store = unique_ptr<X509_STORE, decltype(&X509_STORE_free)>(X509_STORE_new(),
+		                                                                 X509_STORE_free);
+		if (!store)
+			throw std::runtime_error("Failed to create certificate store");
+
+		if (!X509_STORE_set_default_paths(store.get()))
+			PLOG_WARNING << "SSL root CA certificates unavailable";
+
 		if (cacert->find(PemBeginCertificateTag) == string::npos) {
 			// *cacert is a file path
-			openssl::check(SSL_CTX_load_verify_locations(mCtx, cacert->c_str(), NULL),
+			openssl::check(X509_STORE_load_locations(store.get(), cacert->c_str(), NULL),
 			               "Failed to load CA certificate");
 		} else {
 			// *cacert is a PEM content
 			try {
-				openssl::SSL_CTX_add_cert_to_store_from_pem(mCtx, *cacert);
+				openssl::X509_STORE_add_cert_from_pem(store.get(), *cacert);
 			} catch (std::exception const &e) {
 				throw std::runtime_error("Failed to add CA certificate to store: " +
 				                         std::string(e.what()));
 			}
 		}
+		SSL_set1_verify_cert_store(mSsl, store.get()); // set1 increments reference count
+	} else {
+		SSL_set1_verify_cert_store(mSsl, default_cert_store());
 	}
 	SSL_set_verify(mSsl, SSL_VERIFY_PEER, NULL);
 	SSL_set_verify_depth(mSsl, 4);
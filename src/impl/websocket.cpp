@@ -11,7 +11,9 @@
 #include "websocket.hpp"
 #include "common.hpp"
 #include "internals.hpp"
+#include "pollservice.hpp"
 #include "processor.hpp"
+#include "threadpool.hpp"
 #include "utils.hpp"
 
 #include "httpproxytransport.hpp"
@@ -186,7 +188,54 @@ bool WebSocket::outgoing(message_ptr message) {
 	if (message->size() > maxMessageSize())
 		throw std::runtime_error("Message size exceeds limit");
 
-	return mWsTransport->send(std::move(message));
+	if (mStreaming)
+		throw std::runtime_error("A message is being streamed");
+
+	if (!waitBufferedAmount(message->size()))
+		return false;
+
+	auto transport = std::atomic_load(&mWsTransport);
+	if (!transport)
+		throw std::runtime_error("WebSocket is not open");
+
+	return transport->send(std::move(message));
+}
+
+bool WebSocket::outgoingEncoded(message_ptr frame) {
+	if (state != State::Open || !mWsTransport)
+		throw std::runtime_error("WebSocket is not open");
+
+	if (mStreaming)
+		throw std::runtime_error("A message is being streamed");
+
+	if (!waitBufferedAmount(frame->size()))
+		return false;
+
+	auto transport = std::atomic_load(&mWsTransport);
+	if (!transport)
+		throw std::runtime_error("WebSocket is not open");
+
+	transport->sendEncodedFrame(std::move(frame)); // false only means buffered
+	return true;
+}
+
+void WebSocket::outgoingStream(std::function<optional<binary>()> producer) {
+	if (state != State::Open || !mWsTransport)
+		throw std::runtime_error("WebSocket is not open");
+
+	if (!producer)
+		throw std::invalid_argument("Stream producer is empty");
+
+	if (mStreaming.exchange(true))
+		throw std::runtime_error("A message is already being streamed");
+
+	{
+		std::lock_guard lock(mStreamMutex);
+		mStreamProducer = std::move(producer);
+		mStreamStarted = false;
+	}
+
+	scheduleStream();
 }
 
 void WebSocket::incoming(message_ptr message) {
@@ -198,9 +247,24 @@ void WebSocket::incoming(message_ptr message) {
 	if (message->type == Message::String || message->type == Message::Binary) {
 		mRecvQueue.push(std::move(message));
 		triggerAvailable(mRecvQueue.size());
+	} else if (message->type == Message::Control && message->size() == 0) {
+		mRecvQueue.shrink(); // the transport is idle
 	}
 }
 
+void WebSocket::triggerBufferedAmount(size_t amount) {
+	// Called synchronously by the TCP transport, so sending is not possible here
+	Channel::triggerBufferedAmount(amount);
+
+	if (config.maxBufferedAmount.value_or(0) > 0) {
+		std::lock_guard lock(mBufferedAmountMutex);
+		mBufferedAmountCondition.notify_all();
+	}
+
+	if (mStreaming && amount < streamBufferSize())
+		scheduleStream();
+}
+
 // Helper for WebSocket::initXTransport methods: start and emplace the transport
 template <typename T>
 shared_ptr<T> emplaceTransport(WebSocket *ws, shared_ptr<T> *member, shared_ptr<T> transport) {
@@ -385,12 +449,12 @@ shared_ptr<TlsTransport> WebSocket::initTlsTransport() {
 
 		shared_ptr<TlsTransport> transport;
 		if (verify)
-			transport = std::make_shared<VerifiedTlsTransport>(lower, mHostname.value(),
-			                                                   mCertificate, stateChangeCallback,
-			                                                   config.caCertificatePemFile);
+			transport = std::make_shared<VerifiedTlsTransport>(
+			    lower, mHostname.value(), mCertificate, stateChangeCallback,
+			    config.caCertificatePemFile, config.enableKernelTls);
 		else
-			transport =
-			    std::make_shared<TlsTransport>(lower, mHostname, mCertificate, stateChangeCallback);
+			transport = std::make_shared<TlsTransport>(lower, mHostname, mCertificate,
+			                                           stateChangeCallback, config.enableKernelTls);
 
 		return emplaceTransport(this, &mTlsTransport, std::move(transport));
 
@@ -501,6 +565,15 @@ void WebSocket::closeTransports() {
 	if (ws)
 		ws->onRecv(nullptr);
 
+	// Wake up blocked senders and release the stream producer
+	{
+		std::lock_guard lock(mBufferedAmountMutex);
+		mBufferedAmountCondition.notify_all();
+	}
+
+	if (mStreaming)
+		scheduleStream();
+
 	if (tcp)
 		tcp->onBufferedAmount(nullptr);
 
@@ -543,6 +616,94 @@ void WebSocket::scheduleConnectionTimeout() {
 	}
 }
 
+bool WebSocket::waitBufferedAmount(size_t size) {
+	const size_t limit = config.maxBufferedAmount.value_or(0);
+	auto fits = [this, limit, size]() {
+		// A message larger than the limit is accepted on an empty buffer
+		size_t amount = bufferedAmount.load();
+		return limit == 0 || amount == 0 || amount + size <= limit;
+	};
+
+	if (fits())
+		return true;
+
+	if (config.sendBufferPolicy == SendBufferPolicy::Drop) {
+		PLOG_DEBUG << "WebSocket send buffer is full, dropping message";
+		return false;
+	}
+
+	if (PollService::Instance().isPollThread()) {
+		PLOG_WARNING << "Unable to wait for the WebSocket send buffer in the poll thread, "
+		                "dropping message";
+		return false;
+	}
+
+	std::unique_lock lock(mBufferedAmountMutex);
+	mBufferedAmountCondition.wait(lock, [&]() { return fits() || state != State::Open; });
+	if (state != State::Open)
+		throw std::runtime_error("WebSocket is not open");
+
+	return true;
+}
+
+size_t WebSocket::streamBufferSize() const {
+	const size_t limit = config.maxBufferedAmount.value_or(0);
+	return limit > 0 ? std::min(limit, WS_STREAM_BUFFER_SIZE) : WS_STREAM_BUFFER_SIZE;
+}
+
+void WebSocket::scheduleStream() {
+	if (!mStreamScheduled.exchange(true))
+		ThreadPool::Instance().enqueue(weak_bind(&WebSocket::processStream, this));
+}
+
+void WebSocket::processStream() {
+	// Scheduled once at a time, so fragments are produced in order
+	const size_t bufferSize = streamBufferSize();
+	{
+		std::lock_guard lock(mStreamMutex);
+		try {
+			while (mStreamProducer && bufferedAmount.load() < bufferSize) {
+				auto transport = std::atomic_load(&mWsTransport);
+				if (state != State::Open || !transport) {
+					PLOG_DEBUG << "WebSocket closed while streaming a message";
+					mStreamProducer = nullptr;
+					mStreaming = false;
+					break;
+				}
+
+				auto chunk = mStreamProducer();
+				bool fin = !chunk.has_value();
+				auto fragment = make_message(fin ? binary() : std::move(*chunk));
+				bool first = !std::exchange(mStreamStarted, true);
+
+				// An empty final fragment ends the message, as its size is not known in advance
+				transport->sendFragment(std::move(fragment), first, fin);
+
+				if (fin) {
+					mStreamProducer = nullptr;
+					mStreaming = false;
+				}
+			}
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "WebSocket stream failed: " << e.what();
+			mStreamProducer = nullptr;
+			mStreaming = false;
+
+			// The message is incomplete, so the connection is unusable
+			if (mStreamStarted && state == State::Open) {
+				triggerError(string("Stream failed: ") + e.what());
+				close();
+			}
+		}
+	}
+
+	mStreamScheduled = false;
+
+	// Check again as a change of buffered amount might have been missed
+	if (mStreaming && (bufferedAmount.load() < bufferSize || state != State::Open))
+		scheduleStream();
+}
+
 } // namespace rtc::impl
 
 #endif
@@ -24,6 +24,9 @@
 #include "rtc/websocket.hpp"
 
 #include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <thread>
 
 namespace rtc::impl {
@@ -39,8 +42,12 @@ struct WebSocket final : public Channel, public std::enable_shared_from_this<Web
 	void close();
 	void remoteClose();
 	bool outgoing(message_ptr message);
+	bool outgoingEncoded(message_ptr frame); // returns false if dropped, not only buffered
+	void outgoingStream(std::function<optional<binary>()> producer);
 	void incoming(message_ptr message);
 
+	void triggerBufferedAmount(size_t amount) override;
+
 	optional<message_variant> receive() override;
 	optional<message_variant> peek() override;
 	size_t availableAmount() const override;
@@ -71,6 +78,11 @@ private:
 
 	void scheduleConnectionTimeout();
 
+	bool waitBufferedAmount(size_t size); // returns false if the message must be dropped
+	size_t streamBufferSize() const;
+	void scheduleStream();
+	void processStream();
+
 	const init_token mInitToken = Init::Instance().token();
 
 	certificate_ptr mCertificate;
@@ -86,6 +98,16 @@ private:
 	shared_ptr<WsHandshake> mWsHandshake;
 
 	Queue<message_ptr> mRecvQueue;
+
+	std::mutex mBufferedAmountMutex;
+	std::condition_variable mBufferedAmountCondition;
+
+	// Streamed message, fragments are produced on the thread pool as the send buffer drains
+	std::function<optional<binary>()> mStreamProducer;
+	bool mStreamStarted = false;
+	std::atomic<bool> mStreaming = false;
+	std::atomic<bool> mStreamScheduled = false;
+	std::mutex mStreamMutex;
 };
 
 } // namespace rtc::impl
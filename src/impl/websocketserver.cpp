@@ -11,9 +11,12 @@
 #include "websocketserver.hpp"
 #include "common.hpp"
 #include "internals.hpp"
+#include "pollservice.hpp"
 #include "threadpool.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
+
 namespace rtc::impl {
 
 using namespace std::placeholders;
@@ -46,11 +49,15 @@ WebSocketServer::WebSocketServer(Configuration config_)
 	if (config.bindAddress) {
 		bindAddress = config.bindAddress->c_str();
 	}
-	// Create TCP server
-	tcpServer = std::make_unique<TcpServer>(config.port, bindAddress);
-
-	// Create server thread
-	mThread = std::thread(&WebSocketServer::runLoop, this);
+	// Create TCP servers, one per accept thread if SO_REUSEPORT is supported
+	const unsigned int threadCount = std::max(config.acceptThreads, 1u);
+	const bool reusePort = threadCount > 1 && TcpServer::IsReusePortSupported();
+	tcpServers.push_back(std::make_unique<TcpServer>(config.port, bindAddress, reusePort));
+	if (reusePort) {
+		const uint16_t port = tcpServers.front()->port(); // resolved if automatic
+		while (tcpServers.size() < threadCount)
+			tcpServers.push_back(std::make_unique<TcpServer>(port, bindAddress, true));
+	}
 }
 
 WebSocketServer::~WebSocketServer() {
@@ -58,38 +65,52 @@ WebSocketServer::~WebSocketServer() {
 	stop();
 }
 
+void WebSocketServer::start() {
+	if (PollService::Instance().isExternal()) {
+		// Accept in the poll service instead of blocking in threads
+		PLOG_DEBUG << "Starting WebSocketServer in the external event loop";
+		for (auto &tcpServer : tcpServers)
+			tcpServer->setPendingCallback(
+			    weak_bind(&WebSocketServer::processPending, this, tcpServer.get()));
+
+		return;
+	}
+
+	// Create server threads, sharing the TCP server if there is only one
+	const unsigned int threadCount = std::max(config.acceptThreads, 1u);
+	PLOG_DEBUG << "Starting " << threadCount << " WebSocketServer accept threads";
+	for (unsigned int i = 0; i < threadCount; ++i)
+		mThreads.emplace_back(&WebSocketServer::runLoop, this,
+		                      tcpServers[i % tcpServers.size()].get());
+}
+
 void WebSocketServer::stop() {
 	if (mStopped.exchange(true))
 		return;
 
-	PLOG_DEBUG << "Stopping WebSocketServer thread";
-	tcpServer->close();
-	mThread.join();
+	PLOG_DEBUG << "Stopping WebSocketServer threads";
+	for (auto &tcpServer : tcpServers)
+		tcpServer->close();
+
+	for (auto &thread : mThreads)
+		thread.join();
 }
 
-void WebSocketServer::runLoop() {
+message_ptr WebSocketServer::encodeFrame(message_ptr message) const {
+	if (message->size() > config.maxMessageSize.value_or(DEFAULT_WS_MAX_MESSAGE_SIZE))
+		throw std::runtime_error("Message size exceeds limit");
+
+	return WsTransport::EncodeFrame(*message);
+}
+
+void WebSocketServer::runLoop(TcpServer *tcpServer) {
 	utils::this_thread::set_name("RTC server");
 	PLOG_INFO << "Starting WebSocketServer";
 
 	try {
-		while (auto incoming = tcpServer->accept()) {
-			try {
-				if (!clientCallback)
-					continue;
-
-				WebSocket::Configuration clientConfig;
-				clientConfig.connectionTimeout = config.connectionTimeout;
-				clientConfig.maxMessageSize = config.maxMessageSize;
-
-				auto impl = std::make_shared<WebSocket>(std::move(clientConfig), mCertificate);
-				impl->changeState(WebSocket::State::Connecting);
-				impl->setTcpTransport(incoming);
-				clientCallback(std::make_shared<rtc::WebSocket>(impl));
-
-			} catch (const std::exception &e) {
-				PLOG_ERROR << "WebSocketServer: " << e.what();
-			}
-		}
+		while (auto incoming = tcpServer->accept())
+			handleIncoming(std::move(incoming));
+
 	} catch (const std::exception &e) {
 		PLOG_FATAL << "WebSocketServer: " << e.what();
 	}
@@ -97,6 +118,40 @@ void WebSocketServer::runLoop() {
 	PLOG_INFO << "Stopped WebSocketServer";
 }
 
+void WebSocketServer::processPending(TcpServer *tcpServer) {
+	try {
+		while (auto incoming = tcpServer->tryAccept())
+			handleIncoming(std::move(incoming));
+
+	} catch (const std::exception &e) {
+		PLOG_ERROR << "WebSocketServer: " << e.what();
+	}
+}
+
+void WebSocketServer::handleIncoming(shared_ptr<TcpTransport> incoming) {
+	try {
+		if (!clientCallback)
+			return;
+
+		WebSocket::Configuration clientConfig;
+		clientConfig.connectionTimeout = config.connectionTimeout;
+		clientConfig.maxMessageSize = config.maxMessageSize;
+		clientConfig.enableKernelTls = config.enableKernelTls;
+		clientConfig.maxBufferedAmount = config.maxBufferedAmount;
+		clientConfig.sendBufferPolicy = config.sendBufferPolicy;
+
+		auto impl = std::make_shared<WebSocket>(std::move(clientConfig), mCertificate);
+		impl->changeState(WebSocket::State::Connecting);
+		impl->setTcpTransport(incoming);
+
+		// Accept threads may get here concurrently, the callback serializes calls with its mutex
+		clientCallback(std::make_shared<rtc::WebSocket>(impl));
+
+	} catch (const std::exception &e) {
+		PLOG_ERROR << "WebSocketServer: " << e.what();
+	}
+}
+
 } // namespace rtc::impl
 
 #endif
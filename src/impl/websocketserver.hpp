@@ -23,6 +23,7 @@
 
 #include <atomic>
 #include <thread>
+#include <vector>
 
 namespace rtc::impl {
 
@@ -32,19 +33,23 @@ struct WebSocketServer final : public std::enable_shared_from_this<WebSocketServ
 	WebSocketServer(Configuration config_);
 	~WebSocketServer();
 
+	void start();
 	void stop();
+	message_ptr encodeFrame(message_ptr message) const;
 
 	const Configuration config;
-	unique_ptr<TcpServer> tcpServer;
+	std::vector<unique_ptr<TcpServer>> tcpServers; // one per accept thread with SO_REUSEPORT
 	synchronized_callback<shared_ptr<rtc::WebSocket>> clientCallback;
 
 private:
 	const init_token mInitToken = Init::Instance().token();
 
-	void runLoop();
+	void runLoop(TcpServer *tcpServer);
+	void processPending(TcpServer *tcpServer);
+	void handleIncoming(shared_ptr<TcpTransport> incoming);
 
 	certificate_ptr mCertificate;
-	std::thread mThread;
+	std::vector<std::thread> mThreads;
 	std::atomic<bool> mStopped;
 };
 
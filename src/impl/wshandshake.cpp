@@ -19,7 +19,6 @@
 #include <climits>
 #include <iostream>
 #include <random>
-#include <sstream>
 
 using std::string;
 
@@ -67,7 +66,17 @@ std::vector<string> WsHandshake::protocols() const {
 
 http_headers WsHandshake::requestHeaders() const {
 	std::unique_lock lock(mMutex);
-	return mRequestHeaders;
+	if (mRequestHead.empty())
+		return mRequestHeaders;
+
+	HttpParser parser(HttpParser::Type::Request);
+	parser.parse(reinterpret_cast<const byte *>(mRequestHead.data()), mRequestHead.size());
+
+	http_headers headers;
+	parser.forEachHeader([&headers](std::string_view name, std::string_view value) {
+		headers.emplace(string(name), string(value));
+	});
+	return headers;
 }
 
 string WsHandshake::generateHttpRequest() {
@@ -127,6 +136,8 @@ string GetHttpErrorName(int responseCode) {
 		return "Method Not Allowed";
 	case 426:
 		return "Upgrade Required";
+	case 431:
+		return "Request Header Fields Too Large";
 	case 500:
 		return "Internal Server Error";
 	default:
@@ -159,97 +170,88 @@ size_t WsHandshake::parseHttpRequest(const byte *buffer, size_t size) {
 		throw RequestError("Invalid HTTP request for WebSocket", 400);
 
 	std::unique_lock lock(mMutex);
-	std::list<string> lines;
-	size_t length = parseHttpLines(buffer, size, lines);
+	if (!mParser)
+		mParser.emplace(HttpParser::Type::Request);
+
+	size_t length;
+	try {
+		length = mParser->parse(buffer, size);
+	} catch (const HttpParser::Error &e) {
+		throw RequestError(e.what(), e.responseCode());
+	}
+
 	if (length == 0)
 		return 0;
 
-	if (lines.empty())
-		throw RequestError("Invalid HTTP request for WebSocket", 400);
-
-	std::istringstream requestLine(std::move(lines.front()));
-	lines.pop_front();
-
-	string method, path, protocol;
-	requestLine >> method >> path >> protocol;
+	auto method = mParser->method();
+	auto path = mParser->target();
 	PLOG_DEBUG << "WebSocket request method=\"" << method << "\", path=\"" << path << "\"";
 	if (method != "GET")
-		throw RequestError("Invalid request method \"" + method + "\" for WebSocket", 405);
-
-	mPath = std::move(path);
+		throw RequestError("Invalid request method \"" + string(method) + "\" for WebSocket", 405);
 
-	auto headers = parseHttpHeaders(lines);
-
-	auto h = headers.find("host");
-	if (h == headers.end())
+	auto host = mParser->header("host");
+	if (!host)
 		throw RequestError("WebSocket host header missing in request", 400);
 
-	mHost = std::move(h->second);
-
-	h = headers.find("upgrade");
-	if (h == headers.end())
+	auto upgrade = mParser->header("upgrade");
+	if (!upgrade)
 		throw RequestError("WebSocket upgrade header missing in request", 426);
 
-	string upgrade;
-	std::transform(h->second.begin(), h->second.end(), std::back_inserter(upgrade),
-	               [](char c) { return std::tolower(c); });
-	if (upgrade != "websocket")
+	if (!httpTokenEquals(*upgrade, "websocket"))
 		throw RequestError("WebSocket upgrade header mismatching", 426);
 
-	h = headers.find("sec-websocket-key");
-	if (h == headers.end())
+	auto key = mParser->header("sec-websocket-key");
+	if (!key)
 		throw RequestError("WebSocket key header missing in request", 400);
 
-	mKey = std::move(h->second);
+	mPath = string(path);
+	mHost = string(*host);
+	mKey = string(*key);
 
-	h = headers.find("sec-websocket-protocol");
-	if (h != headers.end())
-		mProtocols = utils::explode(h->second, ',');
-
-	mRequestHeaders = std::move(headers);
+	if (auto protocol = mParser->header("sec-websocket-protocol"))
+		mProtocols = utils::explode(string(*protocol), ',');
 
+	// Keep the raw head only, headers are rarely requested
+	mRequestHead.assign(reinterpret_cast<const char *>(buffer), length);
+	mParser.reset();
 	return length;
 }
 
 size_t WsHandshake::parseHttpResponse(const byte *buffer, size_t size) {
 	std::unique_lock lock(mMutex);
-	std::list<string> lines;
-	size_t length = parseHttpLines(buffer, size, lines);
+	if (!mParser)
+		mParser.emplace(HttpParser::Type::Response);
+
+	size_t length;
+	try {
+		length = mParser->parse(buffer, size);
+	} catch (const HttpParser::Error &e) {
+		throw Error(e.what());
+	}
+
 	if (length == 0)
 		return 0;
 
-	if (lines.empty())
-		throw Error("Invalid HTTP response for WebSocket");
-
-	std::istringstream status(std::move(lines.front()));
-	lines.pop_front();
-
-	string protocol;
-	unsigned int code = 0;
-	status >> protocol >> code;
+	unsigned int code = mParser->statusCode();
 	PLOG_DEBUG << "WebSocket response code=" << code;
 	if (code != 101)
 		throw std::runtime_error("Unexpected response code " + to_string(code) + " for WebSocket");
 
-	auto headers = parseHttpHeaders(lines);
-
-	auto h = headers.find("upgrade");
-	if (h == headers.end())
+	auto upgrade = mParser->header("upgrade");
+	if (!upgrade)
 		throw Error("WebSocket update header missing");
 
-	string upgrade;
-	std::transform(h->second.begin(), h->second.end(), std::back_inserter(upgrade),
-	               [](char c) { return std::tolower(c); });
-	if (upgrade != "websocket")
+	if (!httpTokenEquals(*upgrade, "websocket"))
 		throw Error("WebSocket update header mismatching");
 
-	h = headers.find("sec-websocket-accept");
-	if (h == headers.end())
+	auto accept = mParser->header("sec-websocket-accept");
+	if (!accept)
 		throw Error("WebSocket accept header missing");
 
-	if (h->second != computeAcceptKey(mKey))
+	if (*accept != computeAcceptKey(mKey))
 		throw Error("WebSocket accept header is invalid");
 
+	mParser.reset();
 	return length;
 }
 
@@ -14,7 +14,6 @@
 
 #if RTC_ENABLE_WEBSOCKET
 
-#include <list>
 #include <map>
 #include <stdexcept>
 #include <vector>
@@ -60,8 +59,10 @@ private:
 	string mHost;
 	string mPath;
 	std::vector<string> mProtocols;
-	http_headers mRequestHeaders;
+	http_headers mRequestHeaders; // client-side only
+	string mRequestHead;          // server-side only, headers are parsed again on demand
 	string mKey;
+	optional<HttpParser> mParser;
 	mutable std::mutex mMutex;
 };
 
@@ -49,6 +49,12 @@ WsTransport::WsTransport(LowerTransport lower, shared_ptr<WsHandshake> handshake
     : Transport(std::visit([](auto l) { return std::static_pointer_cast<Transport>(l); }, lower),
                 std::move(stateCallback)),
       mHandshake(std::move(handshake)),
+      mTcpTransport(std::holds_alternative<shared_ptr<TcpTransport>>(lower)
+                        ? std::get<shared_ptr<TcpTransport>>(lower)
+                        : nullptr),
+      mTlsTransport(std::holds_alternative<shared_ptr<TlsTransport>>(lower)
+                        ? std::get<shared_ptr<TlsTransport>>(lower)
+                        : nullptr),
       mIsClient(
           std::visit(rtc::overloaded{[](auto l) { return l->isActive(); },
                                      [](shared_ptr<TlsTransport> l) { return l->isClient(); }},
@@ -82,7 +88,47 @@ bool WsTransport::send(message_ptr message) {
 
 	PLOG_VERBOSE << "Send size=" << message->size();
 	return sendFrame({message->type == Message::String ? TEXT_FRAME : BINARY_FRAME, message->data(),
-	                  message->size(), true, mIsClient});
+	                  message->size(), true, mIsClient},
+	                 message);
+}
+
+message_ptr WsTransport::EncodeFrame(const Message &message) {
+	Frame frame;
+	frame.opcode = message.type == Message::String ? TEXT_FRAME : BINARY_FRAME;
+	frame.length = message.size();
+	frame.mask = false; // server frames are not masked
+
+	byte buffer[10];
+	const size_t length = WriteFrameHeader(frame, buffer);
+	auto encoded = make_message(length + message.size());
+	std::copy(buffer, buffer + length, encoded->begin());
+	std::copy(message.begin(), message.end(), encoded->begin() + length);
+	return encoded;
+}
+
+bool WsTransport::sendEncodedFrame(message_ptr frame) {
+	if (state() != State::Connected)
+		throw std::runtime_error("WebSocket is not open");
+
+	if (mIsClient)
+		throw std::logic_error("Encoded frames can't be sent by a client");
+
+	std::lock_guard lock(mSendMutex);
+	PLOG_VERBOSE << "WebSocket sending encoded frame: size=" << frame->size();
+
+	// The frame is shared, it is passed down as is and never modified
+	return outgoing(std::move(frame));
+}
+
+bool WsTransport::sendFragment(message_ptr fragment, bool first, bool fin) {
+	if (state() != State::Connected)
+		throw std::runtime_error("WebSocket is not open");
+
+	PLOG_VERBOSE << "Send fragment size=" << fragment->size() << ", fin=" << fin;
+	Opcode opcode = !first                              ? CONTINUATION
+	                : fragment->type == Message::String ? TEXT_FRAME
+	                                                    : BINARY_FRAME;
+	return sendFrame({opcode, fragment->data(), fragment->size(), fin, mIsClient}, fragment);
 }
 
 void WsTransport::close() {
@@ -146,27 +192,48 @@ void WsTransport::incoming(message_ptr message) {
 					uint32_t dummy = 0;
 					sendFrame({PING, reinterpret_cast<byte *>(&dummy), 4, true, mIsClient});
 					addOutstandingPing();
+
+					// Let the WebSocket release its idle buffers
+					recv(make_message(0, Message::Control));
 				} else {
 					if (mIgnoreLength > 0) {
 						size_t len = std::min(mIgnoreLength, mBuffer.size());
 						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
 						mIgnoreLength -= len;
 					}
-					if (mIgnoreLength == 0) {
+					while (mIgnoreLength == 0) {
 						Frame frame;
-						while (size_t len = parseFrame(mBuffer.data(), mBuffer.size(), frame)) {
-							recvFrame(frame);
-							if (len > mBuffer.size()) {
-								mIgnoreLength = len - mBuffer.size();
-								mBuffer.clear();
-								break;
-							}
-							mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
+						size_t len = parseFrame(mBuffer.data(), mBuffer.size(), frame);
+						if (len == 0) {
+							// The frame is incomplete, reserve room for its beginning rather than
+							// growing the buffer for each chunk. The reservation is capped, as
+							// the announced length is not proof that the payload will follow.
+							const size_t maxHeaderLength = 14;
+							if (frame.length > 0)
+								mBuffer.reserve(maxHeaderLength +
+								                std::min(frame.length, WS_FRAME_RESERVE_SIZE));
+							break;
+						}
+
+						// If the frame fills the buffer, the buffer can be passed as the message
+						recvFrame(frame, len == mBuffer.size() ? &mBuffer : nullptr);
+						if (mBuffer.empty())
+							break;
+
+						if (len > mBuffer.size()) {
+							mIgnoreLength = len - mBuffer.size();
+							mBuffer.clear();
+							break;
 						}
+						mBuffer.erase(mBuffer.begin(), mBuffer.begin() + len);
 					}
 				}
 			}
 
+			// Release the buffer while waiting for more data
+			if (mBuffer.empty())
+				binary().swap(mBuffer);
+
 			return;
 
 		} catch (const WsHandshake::RequestError &e) {
@@ -297,7 +364,7 @@ size_t WsTransport::parseFrame(byte *buffer, size_t size, Frame &frame) {
 	return frame.payload + length - buffer; // can be more than buffer size
 }
 
-void WsTransport::recvFrame(const Frame &frame) {
+void WsTransport::recvFrame(const Frame &frame, binary *buffer) {
 	PLOG_DEBUG << "WebSocket received frame: opcode=" << int(frame.opcode)
 	           << ", length=" << frame.length;
 
@@ -314,15 +381,22 @@ void WsTransport::recvFrame(const Frame &frame) {
 			             << (mPartialOpcode == TEXT_FRAME ? "text" : "binary")
 			             << ", size=" << mPartial.size();
 			auto type = mPartialOpcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(mPartial.begin(), mPartial.end(), type));
-			mPartial.clear();
+			recv(make_message(std::exchange(mPartial, binary()), type));
 		}
 		mPartialOpcode = frame.opcode;
 		if (frame.fin) {
 			PLOG_DEBUG << "WebSocket finished message: type="
 			           << (frame.opcode == TEXT_FRAME ? "text" : "binary") << ", size=" << size;
 			auto type = frame.opcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(frame.payload, frame.payload + size, type));
+			if (buffer && size == frame.length) {
+				// Strip the header in place rather than copying the payload to a new message, the
+				// buffer might still contain the ignored end of a truncated frame
+				buffer->erase(buffer->begin(), buffer->begin() + (frame.payload - buffer->data()));
+				buffer->resize(size);
+				recv(make_message(std::exchange(*buffer, binary()), type));
+			} else {
+				recv(make_message(frame.payload, frame.payload + size, type));
+			}
 		} else {
 			mPartial.insert(mPartial.end(), frame.payload, frame.payload + size);
 		}
@@ -339,8 +413,7 @@ void WsTransport::recvFrame(const Frame &frame) {
 			           << (frame.opcode == TEXT_FRAME ? "text" : "binary")
 			           << ", size=" << mPartial.size();
 			auto type = mPartialOpcode == TEXT_FRAME ? Message::String : Message::Binary;
-			recv(make_message(mPartial.begin(), mPartial.end(), type));
-			mPartial.clear();
+			recv(make_message(std::exchange(mPartial, binary()), type));
 		}
 		break;
 	}
@@ -368,28 +441,14 @@ void WsTransport::recvFrame(const Frame &frame) {
 	}
 }
 
-bool WsTransport::sendFrame(const Frame &frame) {
+bool WsTransport::sendFrame(const Frame &frame, message_ptr payload) {
 	std::lock_guard lock(mSendMutex);
 
 	PLOG_DEBUG << "WebSocket sending frame: opcode=" << int(frame.opcode)
 	           << ", length=" << frame.length;
 
 	byte buffer[14];
-	byte *cur = buffer;
-
-	*cur++ = byte((frame.opcode & 0x0F) | (frame.fin ? 0x80 : 0));
-
-	if (frame.length < 0x7E) {
-		*cur++ = byte((frame.length & 0x7F) | (frame.mask ? 0x80 : 0));
-	} else if (frame.length <= 0xFFFF) {
-		*cur++ = byte(0x7E | (frame.mask ? 0x80 : 0));
-		*reinterpret_cast<uint16_t *>(cur) = htons(uint16_t(frame.length));
-		cur += 2;
-	} else {
-		*cur++ = byte(0x7F | (frame.mask ? 0x80 : 0));
-		*reinterpret_cast<uint64_t *>(cur) = htonll(uint64_t(frame.length));
-		cur += 8;
-	}
+	byte *cur = buffer + WriteFrameHeader(frame, buffer);
 
 	if (frame.mask) {
 		byte *maskingKey = reinterpret_cast<byte *>(cur);
@@ -403,6 +462,17 @@ bool WsTransport::sendFrame(const Frame &frame) {
 	}
 
 	const size_t length = cur - buffer; // header length
+
+	if (payload && (mTcpTransport || (mTlsTransport && mTlsTransport->isKernelTls()))) {
+		// Send the header and the payload message as separate buffers in a single vectored
+		// write, so the payload is not copied
+		message_vector messages;
+		messages.reserve(2);
+		messages.push_back(make_message(buffer, buffer + length));
+		messages.push_back(std::move(payload));
+		return mTcpTransport ? mTcpTransport->send(messages) : mTlsTransport->send(messages);
+	}
+
 	auto message = make_message(length + frame.length);
 	std::copy(buffer, buffer + length, message->begin()); // header
 	std::copy(frame.payload, frame.payload + frame.length,
@@ -411,6 +481,27 @@ bool WsTransport::sendFrame(const Frame &frame) {
 	return outgoing(std::move(message));
 }
 
+size_t WsTransport::WriteFrameHeader(const Frame &frame, byte *buffer) {
+	// The masking key is not written
+	byte *cur = buffer;
+
+	*cur++ = byte((frame.opcode & 0x0F) | (frame.fin ? 0x80 : 0));
+
+	if (frame.length < 0x7E) {
+		*cur++ = byte((frame.length & 0x7F) | (frame.mask ? 0x80 : 0));
+	} else if (frame.length <= 0xFFFF) {
+		*cur++ = byte(0x7E | (frame.mask ? 0x80 : 0));
+		*reinterpret_cast<uint16_t *>(cur) = htons(uint16_t(frame.length));
+		cur += 2;
+	} else {
+		*cur++ = byte(0x7F | (frame.mask ? 0x80 : 0));
+		*reinterpret_cast<uint64_t *>(cur) = htonll(uint64_t(frame.length));
+		cur += 8;
+	}
+
+	return cur - buffer;
+}
+
 void WsTransport::addOutstandingPing() {
 	++mOutstandingPings;
 	if (mMaxOutstandingPings > 0 && mOutstandingPings > mMaxOutstandingPings) {
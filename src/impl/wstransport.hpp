@@ -42,6 +42,13 @@ public:
 
 	bool isClient() const { return mIsClient; }
 
+	// Encode an unmasked frame once so it can be sent by several server transports
+	static message_ptr EncodeFrame(const Message &message);
+	bool sendEncodedFrame(message_ptr frame);
+
+	// Send a fragment of a message, the type of the message is taken from the first fragment
+	bool sendFragment(message_ptr fragment, bool first, bool fin);
+
 private:
 	enum Opcode : uint8_t {
 		CONTINUATION = 0,
@@ -64,13 +71,17 @@ private:
 	bool sendHttpError(int code);
 	bool sendHttpResponse();
 
+	static size_t WriteFrameHeader(const Frame &frame, byte *buffer);
+
 	size_t parseFrame(byte *buffer, size_t size, Frame &frame);
-	void recvFrame(const Frame &frame);
-	bool sendFrame(const Frame &frame);
+	void recvFrame(const Frame &frame, binary *buffer = nullptr); // buffer contains only the frame
+	bool sendFrame(const Frame &frame, message_ptr payload = nullptr);
 
 	void addOutstandingPing();
 
 	const shared_ptr<WsHandshake> mHandshake;
+	const shared_ptr<TcpTransport> mTcpTransport; // only if directly over TCP
+	const shared_ptr<TlsTransport> mTlsTransport; // only if over TLS
 	const bool mIsClient;
 	const size_t mMaxMessageSize;
 	const int mMaxOutstandingPings;
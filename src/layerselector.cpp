@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "layerselector.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace rtc {
+
+namespace {
+
+uint8_t u8(const byte *data, size_t i) { return std::to_integer<uint8_t>(data[i]); }
+
+bool isVp9(string format) {
+	std::transform(format.begin(), format.end(), format.begin(),
+	               [](unsigned char c) { return char(std::toupper(c)); });
+	return format == "VP9";
+}
+
+} // namespace
+
+LayerSelector::LayerSelector(uint8_t dependencyDescriptorId)
+    : mDependencyDescriptorId(dependencyDescriptorId) {}
+
+void LayerSelector::setTargetLayers(int spatialLayer, int temporalLayer) {
+	if (spatialLayer < 0 || temporalLayer < 0)
+		throw std::invalid_argument("Invalid target layers");
+
+	std::lock_guard lock(mMutex);
+	mTargetSpatial = spatialLayer;
+	mTargetTemporal = temporalLayer;
+}
+
+optional<std::pair<int, int>> LayerSelector::currentLayers() const {
+	std::lock_guard lock(mMutex);
+	return mCurrentLayers;
+}
+
+void LayerSelector::media(const Description::Media &desc) {
+	std::unordered_set<uint8_t> vp9PayloadTypes;
+	for (int pt : desc.payloadTypes())
+		if (isVp9(desc.rtpMap(pt)->format))
+			vp9PayloadTypes.insert(uint8_t(pt));
+
+	uint8_t dependencyDescriptorId = 0;
+	for (int id : desc.extIds())
+		if (desc.extMap(id)->uri == DependencyDescriptorUri)
+			dependencyDescriptorId = uint8_t(id);
+
+	std::lock_guard lock(mMutex);
+	mVp9PayloadTypes = std::move(vp9PayloadTypes);
+	if (dependencyDescriptorId != 0 && mDependencyDescriptorId == 0)
+		mDependencyDescriptorId = dependencyDescriptorId;
+}
+
+void LayerSelector::incoming(message_vector &messages, const message_callback &) {
+	filter(messages);
+}
+
+void LayerSelector::outgoing(message_vector &messages, const message_callback &) {
+	filter(messages);
+}
+
+void LayerSelector::filter(message_vector &messages) {
+	std::lock_guard lock(mMutex);
+	message_vector result;
+	result.reserve(messages.size());
+	for (auto &message : messages)
+		if (select(message) != Decision::Drop)
+			result.push_back(std::move(message));
+
+	messages.swap(result);
+}
+
+LayerSelector::Decision LayerSelector::select(message_ptr &message) {
+	if (message->type == Message::Control || message->size() < sizeof(RtpHeader))
+		return Decision::PassThrough;
+
+	auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+	size_t headerSize = rtp->getSize();
+	if (headerSize > message->size() ||
+	    (rtp->extension() && headerSize + sizeof(RtpExtensionHeader) > message->size()))
+		return Decision::PassThrough;
+
+	headerSize += rtp->getExtensionHeaderSize();
+	if (headerSize > message->size())
+		return Decision::PassThrough;
+
+	if (mSsrc && rtp->ssrc() != *mSsrc)
+		return Decision::PassThrough; // for instance retransmissions
+
+	Decision decision = Decision::PassThrough;
+	bool endOfLayers = false;
+	const byte *descriptorValue = nullptr;
+	size_t descriptorSize = 0;
+	if (mDependencyDescriptorId != 0 && rtp->extension())
+		descriptorValue =
+		    rtp->getExtensionHeader()->findHeader(mDependencyDescriptorId, &descriptorSize);
+
+	if (descriptorValue) {
+		// Without the template structure, the frame can't be interpreted
+		auto descriptor = mReader.read(descriptorValue, descriptorSize);
+		decision = descriptor ? selectWithDescriptor(*descriptor, endOfLayers) : Decision::Drop;
+
+	} else if (mVp9PayloadTypes.find(rtp->payloadType()) != mVp9PayloadTypes.end()) {
+		decision = selectVp9(message->data() + headerSize, message->size() - headerSize,
+		                     endOfLayers);
+	}
+
+	if (decision == Decision::PassThrough)
+		return decision;
+
+	mSsrc = rtp->ssrc();
+	if (decision == Decision::Drop) {
+		++mSeqOffset;
+		return decision;
+	}
+
+	bool setMarker = endOfLayers && !rtp->marker();
+	if (mSeqOffset == 0 && !setMarker)
+		return decision;
+
+	// The message might be shared, for instance with other tracks, so rewrite a copy
+	if (message.use_count() > 1)
+		message = make_message(message->size(), message);
+
+	auto out = reinterpret_cast<RtpHeader *>(message->data());
+	out->setSeqNumber(uint16_t(out->seqNumber() - mSeqOffset));
+	if (setMarker)
+		out->setMarker(true);
+
+	return decision;
+}
+
+LayerSelector::Decision
+LayerSelector::selectWithDescriptor(const DependencyDescriptor &descriptor, bool &endOfLayers) {
+	auto structure = mReader.structure();
+	if (structure != mStructure) {
+		mStructure = std::move(structure);
+		mDecodeTargetLayers = DependencyDescriptorReader::DecodeTargetLayers(*mStructure);
+		mCurrentDecodeTarget.reset();
+	}
+
+	const auto &dtis = descriptor.dependencyTemplate.decodeTargetIndications;
+	auto indication = [&dtis](int target) {
+		return size_t(target) < dtis.size() ? dtis[target] : DecodeTargetIndication::NotPresent;
+	};
+
+	if (descriptor.startOfFrame) {
+		auto target = findDecodeTarget(descriptor.activeDecodeTargetsBitmask);
+		if (target && target != mCurrentDecodeTarget) {
+			if (!mCurrentDecodeTarget || descriptor.structureAttached) {
+				// The structure is attached to keyframes, any decode target can start here
+				mCurrentDecodeTarget = target;
+			} else {
+				auto [spatial, temporal] = mDecodeTargetLayers[*target];
+				auto [currentSpatial, currentTemporal] = mDecodeTargetLayers[*mCurrentDecodeTarget];
+				// Lower layers never depend on higher ones, switching up requires a switch point
+				if ((spatial <= currentSpatial && temporal <= currentTemporal) ||
+				    indication(*target) == DecodeTargetIndication::Switch)
+					mCurrentDecodeTarget = target;
+			}
+		}
+	}
+
+	if (!mCurrentDecodeTarget)
+		return Decision::Drop;
+
+	auto layers = mDecodeTargetLayers[*mCurrentDecodeTarget];
+	mCurrentLayers = layers;
+	if (indication(*mCurrentDecodeTarget) == DecodeTargetIndication::NotPresent)
+		return Decision::Drop;
+
+	endOfLayers =
+	    descriptor.endOfFrame && descriptor.dependencyTemplate.spatialId == layers.first;
+	return Decision::Forward;
+}
+
+optional<int> LayerSelector::findDecodeTarget(optional<uint32_t> activeDecodeTargetsBitmask) const {
+	// Choose the highest decode target within the target layers, or the lowest one if none is
+	optional<int> best, lowest;
+	for (int i = 0; i < int(mDecodeTargetLayers.size()); ++i) {
+		if (activeDecodeTargetsBitmask && i < 32 && !((*activeDecodeTargetsBitmask >> i) & 1))
+			continue;
+
+		const auto &layers = mDecodeTargetLayers[i];
+		if (!lowest || layers < mDecodeTargetLayers[*lowest])
+			lowest = i;
+
+		if (layers.first <= mTargetSpatial && layers.second <= mTargetTemporal &&
+		    (!best || layers > mDecodeTargetLayers[*best]))
+			best = i;
+	}
+	return best ? best : lowest;
+}
+
+// See https://datatracker.ietf.org/doc/html/rfc9628#section-4.2
+LayerSelector::Decision LayerSelector::selectVp9(const byte *payload, size_t size,
+                                                 bool &endOfLayers) {
+	if (size < 1)
+		return Decision::PassThrough;
+
+	uint8_t first = u8(payload, 0);
+	bool interPicture = first & 0x40; // P
+	bool beginning = first & 0x08;    // B
+	bool end = first & 0x04;          // E
+	size_t offset = 1;
+	optional<uint16_t> pictureId;
+	if (first & 0x80) { // I: picture ID
+		if (offset >= size)
+			return Decision::PassThrough;
+
+		uint8_t pid = u8(payload, offset++);
+		if (pid & 0x80) { // M: 15-bit picture ID
+			if (offset >= size)
+				return Decision::PassThrough;
+
+			pictureId = uint16_t(((pid & 0x7F) << 8) | u8(payload, offset++));
+		} else {
+			pictureId = pid;
+		}
+	}
+	if (!(first & 0x20) || offset >= size) // L: layer indices
+		return Decision::PassThrough;      // the stream is not scalable
+
+	uint8_t layer = u8(payload, offset);
+	int temporalId = layer >> 5;
+	bool switchingUp = layer & 0x10; // U
+	int spatialId = (layer >> 1) & 0x07;
+
+	bool newPicture = pictureId ? pictureId != mLastPictureId : beginning && spatialId == 0;
+	if (pictureId)
+		mLastPictureId = pictureId;
+
+	bool keyframe = beginning && spatialId == 0 && !interPicture;
+	if (newPicture) {
+		if (!mCurrentLayers) {
+			mCurrentLayers.emplace(mTargetSpatial, mTargetTemporal);
+		} else {
+			auto &[spatial, temporal] = *mCurrentLayers;
+			// Spatial layers depend on lower ones of the same picture and of previous pictures
+			if (mTargetSpatial < spatial || keyframe)
+				spatial = mTargetSpatial;
+
+			// A base temporal layer frame only depends on previous base layer frames
+			if (mTargetTemporal < temporal || keyframe || temporalId == 0)
+				temporal = mTargetTemporal;
+		}
+	}
+
+	if (!mCurrentLayers)
+		return Decision::Drop;
+
+	auto &[spatial, temporal] = *mCurrentLayers;
+	if (beginning && switchingUp && temporalId > temporal && temporalId <= mTargetTemporal)
+		temporal = temporalId;
+
+	if (spatialId > spatial || temporalId > temporal)
+		return Decision::Drop;
+
+	endOfLayers = end && spatialId == spatial;
+	return Decision::Forward;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
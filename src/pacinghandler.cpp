@@ -13,85 +13,87 @@
 #include "pacinghandler.hpp"
 
 #include "impl/internals.hpp"
-#include "impl/threadpool.hpp"
+#include "impl/pacingengine.hpp"
 
 namespace rtc {
 
 PacingHandler::PacingHandler(double bitsPerSecond, std::chrono::milliseconds sendInterval, size_t maxQueueAmount)
-    : mBytesPerSecond(bitsPerSecond / 8), mBudget(0.), mSendInterval(sendInterval), mMaxQueueAmount(maxQueueAmount) {}
+    : mBytesPerSecond(bitsPerSecond / 8), mSendInterval(sendInterval), mMaxQueueAmount(maxQueueAmount) {}
+
+PacingHandler::~PacingHandler() {
+	if (mFlow)
+		impl::PacingEngine::Instance().remove(mFlow);
+}
 
 void PacingHandler::setBitrate(double bitsPerSecond) {
-	std::lock_guard<std::mutex> lock(mParamsMutex);
-    mBytesPerSecond = bitsPerSecond / 8;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mBytesPerSecond = bitsPerSecond / 8;
+	if (mFlow)
+		impl::PacingEngine::Instance().setRate(mFlow, mBytesPerSecond, burstSize());
 }
 
 void PacingHandler::setMaxQueueAmount(size_t maxQueueAmount) {
-	std::lock_guard<std::mutex> lock(mParamsMutex);
-    mMaxQueueAmount = maxQueueAmount;
+	std::lock_guard<std::mutex> lock(mMutex);
+	mMaxQueueAmount = maxQueueAmount;
 }
 
 void PacingHandler::onOverflow(std::function<void()> callback) {
 	mOverflowCallback = std::move(callback);
 }
 
-void PacingHandler::schedule(const message_callback &send, std::chrono::milliseconds scheduleInterval) {
-	if (!mHaveScheduled.exchange(true))
-		impl::ThreadPool::Instance().schedule(scheduleInterval,
-		                                      weak_bind(&PacingHandler::run, this, send));
+void PacingHandler::media(const Description::Media &desc) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	mAudio = desc.type() == "audio";
+	mRetransmissionSsrcs.clear();
+	for (auto ssrc : desc.getSSRCs())
+		if (desc.getSsrcForRtxSsrc(ssrc))
+			mRetransmissionSsrcs.push_back(ssrc);
+
+	if (mFlow)
+		updatePriority();
 }
 
-void PacingHandler::run(const message_callback &send) {
-	const std::lock_guard<std::mutex> lock(mMutex);
-	mHaveScheduled.store(false);
-
-	double bytesPerSecond;
-	{
-		std::lock_guard<std::mutex> lockParams(mParamsMutex);
-		bytesPerSecond = mBytesPerSecond;
-	}
-
-	// Update the budget and cap it
-	auto now = std::chrono::high_resolution_clock::now();
-	auto newBudget = std::chrono::duration<double>(now - mLastRun).count() * bytesPerSecond;
-	auto maxBudget = std::chrono::duration<double>(mSendInterval).count() * bytesPerSecond;
-	mBudget = std::min(mBudget + newBudget, maxBudget);
-	mLastRun = std::chrono::high_resolution_clock::now();
-
-	// Send packets while there is budget, allow a single partial packet over budget
-	while (!mRtpBuffer.empty() && mBudget > 0) {
-		auto size = int(mRtpBuffer.front()->size());
-		send(std::move(mRtpBuffer.front()));
-		mRtpBuffer.pop();
-		mBudget -= size;
+void PacingHandler::outgoing(message_vector &messages, const message_callback &send) {
+	std::lock_guard<std::mutex> lock(mMutex);
+	auto &engine = impl::PacingEngine::Instance();
+	if (!mFlow) {
+		mSend = send;
+		mFlow = engine.add(weak_bind(&PacingHandler::release, this, std::placeholders::_1),
+		                   mBytesPerSecond, burstSize());
+		updatePriority();
 	}
 
-	auto scheduleInterval = std::chrono::duration_cast<std::chrono::milliseconds>(mSendInterval - (std::chrono::high_resolution_clock::now() - mLastRun));
+	if (!engine.enqueue(mFlow, messages, mMaxQueueAmount))
+		mOverflowCallback();
 
-	if (!mRtpBuffer.empty()) {
-		schedule(send, std::max(scheduleInterval, std::chrono::milliseconds(0)));
-	}
+	messages.clear();
 }
 
-void PacingHandler::outgoing(message_vector &messages, const message_callback &send) {
+double PacingHandler::burstSize() const {
+	return std::chrono::duration<double>(mSendInterval).count() * mBytesPerSecond;
+}
 
-	std::lock_guard<std::mutex> lock(mMutex);
+void PacingHandler::updatePriority() {
+	using Priority = impl::PacingFlow::Priority;
+	impl::PacingEngine::Instance().setPriority(
+	    mFlow, mAudio ? Priority::Audio : Priority::Video,
+	    std::unordered_set<SSRC>(mRetransmissionSsrcs.begin(), mRetransmissionSsrcs.end()));
+}
 
-	size_t maxQueueAmount;
-    {
-        std::lock_guard<std::mutex> lockParams(mParamsMutex);
-        maxQueueAmount = mMaxQueueAmount;
-    }
-
-	for (auto& m : messages) {
-		if (maxQueueAmount != 0 && mRtpBuffer.size() >= maxQueueAmount) {
-			mOverflowCallback();
-			break;
-		}
-		mRtpBuffer.push(std::move(m));
+void PacingHandler::release(message_vector &messages) {
+	message_callback send;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		send = mSend;
 	}
-	messages.clear();
 
-	schedule(send, std::chrono::milliseconds(0));
+	// Released packets go through the rest of the chain so following handlers see them when they
+	// are actually sent
+	if (auto handler = next())
+		handler->outgoingChain(messages, send);
+
+	for (auto &message : messages)
+		send(std::move(message));
 }
 
 } // namespace rtc
@@ -9,6 +9,7 @@
 
 #include "peerconnection.hpp"
 #include "common.hpp"
+#include "coroutine.hpp"
 #include "rtp.hpp"
 
 #include "impl/certificate.hpp"
@@ -38,6 +39,7 @@ PeerConnection::PeerConnection(Configuration config)
     : CheshireCat<impl::PeerConnection>(std::move(config)) {}
 
 PeerConnection::~PeerConnection() {
+	impl::CoroutineWaiters::Release(this);
 	try {
 		impl()->remoteClose();
 	} catch (const std::exception &e) {
@@ -407,6 +409,52 @@ optional<std::chrono::milliseconds> PeerConnection::rtt() {
 	return sctpTransport ? sctpTransport->rtt() : nullopt;
 }
 
+StatsReport PeerConnection::stats() {
+	StatsReport report;
+	report.timestamp = std::chrono::steady_clock::now();
+
+	auto &transport = report.transport;
+	if (auto iceTransport = impl()->getIceTransport()) {
+		Candidate local, remote;
+		if (iceTransport->getSelectedCandidatePair(&local, &remote)) {
+			transport.localCandidate = std::move(local);
+			transport.remoteCandidate = std::move(remote);
+		}
+		transport.packetsSent = iceTransport->packetsSent();
+		transport.bytesSent = iceTransport->bytesSent();
+		transport.packetsReceived = iceTransport->packetsReceived();
+		transport.bytesReceived = iceTransport->bytesReceived();
+	}
+
+	if (auto sctpTransport = impl()->getSctpTransport()) {
+		if (auto status = sctpTransport->status()) {
+			transport.sctpRtt = status->rtt;
+			transport.sctpRto = status->rto;
+			transport.sctpCongestionWindow = status->congestionWindow;
+			transport.sctpUnackedChunks = status->unackedChunks;
+		}
+	}
+
+#if RTC_ENABLE_MEDIA
+	if (auto srtpTransport =
+	        std::dynamic_pointer_cast<impl::DtlsSrtpTransport>(impl()->getDtlsTransport())) {
+		auto srtpStats = srtpTransport->stats();
+		transport.srtpPacketsTruncated = srtpStats.truncated;
+		transport.srtpReplays = srtpStats.replays;
+		transport.srtpAuthFailures = srtpStats.authFailures;
+		transport.srtpOtherFailures = srtpStats.otherFailures;
+	}
+#endif
+
+	impl()->iterateTracks(
+	    [&report](shared_ptr<impl::Track> track) { report.tracks.push_back(track->stats()); });
+	impl()->iterateDataChannels([&report](shared_ptr<impl::DataChannel> channel) {
+		report.dataChannels.push_back(channel->stats());
+	});
+
+	return report;
+}
+
 CertificateFingerprint PeerConnection::remoteFingerprint() {
 	return impl()->remoteFingerprint();
 }
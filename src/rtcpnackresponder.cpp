@@ -14,10 +14,10 @@
 #include "impl/internals.hpp"
 #include "impl/utils.hpp"
 
-#include <cassert>
 #include <cstring>
 #include <functional>
 #include <random>
+#include <stdexcept>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -29,8 +29,18 @@ namespace rtc {
 
 namespace utils = impl::utils;
 
-RtcpNackResponder::RtcpNackResponder(size_t maxSize)
-    : mStorage(std::make_shared<Storage>(maxSize)) {
+RtcpNackResponder::RtcpNackResponder(size_t maxSize, std::chrono::milliseconds maxAge)
+    : mHistory(std::make_shared<RtpPacketHistory>(maxSize, maxAge)), mSharedHistory(false) {
+	auto uniform = std::bind(std::uniform_int_distribution<uint32_t>(), utils::random_engine());
+	mRtxSequenceNumber = static_cast<uint16_t>(uniform());
+}
+
+RtcpNackResponder::RtcpNackResponder(shared_ptr<RtpPacketHistory> history,
+                                     optional<SSRC> sourceSsrc)
+    : mHistory(std::move(history)), mSharedHistory(true), mSourceSsrc(sourceSsrc) {
+	if (!mHistory)
+		throw std::invalid_argument("Packet history is null");
+
 	auto uniform = std::bind(std::uniform_int_distribution<uint32_t>(), utils::random_engine());
 	mRtxSequenceNumber = static_cast<uint16_t>(uniform());
 }
@@ -77,6 +87,7 @@ void RtcpNackResponder::incoming(message_vector &messages, const message_callbac
 		rtxEnabled = mRtxEnabled;
 	}
 
+	message_vector retransmissions;
 	for (const auto &message : messages) {
 		if (message->type != Message::Control)
 			continue;
@@ -102,28 +113,47 @@ void RtcpNackResponder::incoming(message_vector &messages, const message_callbac
 				                              newMissingSeqenceNumbers.end());
 			}
 
+			SSRC mediaSsrc = nack->header.mediaSourceSSRC();
+			SSRC historySsrc = mSourceSsrc.value_or(mediaSsrc);
 			for (auto sequenceNumber : missingSequenceNumbers) {
-				if (auto packet = mStorage->get(sequenceNumber)) {
+				if (auto packet = mHistory->get(historySsrc, sequenceNumber)) {
 					if (rtxEnabled) {
 						// RTX sender mode: wrap in RTX before sending
 						auto rtxPacket = wrapInRtx(packet);
 						if (rtxPacket)
-							send(rtxPacket);
+							retransmissions.push_back(std::move(rtxPacket));
+					} else if (historySsrc != mediaSsrc) {
+						// Plain retransmission from a shared history
+						retransmissions.push_back(rewriteSsrc(packet, mediaSsrc));
 					} else {
 						// Plain retransmission
-						send(packet);
+						retransmissions.push_back(packet);
 					}
 				}
 			}
 		}
 	}
+
+	if (retransmissions.empty())
+		return;
+
+	// Retransmissions go through the following handlers like outgoing packets, so they are paced
+	// by a PacingHandler chained after the responder
+	if (auto handler = next())
+		handler->outgoingChain(retransmissions, send);
+
+	for (auto &retransmission : retransmissions)
+		send(std::move(retransmission));
 }
 
 void RtcpNackResponder::outgoing(message_vector &messages,
                                  [[maybe_unused]] const message_callback &send) {
+	if (mSharedHistory)
+		return; // the application fills the history
+
 	for (const auto &message : messages)
 		if (message->type != Message::Control)
-			mStorage->store(message);
+			mHistory->store(message);
 }
 
 message_ptr RtcpNackResponder::wrapInRtx(const message_ptr &original) {
@@ -177,52 +207,13 @@ message_ptr RtcpNackResponder::wrapInRtx(const message_ptr &original) {
 	return rtxMessage;
 }
 
-RtcpNackResponder::Storage::Element::Element(message_ptr packet, uint16_t sequenceNumber,
-                                             shared_ptr<Element> next)
-    : packet(packet), sequenceNumber(sequenceNumber), next(next) {}
-
-size_t RtcpNackResponder::Storage::size() { return storage.size(); }
-
-RtcpNackResponder::Storage::Storage(size_t _maxSize) : maxSize(_maxSize) {
-	assert(maxSize > 0);
-	storage.reserve(maxSize);
-}
-
-message_ptr RtcpNackResponder::Storage::get(uint16_t sequenceNumber) {
-	std::lock_guard lock(mutex);
-	auto position = storage.find(sequenceNumber);
-	return position != storage.end() ? storage.at(sequenceNumber)->packet
-	                                 : nullptr;
-}
-
-void RtcpNackResponder::Storage::store(message_ptr packet) {
-	if (!packet || packet->size() < sizeof(RtpHeader))
-		return;
-
-	auto rtp = reinterpret_cast<RtpHeader *>(packet->data());
-	auto sequenceNumber = rtp->seqNumber();
-
-	std::lock_guard lock(mutex);
-	assert((storage.empty() && !oldest && !newest) || (!storage.empty() && oldest && newest));
-
-	if (size() == 0) {
-		newest = std::make_shared<Element>(packet, sequenceNumber);
-		oldest = newest;
-	} else {
-		auto current = std::make_shared<Element>(packet, sequenceNumber);
-		newest->next = current;
-		newest = current;
-	}
-
-	storage.emplace(sequenceNumber, newest);
-
-	if (size() > maxSize) {
-		assert(oldest);
-		if (oldest) {
-			storage.erase(oldest->sequenceNumber);
-			oldest = oldest->next;
-		}
-	}
+message_ptr RtcpNackResponder::rewriteSsrc(const message_ptr &original, SSRC ssrc) {
+	// Packets in a shared history must not be modified, so copy before rewriting
+	auto message = std::make_shared<Message>(*original);
+	auto rtp = reinterpret_cast<RtpHeader *>(message->data());
+	rtp->setSsrc(ssrc);
+	message->stream = ssrc;
+	return message;
 }
 
 } // namespace rtc
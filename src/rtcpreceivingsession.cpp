@@ -14,6 +14,7 @@
 
 #include "impl/logcounter.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <mutex>
 #include <utility>
@@ -69,7 +70,16 @@ void RtcpReceivingSession::media(const Description::Media &desc) {
 		newRtxEnabled = !newRtxToPrimaryPtMap.empty();
 	}
 
+	std::array<uint32_t, 128> newClockRates = {};
+	for (int pt : desc.payloadTypes())
+		if (auto rtpMap = desc.rtpMap(pt); pt >= 0 && pt < 128 && rtpMap->clockRate > 0)
+			newClockRates[pt] = uint32_t(rtpMap->clockRate);
+
+	auto localSsrcs = desc.getSSRCs();
+
 	std::lock_guard lock(mMutex);
+	mClockRates = newClockRates;
+	mLocalSsrc = !localSsrcs.empty() ? localSsrcs.front() : 0;
 	mRtxEnabled = newRtxEnabled;
 	mRtxToPrimaryPtMap = std::move(newRtxToPrimaryPtMap);
 	mRtxPrimarySsrc = newRtxPrimarySsrc;
@@ -127,8 +137,10 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 		rtxToPrimaryPtMap = mRtxToPrimaryPtMap;
 	}
 
+	std::vector<bool> retransmitted(messages.size(), false);
 	if (rtxEnabled) {
-		for (auto &message : messages) {
+		for (size_t i = 0; i < messages.size(); ++i) {
+			auto &message = messages[i];
 			if (message->type == Message::Control)
 				continue;
 
@@ -141,8 +153,10 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 			if (rtxToPrimaryPtMap.count(pt)) {
 				// RTX packet
 				auto unwrapped = unwrapRtx(message);
-				if (unwrapped)
+				if (unwrapped) {
 					message = unwrapped;
+					retransmitted[i] = true;
+				}
 			} else {
 				// Primary packet
 				std::lock_guard lock(mMutex);
@@ -153,8 +167,11 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 		}
 	}
 
+	const auto now = std::chrono::steady_clock::now();
+	bool reportRequested = false;
 	message_vector result;
-	for (auto message : messages) {
+	for (size_t i = 0; i < messages.size(); ++i) {
+		auto message = messages[i];
 		switch (message->type) {
 		case Message::Binary: {
 			if (message->size() < sizeof(RtpHeader)) {
@@ -180,7 +197,14 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 
 			mSsrc = rtp->ssrc();
 
-			updateSeq(rtp->seqNumber());
+			{
+				std::lock_guard lock(mMutex);
+				if (auto source = getSource(rtp->ssrc()); source && source->updateSeq(rtp->seqNumber())) {
+					// Retransmissions would skew the interarrival jitter
+					if (!retransmitted[i])
+						updateJitter(*source, rtp, now);
+				}
+			}
 
 			result.push_back(std::move(message));
 			break;
@@ -215,12 +239,17 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 					mSyncTimestamps.rtpTimestamp = sr->rtpTimestamp();
 					mSyncTimestamps.ntpTimestamp = sr->ntpTimestamp();
 				}
+				{
+					std::lock_guard lock(mMutex);
+					if (auto source = getSource(sr->senderSSRC())) {
+						source->lastSrNtp = sr->ntpTimestamp();
+						source->lastSrTime = now;
+					}
+				}
 				sr->log();
 
 				// TODO For the time being, we will send RR's/REMB's when we get an SR
-				pushRR(send, 0);
-				if (unsigned int bitrate = mRequestedBitrate.load(); bitrate > 0)
-					pushREMB(send, bitrate);
+				reportRequested = true;
 			}
 			break;
 		}
@@ -231,6 +260,20 @@ void RtcpReceivingSession::incoming(message_vector &messages, const message_call
 	}
 
 	messages.swap(result);
+
+	if (reportRequested) {
+		// With multiple sources, send at most one compound report per interval
+		{
+			std::lock_guard lock(mMutex);
+			if (mLastReportTime && now - *mLastReportTime < MinReportInterval)
+				return;
+
+			mLastReportTime = now;
+		}
+		pushRR(send);
+		if (unsigned int bitrate = mRequestedBitrate.load(); bitrate > 0)
+			pushREMB(send, bitrate);
+	}
 }
 
 bool RtcpReceivingSession::requestBitrate(unsigned int bitrate, const message_callback &send) {
@@ -248,42 +291,90 @@ void RtcpReceivingSession::pushREMB(const message_callback &send, unsigned int b
 	send(message);
 }
 
-void RtcpReceivingSession::pushRR(const message_callback &send, unsigned int lastSrDelay) {
-	auto message = make_message(RtcpRr::SizeWithReportBlocks(1), Message::Control);
-	auto rr = reinterpret_cast<RtcpRr *>(message->data());
-	rr->preparePacket(mSsrc, 1);
-
-	// calculate packets lost, packet expected, fraction
-	auto extended_max = mCycles + mMaxSeq;
-    auto expected = extended_max - mBaseSeq + 1;
-	auto lost = 0;
-	if (mReceived > 0) {
-		lost = expected - mReceived;
-	}
+void RtcpReceivingSession::pushRR(const message_callback &send) {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
 
-	auto expected_interval = expected - mExpectedPrior;
-    mExpectedPrior = expected;
-    auto received_interval = mReceived - mReceivedPrior;
-    mReceivedPrior = mReceived;
-    auto lost_interval = expected_interval - received_interval;
+	const auto now = std::chrono::steady_clock::now();
+	std::lock_guard lock(mMutex);
 
-	uint8_t fraction;
+	// Only report sources heard from since the last report
+	std::vector<std::pair<SSRC, Source *>> active;
+	active.reserve(mSources.size());
+	for (auto &[ssrc, source] : mSources)
+		if (source.received != source.receivedPrior)
+			active.emplace_back(ssrc, &source);
+
+	if (active.empty())
+		return;
+
+	// Report blocks are split between RRs of at most 31 blocks in a single compound packet
+	size_t count = active.size();
+	size_t packetsCount = (count + MaxReportBlocks - 1) / MaxReportBlocks;
+	size_t size = packetsCount * RtcpRr::SizeWithReportBlocks(0) + count * sizeof(RtcpReportBlock);
+	auto message = make_message(size, Message::Control);
+	SSRC senderSsrc = mLocalSsrc != 0 ? mLocalSsrc : mSsrc;
+
+	size_t offset = 0;
+	for (size_t first = 0; first < count; first += MaxReportBlocks) {
+		auto blocksCount = uint8_t(std::min(count - first, MaxReportBlocks));
+		auto rr = reinterpret_cast<RtcpRr *>(message->data() + offset);
+		rr->preparePacket(senderSsrc, blocksCount);
+		for (uint8_t i = 0; i < blocksCount; ++i) {
+			auto [ssrc, source] = active[first + i];
+
+			// https://www.rfc-editor.org/rfc/rfc3550.html#appendix-A.3
+			uint32_t expected = source->expected();
+			int64_t lost = int64_t(expected) - int64_t(source->received);
+			lost = std::clamp(lost, int64_t(-0x800000), int64_t(0x7FFFFF)); // 24-bit signed
+
+			uint32_t expectedInterval = expected - source->expectedPrior;
+			uint32_t receivedInterval = source->received - source->receivedPrior;
+			source->expectedPrior = expected;
+			source->receivedPrior = source->received;
+			int64_t lostInterval = int64_t(expectedInterval) - int64_t(receivedInterval);
+			source->fractionLost = expectedInterval == 0 || lostInterval <= 0
+			                           ? 0
+			                           : uint8_t((lostInterval << 8) / expectedInterval);
+
+			// Delay since last SR in units of 1/65536 seconds
+			uint64_t delaySinceSr = 0;
+			if (source->lastSrNtp != 0)
+				delaySinceSr =
+				    uint64_t(duration_cast<microseconds>(now - source->lastSrTime).count()) *
+				    65536 / 1000000;
+
+			auto reportBlock = rr->getReportBlock(i);
+			reportBlock->preparePacket(ssrc, source->fractionLost, uint32_t(lost),
+			                           source->maxSeq, uint16_t(source->cycles >> 16),
+			                           source->jitter >> 4, source->lastSrNtp, delaySinceSr);
+		}
 
-	if (expected_interval == 0 || lost_interval <= 0) {
-		fraction = 0;
-	}
-	else {
-		fraction = (lost_interval << 8) / expected_interval;
+		rr->log();
+		offset += rr->getSize();
 	}
-	auto syncTimestamps = getSyncTimestamps();
-	auto reportBlock = rr->getReportBlock(0);
-	assert(reportBlock);
-	reportBlock->preparePacket(mSsrc, fraction, lost, uint16_t(mGreatestSeqNo), mMaxSeq, 0, syncTimestamps.ntpTimestamp,
-	                           lastSrDelay);
-	rr->log();
+
 	send(message);
 }
 
+std::vector<RtcpReceivingSession::SourceStats> RtcpReceivingSession::getSourceStats() {
+	std::lock_guard lock(mMutex);
+	std::vector<SourceStats> result;
+	result.reserve(mSources.size());
+	for (const auto &[ssrc, source] : mSources) {
+		SourceStats stats;
+		stats.ssrc = ssrc;
+		stats.packetsReceived = source.received;
+		stats.packetsLost = int32_t(int64_t(source.expected()) - int64_t(source.received));
+		stats.fractionLost = source.fractionLost / 256.0;
+		stats.extendedHighestSeqNo = source.cycles + source.maxSeq;
+		stats.jitter = source.jitter >> 4;
+		stats.clockRate = source.clockRate;
+		result.push_back(stats);
+	}
+	return result;
+}
+
 bool RtcpReceivingSession::requestKeyframe(const std::vector<SSRC>& targetSSRCs, bool retransmit, const message_callback &send) {
 	if (mSupportsRfc5104Fir) {
 		pushFIR(send, targetSSRCs, retransmit);
@@ -329,53 +420,83 @@ void RtcpReceivingSession::pushPLI(const message_callback &send) {
 	send(message);
 }
 
-void RtcpReceivingSession::initSeq(uint16_t seq) {
-	mBaseSeq = seq;
-	mMaxSeq = seq;
-	mBadSeq = RTP_SEQ_MOD + 1;   /* so seq == bad_seq is false */
-	mCycles = 0;
-	mReceived = 0;
-	mReceivedPrior = 0;
-	mExpectedPrior = 0;
+RtcpReceivingSession::Source *RtcpReceivingSession::getSource(SSRC ssrc) {
+	if (auto it = mSources.find(ssrc); it != mSources.end())
+		return &it->second;
+
+	if (mSources.size() >= MaxSources) {
+		PLOG_VERBOSE << "Too many RTP sources, ignoring SSRC " << ssrc;
+		return nullptr;
+	}
+
+	return &mSources[ssrc];
+}
+
+void RtcpReceivingSession::updateJitter(Source &source, const RtpHeader *rtp,
+                                        std::chrono::steady_clock::time_point now) {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	uint32_t clockRate = mClockRates[rtp->payloadType() & 0x7F];
+	if (clockRate == 0)
+		return;
+
+	if (clockRate != source.clockRate) {
+		source.clockRate = clockRate;
+		source.hasTransit = false;
+	}
+
+	// https://www.rfc-editor.org/rfc/rfc3550.html#appendix-A.8
+	auto elapsed = uint64_t(duration_cast<microseconds>(now - mEpoch).count());
+	auto arrival = uint32_t(elapsed * clockRate / 1000000);
+	uint32_t transit = arrival - rtp->timestamp();
+	if (source.hasTransit) {
+		auto d = int32_t(transit - source.transit);
+		if (d < 0)
+			d = -d;
+		source.jitter += uint32_t(d) - ((source.jitter + 8) >> 4);
+	}
+	source.transit = transit;
+	source.hasTransit = true;
+}
+
+void RtcpReceivingSession::Source::initSeq(uint16_t seq) {
+	baseSeq = seq;
+	maxSeq = seq;
+	badSeq = RTP_SEQ_MOD + 1;   /* so seq == bad_seq is false */
+	cycles = 0;
+	received = 0;
+	receivedPrior = 0;
+	expectedPrior = 0;
+	hasTransit = false;
+	jitter = 0;
 }
 
-bool RtcpReceivingSession::updateSeq(uint16_t seq) {
-	uint16_t udelta = seq - mMaxSeq;
+bool RtcpReceivingSession::Source::updateSeq(uint16_t seq) {
 	const int MAX_DROPOUT = 3000;
 	const int MAX_MISORDER = 100;
-	const int MIN_SEQUENTIAL = 2;
-
-	/*
-	* Source is not valid until MIN_SEQUENTIAL packets with
-	* sequential sequence numbers have been received.
-	*/
-	if (mProbation) {
-		/* packet is in sequence */
-		if (seq == mMaxSeq + 1) {
-			mProbation--;
-			mMaxSeq = seq;
-			if (mProbation == 0) {
-				initSeq(seq);
-				mReceived++;
-				return true;
-			}
-		} else {
-			mProbation = MIN_SEQUENTIAL - 1;
-			mMaxSeq = seq;
-		}
-		return false;
-	} else if (udelta < MAX_DROPOUT) {
+
+	// Sources are valid from the first packet, without probation
+	if (!initialized) {
+		initSeq(seq);
+		initialized = true;
+		received++;
+		return true;
+	}
+
+	uint16_t udelta = seq - maxSeq;
+	if (udelta < MAX_DROPOUT) {
 		/* in order, with permissible gap */
-		if (seq < mMaxSeq) {
+		if (seq < maxSeq) {
 			/*
 			* Sequence number wrapped - count another 64K cycle.
 			*/
-			mCycles += RTP_SEQ_MOD;
+			cycles += RTP_SEQ_MOD;
 		}
-		mMaxSeq = seq;
+		maxSeq = seq;
 	} else if (udelta <= RTP_SEQ_MOD - MAX_MISORDER) {
 		/* the sequence number made a very large jump */
-		if (seq == mBadSeq) {
+		if (seq == badSeq) {
 			/*
 			* Two sequential packets -- assume that the other side
 			* restarted without telling us so just re-sync
@@ -384,14 +505,18 @@ bool RtcpReceivingSession::updateSeq(uint16_t seq) {
 			initSeq(seq);
 		}
 		else {
-			mBadSeq = (seq + 1) & (RTP_SEQ_MOD-1);
+			badSeq = (seq + 1) & (RTP_SEQ_MOD-1);
 			return false;
 		}
 	}
-	mReceived++;
+	received++;
 	return true;
 }
 
+uint32_t RtcpReceivingSession::Source::expected() const {
+	return received > 0 ? cycles + maxSeq - baseSeq + 1 : 0;
+}
+
 } // namespace rtc
 
 #endif // RTC_ENABLE_MEDIA
@@ -14,6 +14,7 @@
 
 #include <cmath>
 #include <cstring>
+#include <utility>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -172,6 +173,62 @@ size_t RtpExtensionHeader::writeHeader(bool twoByteHeader, size_t offset, uint8_
 	}
 }
 
+const byte *RtpExtensionHeader::findHeader(uint8_t id, size_t *size) const {
+	// See https://www.rfc-editor.org/rfc/rfc8285.html#section-4
+	const bool twoByteHeader = (profileSpecificId() & 0xFFF0) == 0x1000;
+	if (!twoByteHeader && profileSpecificId() != 0xBEDE)
+		return nullptr;
+
+	auto body = reinterpret_cast<const uint8_t *>(getBody());
+	size_t bodySize = getSize();
+	size_t offset = 0;
+	while (offset < bodySize) {
+		uint8_t elementId;
+		size_t elementSize;
+		if (twoByteHeader) {
+			elementId = body[offset];
+			if (elementId == 0) { // padding
+				++offset;
+				continue;
+			}
+			if (offset + 2 > bodySize)
+				break;
+
+			elementSize = body[offset + 1];
+			offset += 2;
+		} else {
+			elementId = body[offset] >> 4;
+			if (elementId == 0) { // padding
+				++offset;
+				continue;
+			}
+			if (elementId == 15) // reserved, stop parsing
+				break;
+
+			elementSize = (body[offset] & 0x0F) + 1;
+			offset += 1;
+		}
+
+		if (offset + elementSize > bodySize)
+			break;
+
+		if (elementId == id) {
+			if (size)
+				*size = elementSize;
+
+			return reinterpret_cast<const byte *>(body + offset);
+		}
+
+		offset += elementSize;
+	}
+
+	return nullptr;
+}
+
+byte *RtpExtensionHeader::findHeader(uint8_t id, size_t *size) {
+	return const_cast<byte *>(std::as_const(*this).findHeader(id, size));
+}
+
 SSRC RtcpReportBlock::getSSRC() const { return ntohl(_ssrc); }
 
 void RtcpReportBlock::preparePacket(SSRC in_ssrc, uint8_t fraction,
@@ -203,7 +260,7 @@ void RtcpReportBlock::setPacketsLost(uint8_t fractionLost,
 uint8_t RtcpReportBlock::getFractionLost() const {
 	// Fraction lost is expressed as 8-bit fixed point number
 	// In order to get actual lost percentage divide the result by 256
-	return (uint8_t) ((ntohl(_fractionLostAndPacketsLost) & 0xFF00000) >> 24);
+	return (uint8_t) ((ntohl(_fractionLostAndPacketsLost) & 0xFF000000) >> 24);
 }
 
 uint32_t RtcpReportBlock::getPacketsLostCount() const {
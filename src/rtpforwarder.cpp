@@ -0,0 +1,482 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtpforwarder.hpp"
+#include "track.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace rtc {
+
+namespace {
+
+string toUpper(string str) {
+	std::transform(str.begin(), str.end(), str.begin(),
+	               [](unsigned char c) { return char(std::toupper(c)); });
+	return str;
+}
+
+uint8_t u8(const byte *data, size_t i) { return std::to_integer<uint8_t>(data[i]); }
+
+bool isH264Keyframe(const byte *payload, size_t size) {
+	if (size < 1)
+		return false;
+
+	auto isKeyNal = [](uint8_t type) { return type == 5 || type == 7; }; // IDR or SPS
+	uint8_t type = u8(payload, 0) & 0x1F;
+	if (type == 24) { // STAP-A
+		size_t offset = 1;
+		while (offset + 3 <= size) {
+			size_t length = (size_t(u8(payload, offset)) << 8) | u8(payload, offset + 1);
+			if (isKeyNal(u8(payload, offset + 2) & 0x1F))
+				return true;
+
+			offset += 2 + length;
+		}
+		return false;
+	}
+	if (type == 28) // FU-A
+		return size >= 2 && (u8(payload, 1) & 0x80) && isKeyNal(u8(payload, 1) & 0x1F);
+
+	return isKeyNal(type);
+}
+
+bool isH265Keyframe(const byte *payload, size_t size) {
+	if (size < 2)
+		return false;
+
+	auto isKeyNal = [](uint8_t type) { return (type >= 16 && type <= 21) || type == 32; }; // IRAP or VPS
+	uint8_t type = (u8(payload, 0) >> 1) & 0x3F;
+	if (type == 48) { // Aggregation packet
+		size_t offset = 2;
+		while (offset + 3 <= size) {
+			size_t length = (size_t(u8(payload, offset)) << 8) | u8(payload, offset + 1);
+			if (isKeyNal((u8(payload, offset + 2) >> 1) & 0x3F))
+				return true;
+
+			offset += 2 + length;
+		}
+		return false;
+	}
+	if (type == 49) // Fragmentation unit
+		return size >= 3 && (u8(payload, 2) & 0x80) && isKeyNal(u8(payload, 2) & 0x3F);
+
+	return isKeyNal(type);
+}
+
+// See https://www.rfc-editor.org/rfc/rfc7741.html#section-4.2
+void parseVp8(const byte *payload, size_t size, bool &keyframe, bool &frameStart,
+              uint8_t &temporalLayer) {
+	if (size < 1)
+		return;
+
+	uint8_t first = u8(payload, 0);
+	bool start = (first & 0x10) && (first & 0x07) == 0; // S bit and partition index 0
+	size_t offset = 1;
+	if (first & 0x80) { // X
+		if (offset >= size)
+			return;
+
+		uint8_t ext = u8(payload, offset++);
+		if (ext & 0x80) { // I: picture ID
+			if (offset >= size)
+				return;
+
+			offset += (u8(payload, offset) & 0x80) ? 2 : 1;
+		}
+		if (ext & 0x40) // L: TL0PICIDX
+			++offset;
+		if (ext & 0x20 || ext & 0x10) { // T or K
+			if (offset >= size)
+				return;
+
+			if (ext & 0x20)
+				temporalLayer = u8(payload, offset) >> 6;
+
+			++offset;
+		}
+	}
+
+	frameStart = start;
+	keyframe = start && offset < size && (u8(payload, offset) & 0x01) == 0; // P bit
+}
+
+// See https://datatracker.ietf.org/doc/html/draft-ietf-payload-vp9
+void parseVp9(const byte *payload, size_t size, bool &keyframe, bool &frameStart,
+              uint8_t &temporalLayer) {
+	if (size < 1)
+		return;
+
+	uint8_t first = u8(payload, 0);
+	bool beginning = first & 0x08; // B
+	bool interPicture = first & 0x40; // P
+	uint8_t spatialLayer = 0;
+	size_t offset = 1;
+	if (first & 0x80) { // I: picture ID
+		if (offset >= size)
+			return;
+
+		offset += (u8(payload, offset) & 0x80) ? 2 : 1;
+	}
+	if (first & 0x20) { // L: layer indices
+		if (offset >= size)
+			return;
+
+		uint8_t layer = u8(payload, offset);
+		temporalLayer = layer >> 5;
+		spatialLayer = (layer >> 1) & 0x07;
+	}
+
+	frameStart = beginning && spatialLayer == 0;
+	keyframe = frameStart && !interPicture;
+}
+
+} // namespace
+
+RtpForwarder::RtpForwarder() {}
+
+void RtpForwarder::setLayers(std::vector<SSRC> ssrcs) {
+	std::lock_guard lock(mMutex);
+	mLayers = std::move(ssrcs);
+	for (auto &sub : mSubscribers) {
+		if (!mLayers.empty())
+			sub.targetLayer = std::min(sub.targetLayer, unsigned(mLayers.size() - 1));
+
+		sub.currentLayer.reset(); // wait for a keyframe
+		mPendingKeyframeRequests.push_back(sub.targetLayer);
+	}
+}
+
+RtpForwarder::SubscriberId RtpForwarder::addSubscriber(shared_ptr<Track> track, SSRC ssrc,
+                                                       optional<uint8_t> payloadType,
+                                                       unsigned int layer) {
+	if (!track)
+		throw std::invalid_argument("Subscriber track is null");
+
+	Subscriber sub;
+	sub.track = track;
+	sub.ssrc = ssrc;
+	sub.payloadType = payloadType;
+	return addSubscriber(std::move(sub), layer);
+}
+
+RtpForwarder::SubscriberId RtpForwarder::addSubscriber(packet_callback callback, SSRC ssrc,
+                                                       optional<uint8_t> payloadType,
+                                                       unsigned int layer) {
+	if (!callback)
+		throw std::invalid_argument("Subscriber callback is empty");
+
+	Subscriber sub;
+	sub.callback = std::make_shared<packet_callback>(std::move(callback));
+	sub.ssrc = ssrc;
+	sub.payloadType = payloadType;
+	return addSubscriber(std::move(sub), layer);
+}
+
+RtpForwarder::SubscriberId RtpForwarder::addSubscriber(Subscriber sub, unsigned int layer) {
+	std::lock_guard lock(mMutex);
+	if (!mLayers.empty())
+		layer = std::min(layer, unsigned(mLayers.size() - 1));
+
+	sub.id = mNextSubscriberId++;
+	sub.targetLayer = layer;
+	mSubscribers.push_back(std::move(sub));
+	mPendingKeyframeRequests.push_back(layer);
+	return mSubscribers.back().id;
+}
+
+void RtpForwarder::removeSubscriber(SubscriberId id) {
+	std::lock_guard lock(mMutex);
+	mSubscribers.erase(std::remove_if(mSubscribers.begin(), mSubscribers.end(),
+	                                  [id](const Subscriber &sub) { return sub.id == id; }),
+	                   mSubscribers.end());
+}
+
+size_t RtpForwarder::subscriberCount() const {
+	std::lock_guard lock(mMutex);
+	return mSubscribers.size();
+}
+
+void RtpForwarder::setLayer(SubscriberId id, unsigned int layer) {
+	std::lock_guard lock(mMutex);
+	auto &sub = getSubscriber(id);
+	if (!mLayers.empty())
+		layer = std::min(layer, unsigned(mLayers.size() - 1));
+
+	if (sub.targetLayer == layer)
+		return;
+
+	sub.targetLayer = layer;
+	if (sub.currentLayer != layer)
+		mPendingKeyframeRequests.push_back(layer);
+}
+
+void RtpForwarder::setTemporalLayer(SubscriberId id, uint8_t temporalLayer) {
+	std::lock_guard lock(mMutex);
+	getSubscriber(id).maxTemporalLayer = temporalLayer;
+}
+
+bool RtpForwarder::requestKeyframe(SubscriberId id) {
+	// The subscriber might have been removed or dropped with its track, as requests typically come
+	// from callbacks of the subscriber track
+	std::lock_guard lock(mMutex);
+	auto it = std::find_if(mSubscribers.begin(), mSubscribers.end(),
+	                       [id](const Subscriber &sub) { return sub.id == id; });
+	if (it == mSubscribers.end())
+		return false;
+
+	mPendingKeyframeRequests.push_back(it->currentLayer.value_or(it->targetLayer));
+	return true;
+}
+
+void RtpForwarder::media(const Description::Media &desc) {
+	std::unordered_map<uint8_t, Codec> codecs;
+	std::unordered_map<uint8_t, uint32_t> clockRates;
+	for (int pt : desc.payloadTypes()) {
+		auto rtpMap = desc.rtpMap(pt);
+		auto format = toUpper(rtpMap->format);
+		Codec codec = Codec::Unknown;
+		if (format == "H264")
+			codec = Codec::H264;
+		else if (format == "H265")
+			codec = Codec::H265;
+		else if (format == "VP8")
+			codec = Codec::VP8;
+		else if (format == "VP9")
+			codec = Codec::VP9;
+		else if (format == "AV1")
+			codec = Codec::AV1;
+
+		codecs[uint8_t(pt)] = codec;
+		clockRates[uint8_t(pt)] = uint32_t(std::max(rtpMap->clockRate, 0));
+	}
+
+	std::lock_guard lock(mMutex);
+	mCodecs = std::move(codecs);
+	mClockRates = std::move(clockRates);
+}
+
+void RtpForwarder::incoming(message_vector &messages, const message_callback &send) {
+	struct Outgoing {
+		shared_ptr<Track> track;
+		shared_ptr<packet_callback> callback;
+		binary data;
+	};
+	std::vector<Outgoing> outgoing;
+	std::vector<SSRC> keyframeRequests;
+	auto now = std::chrono::steady_clock::now();
+
+	message_vector result;
+	{
+		std::lock_guard lock(mMutex);
+		for (auto &message : messages) {
+			if (message->type == Message::Control) {
+				result.push_back(std::move(message));
+				continue;
+			}
+
+			if (message->size() < sizeof(RtpHeader))
+				continue;
+
+			auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+			size_t headerSize = rtp->getSize();
+			if (headerSize > message->size() ||
+			    (rtp->extension() && headerSize + sizeof(RtpExtensionHeader) > message->size()))
+				continue;
+
+			headerSize += rtp->getExtensionHeaderSize();
+			if (headerSize > message->size())
+				continue;
+
+			auto layer = layerOf(rtp->ssrc());
+			if (!layer)
+				continue;
+
+			if (mLayers.empty())
+				mLastSsrc = rtp->ssrc();
+
+			auto info = parse(rtp, message->data() + headerSize, message->size() - headerSize,
+			                  *layer);
+
+			for (auto &sub : mSubscribers) {
+				uint16_t seq;
+				uint32_t timestamp;
+				if (!rewrite(sub, rtp, info, now, seq, timestamp))
+					continue;
+
+				shared_ptr<Track> track;
+				if (sub.track) {
+					track = sub.track->lock();
+					if (!track || !track->isOpen())
+						continue;
+				}
+
+				// The packet is shared until here, each subscriber gets a rewritten copy
+				binary data(message->begin(), message->end());
+				auto out = reinterpret_cast<RtpHeader *>(data.data());
+				out->setSsrc(sub.ssrc);
+				out->setSeqNumber(seq);
+				out->setTimestamp(timestamp);
+				if (sub.payloadType)
+					out->setPayloadType(*sub.payloadType);
+
+				outgoing.push_back({std::move(track), sub.callback, std::move(data)});
+			}
+		}
+
+		// Drop subscribers whose track is gone
+		mSubscribers.erase(std::remove_if(mSubscribers.begin(), mSubscribers.end(),
+		                                  [](const Subscriber &sub) {
+			                                  return sub.track && sub.track->expired();
+		                                  }),
+		                   mSubscribers.end());
+
+		for (unsigned int layer : mPendingKeyframeRequests) {
+			SSRC ssrc = layer < mLayers.size() ? mLayers[layer] : mLastSsrc;
+			if (ssrc == 0)
+				continue;
+
+			auto it = mLastKeyframeRequests.find(layer);
+			if (it != mLastKeyframeRequests.end() && now - it->second < MinKeyframeRequestInterval)
+				continue;
+
+			mLastKeyframeRequests[layer] = now;
+			keyframeRequests.push_back(ssrc);
+		}
+		mPendingKeyframeRequests.clear();
+	}
+
+	messages.swap(result);
+
+	for (SSRC ssrc : keyframeRequests) {
+		auto message = make_message(RtcpPli::Size(), Message::Control);
+		auto pli = reinterpret_cast<RtcpPli *>(message->data());
+		pli->preparePacket(ssrc);
+		send(std::move(message));
+	}
+
+	for (auto &[track, callback, data] : outgoing) {
+		try {
+			if (track)
+				track->send(std::move(data));
+			else
+				(*callback)(std::move(data));
+		} catch (const std::exception &e) {
+			PLOG_DEBUG << "Failed to forward RTP packet: " << e.what();
+		}
+	}
+}
+
+RtpForwarder::Subscriber &RtpForwarder::getSubscriber(SubscriberId id) {
+	auto it = std::find_if(mSubscribers.begin(), mSubscribers.end(),
+	                       [id](const Subscriber &sub) { return sub.id == id; });
+	if (it == mSubscribers.end())
+		throw std::invalid_argument("Unknown subscriber id");
+
+	return *it;
+}
+
+optional<unsigned int> RtpForwarder::layerOf(SSRC ssrc) const {
+	if (mLayers.empty())
+		return 0;
+
+	auto it = std::find(mLayers.begin(), mLayers.end(), ssrc);
+	if (it == mLayers.end())
+		return nullopt;
+
+	return unsigned(it - mLayers.begin());
+}
+
+RtpForwarder::PacketInfo RtpForwarder::parse(const RtpHeader *rtp, const byte *payload,
+                                             size_t size, unsigned int layer) const {
+	PacketInfo info{layer, false, false, 0};
+	auto it = mCodecs.find(rtp->payloadType());
+	Codec codec = it != mCodecs.end() ? it->second : Codec::Unknown;
+	switch (codec) {
+	case Codec::H264:
+		info.keyframe = isH264Keyframe(payload, size);
+		info.frameStart = info.keyframe;
+		break;
+	case Codec::H265:
+		info.keyframe = isH265Keyframe(payload, size);
+		info.frameStart = info.keyframe;
+		break;
+	case Codec::VP8:
+		parseVp8(payload, size, info.keyframe, info.frameStart, info.temporalLayer);
+		break;
+	case Codec::VP9:
+		parseVp9(payload, size, info.keyframe, info.frameStart, info.temporalLayer);
+		break;
+	case Codec::AV1:
+		// N bit of the aggregation header marks the first packet of a coded video sequence
+		info.keyframe = size >= 1 && (u8(payload, 0) & 0x08);
+		info.frameStart = info.keyframe || (size >= 1 && !(u8(payload, 0) & 0x80)); // not Z
+		break;
+	default:
+		// Keyframes can't be detected, switch anywhere
+		info.keyframe = true;
+		info.frameStart = true;
+		break;
+	}
+	return info;
+}
+
+bool RtpForwarder::rewrite(Subscriber &sub, const RtpHeader *rtp, const PacketInfo &info,
+                           std::chrono::steady_clock::time_point now, uint16_t &outSeq,
+                           uint32_t &outTimestamp) {
+	uint16_t seq = rtp->seqNumber();
+	uint32_t timestamp = rtp->timestamp();
+
+	if (sub.currentLayer != sub.targetLayer && info.layer == sub.targetLayer && info.keyframe) {
+		// Switch layers, continuing sequence numbers and timestamps from the previous layer
+		if (sub.started) {
+			auto it = mClockRates.find(rtp->payloadType());
+			uint32_t clockRate = it != mClockRates.end() ? it->second : 0;
+			auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - sub.lastTime);
+			auto ticks = uint32_t(std::max(int64_t(elapsed.count()) * clockRate / 1000000, int64_t(1)));
+			sub.seqOffset = uint16_t(sub.lastSeq + 1 - seq);
+			sub.timestampOffset = sub.lastTimestamp + ticks - timestamp;
+		}
+		sub.currentLayer = sub.targetLayer;
+		sub.currentTemporalLayer = sub.maxTemporalLayer;
+	}
+
+	if (sub.currentLayer != info.layer)
+		return false;
+
+	// Temporal layers change on frames of the base layer
+	if (info.frameStart && info.temporalLayer == 0)
+		sub.currentTemporalLayer = sub.maxTemporalLayer;
+
+	outSeq = uint16_t(seq + sub.seqOffset);
+	if (info.temporalLayer > sub.currentTemporalLayer) {
+		// Drop the packet and shift following sequence numbers to keep them contiguous
+		if (!sub.started || int16_t(outSeq - sub.lastSeq) > 0)
+			--sub.seqOffset;
+
+		return false;
+	}
+
+	outTimestamp = timestamp + sub.timestampOffset;
+	if (!sub.started || int16_t(outSeq - sub.lastSeq) > 0) {
+		sub.lastSeq = outSeq;
+		sub.lastTimestamp = outTimestamp;
+		sub.lastTime = now;
+	}
+	sub.started = true;
+	return true;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtppackethistory.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+
+namespace rtc {
+
+namespace {
+
+// Sequence numbers wrap at 2^16, a ring must not cover more than half of the space
+const size_t MaxSize = 32768;
+
+size_t nextPowerOfTwo(size_t size) {
+	size_t result = 1;
+	while (result < size)
+		result <<= 1;
+	return result;
+}
+
+} // namespace
+
+RtpPacketHistory::RtpPacketHistory(size_t maxSize, std::chrono::milliseconds maxAge)
+    : mMask(static_cast<uint16_t>(nextPowerOfTwo(std::clamp(maxSize, size_t(1), MaxSize)) - 1)),
+      mMaxAge(maxAge) {}
+
+void RtpPacketHistory::store(message_ptr packet) {
+	if (!packet || packet->type == Message::Control || packet->size() < sizeof(RtpHeader))
+		return;
+
+	auto rtp = reinterpret_cast<const RtpHeader *>(packet->data());
+	SSRC ssrc = rtp->ssrc();
+	uint16_t sequenceNumber = rtp->seqNumber();
+	auto now = std::chrono::steady_clock::now();
+
+	std::lock_guard lock(mMutex);
+	if (now - mLastIdleCheck >= std::chrono::seconds(RTP_HISTORY_STREAM_TIMEOUT)) {
+		removeIdle(now);
+		mLastIdleCheck = now;
+	}
+
+	if (!mLastRing || mLastSsrc != ssrc) {
+		mLastRing = &mRings.try_emplace(ssrc, mMask).first->second;
+		mLastSsrc = ssrc;
+	}
+
+	mLastRing->store(std::move(packet), sequenceNumber, now, mMaxAge);
+}
+
+message_ptr RtpPacketHistory::get(SSRC ssrc, uint16_t sequenceNumber) {
+	auto now = std::chrono::steady_clock::now();
+
+	std::lock_guard lock(mMutex);
+	if (auto it = mRings.find(ssrc); it != mRings.end())
+		return it->second.get(sequenceNumber, now, mMaxAge);
+
+	return nullptr;
+}
+
+void RtpPacketHistory::remove(SSRC ssrc) {
+	std::lock_guard lock(mMutex);
+	if (mLastRing && mLastSsrc == ssrc)
+		mLastRing = nullptr;
+
+	mRings.erase(ssrc);
+}
+
+void RtpPacketHistory::removeIdle(std::chrono::steady_clock::time_point now) {
+	// mMutex must be locked
+	// Streams might stop without notice, for instance when a forwarded sender leaves
+	const auto timeout = std::chrono::seconds(RTP_HISTORY_STREAM_TIMEOUT);
+	for (auto it = mRings.begin(); it != mRings.end();) {
+		if (now - it->second.lastStored() > timeout) {
+			if (mLastRing == &it->second)
+				mLastRing = nullptr;
+
+			it = mRings.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+RtpPacketHistory::Ring::Ring(uint16_t mask) : mSlots(size_t(mask) + 1), mMask(mask) {}
+
+message_ptr RtpPacketHistory::Ring::get(uint16_t sequenceNumber,
+                                        std::chrono::steady_clock::time_point now,
+                                        std::chrono::milliseconds maxAge) const {
+	const auto &slot = mSlots[sequenceNumber & mMask];
+	if (!slot.packet || slot.sequenceNumber != sequenceNumber)
+		return nullptr;
+
+	if (maxAge.count() > 0 && now - slot.timestamp > maxAge)
+		return nullptr;
+
+	return slot.packet;
+}
+
+void RtpPacketHistory::Ring::store(message_ptr packet, uint16_t sequenceNumber,
+                                   std::chrono::steady_clock::time_point now,
+                                   std::chrono::milliseconds maxAge) {
+	if (mEmpty) {
+		mOldest = mNewest = sequenceNumber;
+		mEmpty = false;
+	} else if (int16_t(sequenceNumber - mNewest) > 0) {
+		mNewest = sequenceNumber;
+	} else if (uint16_t(mNewest - sequenceNumber) > mMask) {
+		// Packets are stored in sending order, so a backward jump larger than the ring means the
+		// sequence was restarted, and stored packets would shadow the new ones
+		reset();
+		mOldest = mNewest = sequenceNumber;
+	} else if (int16_t(sequenceNumber - mOldest) < 0) {
+		mOldest = sequenceNumber;
+	}
+
+	auto &slot = mSlots[sequenceNumber & mMask];
+	slot.packet = std::move(packet);
+	slot.sequenceNumber = sequenceNumber;
+	slot.timestamp = now;
+
+	release(now, maxAge);
+}
+
+std::chrono::steady_clock::time_point RtpPacketHistory::Ring::lastStored() const {
+	return mSlots[mNewest & mMask].timestamp;
+}
+
+void RtpPacketHistory::Ring::reset() {
+	for (auto &slot : mSlots)
+		slot.packet.reset();
+}
+
+void RtpPacketHistory::Ring::release(std::chrono::steady_clock::time_point now,
+                                     std::chrono::milliseconds maxAge) {
+	// Slots older than the ring size have been overwritten
+	if (uint16_t(mNewest - mOldest) > mMask)
+		mOldest = uint16_t(mNewest - mMask);
+
+	if (maxAge.count() <= 0)
+		return;
+
+	// Release expired packets, the newest packet has just been stored so it can't be expired
+	while (mOldest != mNewest) {
+		auto &slot = mSlots[mOldest & mMask];
+		if (slot.packet && slot.sequenceNumber == mOldest) {
+			if (now - slot.timestamp <= maxAge)
+				break;
+
+			slot.packet.reset();
+		}
+		++mOldest;
+	}
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -64,7 +64,8 @@ message_ptr RtpPacketizer::packetize(const binary &payload, bool mark, shared_pt
 	    (rtpConfig->rid.has_value() && rtpConfig->ridId > 14) ||
 	    (videoLayersAllocationBuf.size() > 14 || rtpConfig->videoLayersAllocationId > 14) ||
 	    rtpConfig->playoutDelayId > 14 ||
-	    (setAbsCaptureTime && rtpConfig->absCaptureTimeId > 14)) {
+	    (setAbsCaptureTime && rtpConfig->absCaptureTimeId > 14) ||
+	    rtpConfig->transportCcId > 14) {
 		twoByteHeader = true;
 	}
 	size_t headerSize = twoByteHeader ? 2 : 1;
@@ -84,6 +85,11 @@ message_ptr RtpPacketizer::packetize(const binary &payload, bool mark, shared_pt
 	if (setAbsCaptureTime)
 		rtpExtHeaderSize += headerSize + 8;
 
+	const bool setTransportCc = rtpConfig->transportCcId > 0;
+
+	if (setTransportCc)
+		rtpExtHeaderSize += headerSize + 2;
+
 	if (rtpConfig->mid.has_value())
 		rtpExtHeaderSize += headerSize + rtpConfig->mid->length();
 
@@ -195,6 +201,13 @@ message_ptr RtpPacketizer::packetize(const binary &payload, bool mark, shared_pt
 			offset += extHeader->writeHeader(
 			    twoByteHeader, offset, rtpConfig->absCaptureTimeId, data, 8);
 		}
+
+		if (setTransportCc) {
+			// Stamped with the transport-wide sequence number when sent
+			byte data[2] = {};
+			offset += extHeader->writeHeader(
+			    twoByteHeader, offset, rtpConfig->transportCcId, data, 2);
+		}
 	}
 
 	rtp->preparePacket();
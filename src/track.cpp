@@ -26,6 +26,8 @@ Description::Direction Track::direction() const { return impl()->direction(); }
 
 Description::Media Track::description() const { return impl()->description(); }
 
+TrackStats Track::stats() const { return impl()->stats(); }
+
 void Track::setDescription(Description::Media description) {
 	impl()->setDescription(std::move(description));
 }
@@ -0,0 +1,250 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "transportccfeedback.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace rtc {
+
+namespace {
+
+const size_t HeaderSize = 20; // RTCP FB header + base sequence number, count, reference time
+const size_t MaxRunLength = 0x1FFF;
+
+enum Symbol : uint8_t { NotReceived = 0, SmallDelta = 1, LargeDelta = 2 };
+
+uint16_t readUint16(const uint8_t *p) { return uint16_t((p[0] << 8) | p[1]); }
+
+void writeUint16(uint8_t *p, uint16_t value) {
+	p[0] = uint8_t(value >> 8);
+	p[1] = uint8_t(value & 0xFF);
+}
+
+} // namespace
+
+bool TransportCcFeedback::IsTransportCc(const RtcpHeader *header) {
+	return header->payloadType() == PayloadType && header->reportCount() == Format;
+}
+
+optional<TransportCcFeedback> TransportCcFeedback::Parse(const byte *data, size_t size) {
+	if (size < HeaderSize)
+		return nullopt;
+
+	auto header = reinterpret_cast<const RtcpHeader *>(data);
+	if (!IsTransportCc(header))
+		return nullopt;
+
+	size_t end = header->lengthInBytes();
+	if (end < HeaderSize || end > size)
+		return nullopt;
+
+	auto p = reinterpret_cast<const uint8_t *>(data);
+	if (header->padding()) {
+		uint8_t paddingSize = p[end - 1];
+		if (paddingSize == 0 || paddingSize > end - HeaderSize)
+			return nullopt;
+
+		end -= paddingSize;
+	}
+
+	auto fb = reinterpret_cast<const RtcpFbHeader *>(data);
+	TransportCcFeedback feedback;
+	feedback.senderSsrc = fb->packetSenderSSRC();
+	feedback.mediaSsrc = fb->mediaSourceSSRC();
+	feedback.baseSequenceNumber = readUint16(p + 12);
+	uint16_t statusCount = readUint16(p + 14);
+	int32_t referenceTime = (int32_t(p[16]) << 16) | (int32_t(p[17]) << 8) | int32_t(p[18]);
+	if (referenceTime & 0x800000) // sign extension
+		referenceTime -= 0x1000000;
+	feedback.referenceTime = referenceTime;
+	feedback.feedbackCount = p[19];
+
+	// Packet status chunks
+	std::vector<uint8_t> symbols;
+	symbols.reserve(statusCount);
+	size_t offset = HeaderSize;
+	while (symbols.size() < statusCount) {
+		if (offset + 2 > end)
+			return nullopt;
+
+		uint16_t chunk = readUint16(p + offset);
+		offset += 2;
+
+		size_t remaining = statusCount - symbols.size();
+		if ((chunk & 0x8000) == 0) {
+			// Run length chunk: T=0, S (2 bits), run length (13 bits)
+			uint8_t symbol = (chunk >> 13) & 0x03;
+			size_t run = std::min(size_t(chunk & MaxRunLength), remaining);
+			symbols.insert(symbols.end(), run, symbol);
+		} else if ((chunk & 0x4000) == 0) {
+			// Status vector chunk: T=1, S=0, 14 one-bit symbols
+			for (int i = 0; i < 14 && i < int(remaining); ++i)
+				symbols.push_back((chunk >> (13 - i)) & 0x01);
+		} else {
+			// Status vector chunk: T=1, S=1, 7 two-bit symbols
+			for (int i = 0; i < 7 && i < int(remaining); ++i)
+				symbols.push_back((chunk >> (2 * (6 - i))) & 0x03);
+		}
+	}
+
+	// Receive deltas
+	feedback.packets.reserve(statusCount);
+	auto arrivalTime = ReferenceTimeResolution * referenceTime;
+	for (size_t i = 0; i < symbols.size(); ++i) {
+		Packet packet;
+		packet.sequenceNumber = uint16_t(feedback.baseSequenceNumber + i);
+		switch (symbols[i]) {
+		case NotReceived:
+			break;
+
+		case SmallDelta:
+			if (offset + 1 > end)
+				return nullopt;
+
+			packet.received = true;
+			packet.delta = DeltaResolution * p[offset];
+			offset += 1;
+			break;
+
+		case LargeDelta:
+			if (offset + 2 > end)
+				return nullopt;
+
+			packet.received = true;
+			packet.delta = DeltaResolution * int16_t(readUint16(p + offset));
+			offset += 2;
+			break;
+
+		default: // reserved
+			return nullopt;
+		}
+
+		if (packet.received) {
+			arrivalTime += packet.delta;
+			packet.arrivalTime = arrivalTime;
+		}
+
+		feedback.packets.push_back(packet);
+	}
+
+	return feedback;
+}
+
+message_ptr TransportCcFeedback::serialize() const {
+	if (packets.size() > std::numeric_limits<uint16_t>::max())
+		throw std::invalid_argument("Too many packets in transport-cc feedback");
+
+	// Quantize deltas, accumulating the quantized time so errors don't add up
+	std::vector<uint8_t> symbols;
+	std::vector<int16_t> deltas;
+	symbols.reserve(packets.size());
+	deltas.reserve(packets.size());
+	auto last = ReferenceTimeResolution * referenceTime;
+	size_t deltasSize = 0;
+	for (const auto &packet : packets) {
+		if (!packet.received) {
+			symbols.push_back(NotReceived);
+			continue;
+		}
+
+		double ticks = std::round(double((packet.arrivalTime - last).count()) /
+		                          double(DeltaResolution.count()));
+		if (ticks < std::numeric_limits<int16_t>::min() ||
+		    ticks > std::numeric_limits<int16_t>::max())
+			throw std::invalid_argument("Receive delta out of range in transport-cc feedback");
+
+		auto delta = int16_t(ticks);
+		bool small = delta >= 0 && delta <= 0xFF;
+		symbols.push_back(small ? SmallDelta : LargeDelta);
+		deltas.push_back(delta);
+		deltasSize += small ? 1 : 2;
+		last += DeltaResolution * delta;
+	}
+
+	// Encode status chunks greedily: long runs as run length chunks, otherwise status vectors
+	std::vector<uint16_t> chunks;
+	size_t i = 0;
+	while (i < symbols.size()) {
+		size_t run = 1;
+		while (i + run < symbols.size() && symbols[i + run] == symbols[i] && run < MaxRunLength)
+			++run;
+
+		size_t window = std::min(symbols.size() - i, size_t(14));
+		bool oneBit = std::all_of(symbols.begin() + i, symbols.begin() + i + window,
+		                          [](uint8_t s) { return s <= SmallDelta; });
+
+		if (run >= 14 || (run >= 7 && !oneBit)) {
+			chunks.push_back(uint16_t((symbols[i] << 13) | run));
+			i += run;
+		} else if (oneBit) {
+			uint16_t chunk = 0x8000;
+			for (size_t j = 0; j < window; ++j)
+				chunk |= uint16_t(symbols[i + j] << (13 - j));
+			chunks.push_back(chunk);
+			i += window;
+		} else {
+			window = std::min(symbols.size() - i, size_t(7));
+			uint16_t chunk = 0xC000;
+			for (size_t j = 0; j < window; ++j)
+				chunk |= uint16_t(symbols[i + j] << (2 * (6 - j)));
+			chunks.push_back(chunk);
+			i += window;
+		}
+	}
+
+	size_t size = HeaderSize + chunks.size() * 2 + deltasSize;
+	size_t paddingSize = (4 - size % 4) % 4;
+	size += paddingSize;
+
+	auto message = make_message(size, Message::Control);
+	auto p = reinterpret_cast<uint8_t *>(message->data());
+	auto fb = reinterpret_cast<RtcpFbHeader *>(message->data());
+	fb->header.prepareHeader(PayloadType, Format, uint16_t(size / 4 - 1));
+	fb->setPacketSenderSSRC(senderSsrc);
+	fb->setMediaSourceSSRC(mediaSsrc);
+	writeUint16(p + 12, baseSequenceNumber);
+	writeUint16(p + 14, uint16_t(packets.size()));
+	p[16] = uint8_t((referenceTime >> 16) & 0xFF);
+	p[17] = uint8_t((referenceTime >> 8) & 0xFF);
+	p[18] = uint8_t(referenceTime & 0xFF);
+	p[19] = feedbackCount;
+
+	size_t offset = HeaderSize;
+	for (uint16_t chunk : chunks) {
+		writeUint16(p + offset, chunk);
+		offset += 2;
+	}
+
+	for (int16_t delta : deltas) {
+		if (delta >= 0 && delta <= 0xFF) {
+			p[offset++] = uint8_t(delta);
+		} else {
+			writeUint16(p + offset, uint16_t(delta));
+			offset += 2;
+		}
+	}
+
+	if (paddingSize > 0) {
+		fb->header._first |= 0x20; // padding bit
+		p[size - 1] = uint8_t(paddingSize);
+	}
+
+	return message;
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "transportcchandler.hpp"
+
+#include "impl/internals.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace rtc {
+
+namespace {
+
+const size_t SentPacketsSize = 1 << 13; // must be a power of two
+const int64_t MaxStatusCount = 0x1000;  // max sequence number range per feedback
+const size_t MaxReceivedPerFeedback = 300; // keeps feedback well under the MTU
+
+const int64_t MaxDeltaTicks = std::numeric_limits<int16_t>::max();
+const int64_t MinDeltaTicks = std::numeric_limits<int16_t>::min();
+
+// Adds or extends the header extension to hold a 2-byte element with the given id
+message_ptr addTransportCcExtension(const message_ptr &message, uint8_t id) {
+	auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+	auto ext = rtp->getExtensionHeader();
+	bool twoByteHeader = ext ? (ext->profileSpecificId() & 0xFFF0) == 0x1000 : id > 14;
+	if (ext && !twoByteHeader && ext->profileSpecificId() != 0xBEDE)
+		return nullptr; // unknown extension profile
+
+	if (!twoByteHeader && id > 14)
+		return nullptr;
+
+	size_t headerSize = rtp->getSize();
+	size_t oldBodySize = ext ? ext->getSize() : 0;
+	size_t oldExtSize = ext ? sizeof(RtpExtensionHeader) + oldBodySize : 0;
+	if (headerSize + oldExtSize > message->size())
+		return nullptr;
+
+	size_t elementSize = twoByteHeader ? 2 + 2 : 1 + 2;
+	size_t newBodySize = (oldBodySize + elementSize + 3) & ~size_t(3);
+	size_t payloadSize = message->size() - headerSize - oldExtSize;
+
+	auto result = make_message(headerSize + sizeof(RtpExtensionHeader) + newBodySize + payloadSize,
+	                           message);
+	std::memcpy(result->data() + headerSize + sizeof(RtpExtensionHeader) + newBodySize,
+	            message->data() + headerSize + oldExtSize, payloadSize);
+
+	auto newRtp = reinterpret_cast<RtpHeader *>(result->data());
+	newRtp->setExtension(true);
+	auto newExt = newRtp->getExtensionHeader();
+	if (!ext)
+		newExt->setProfileSpecificId(twoByteHeader ? 0x1000 : 0xBEDE);
+
+	newExt->setHeaderLength(uint16_t(newBodySize / 4));
+	std::memset(newExt->getBody() + oldBodySize, 0, newBodySize - oldBodySize);
+	const byte zero[2] = {};
+	newExt->writeHeader(twoByteHeader, oldBodySize, id, zero, 2);
+	return result;
+}
+
+} // namespace
+
+TransportCcSession::TransportCcSession()
+    : mEpoch(std::chrono::steady_clock::now()), mSentPackets(SentPacketsSize),
+      mLastFeedbackTime(mEpoch) {}
+
+void TransportCcSession::onFeedback(feedback_callback callback) {
+	mFeedbackCallback = std::move(callback);
+}
+
+uint16_t TransportCcSession::registerSentPacket(size_t size) {
+	auto now = std::chrono::steady_clock::now();
+	std::lock_guard lock(mMutex);
+	uint16_t sequenceNumber = mSequenceNumber++;
+	auto &packet = mSentPackets[sequenceNumber & (SentPacketsSize - 1)];
+	packet.sequenceNumber = sequenceNumber;
+	packet.size = size;
+	packet.sendTime = now;
+	packet.valid = true;
+	return sequenceNumber;
+}
+
+void TransportCcSession::processFeedback(const TransportCcFeedback &feedback) {
+	std::vector<TransportCcPacketResult> results;
+	{
+		std::lock_guard lock(mMutex);
+		// The same compound RTCP packet may be dispatched to multiple tracks
+		auto id = std::make_pair(feedback.feedbackCount, feedback.baseSequenceNumber);
+		if (mLastFeedback == id)
+			return;
+
+		mLastFeedback = id;
+
+		results.reserve(feedback.packets.size());
+		for (const auto &packet : feedback.packets) {
+			const auto &sent = mSentPackets[packet.sequenceNumber & (SentPacketsSize - 1)];
+			if (!sent.valid || sent.sequenceNumber != packet.sequenceNumber)
+				continue;
+
+			TransportCcPacketResult result{sent.sequenceNumber, sent.size, sent.sendTime, nullopt};
+			if (packet.received)
+				result.arrivalTime = packet.arrivalTime;
+
+			results.push_back(std::move(result));
+		}
+	}
+
+	if (!results.empty())
+		mFeedbackCallback(std::move(results));
+}
+
+void TransportCcSession::registerReceivedPacket(uint16_t sequenceNumber) {
+	auto now = std::chrono::steady_clock::now();
+	std::lock_guard lock(mMutex);
+	int64_t unwrapped = sequenceNumber;
+	if (mLastReceivedSequenceNumber) {
+		int16_t diff = int16_t(sequenceNumber - uint16_t(*mLastReceivedSequenceNumber));
+		unwrapped = *mLastReceivedSequenceNumber + diff;
+		if (diff > 0)
+			mLastReceivedSequenceNumber = unwrapped;
+	} else {
+		mLastReceivedSequenceNumber = unwrapped;
+	}
+
+	if (mNextBaseSequenceNumber && unwrapped < *mNextBaseSequenceNumber)
+		return; // already reported
+
+	mReceivedPackets.push_back({unwrapped, now});
+}
+
+std::vector<message_ptr> TransportCcSession::generateFeedback(SSRC senderSsrc, SSRC mediaSsrc,
+                                                              std::chrono::milliseconds interval,
+                                                              size_t maxPendingPackets) {
+	using std::chrono::duration_cast;
+	using std::chrono::microseconds;
+
+	auto now = std::chrono::steady_clock::now();
+	std::lock_guard lock(mMutex);
+	if (mReceivedPackets.empty() ||
+	    (now - mLastFeedbackTime < interval && mReceivedPackets.size() < maxPendingPackets))
+		return {};
+
+	mLastFeedbackTime = now;
+
+	auto &received = mReceivedPackets;
+	std::sort(received.begin(), received.end(),
+	          [](const ReceivedPacket &a, const ReceivedPacket &b) {
+		          return a.sequenceNumber < b.sequenceNumber;
+	          });
+	received.erase(std::unique(received.begin(), received.end(),
+	                           [](const ReceivedPacket &a, const ReceivedPacket &b) {
+		                           return a.sequenceNumber == b.sequenceNumber;
+	                           }),
+	               received.end());
+
+	std::vector<message_ptr> result;
+	size_t i = 0;
+	while (i < received.size()) {
+		int64_t base = mNextBaseSequenceNumber.value_or(received[i].sequenceNumber);
+		if (received[i].sequenceNumber - base >= MaxStatusCount)
+			base = received[i].sequenceNumber; // do not report a very long loss
+
+		// Reference time is a 24-bit signed value, arrival times are expressed relative to the
+		// wrapped value
+		auto firstArrival = duration_cast<microseconds>(received[i].arrivalTime - mEpoch);
+		int64_t referenceTicks = firstArrival / TransportCcFeedback::ReferenceTimeResolution;
+		int32_t referenceTime = int32_t(referenceTicks & 0x7FFFFF);
+		auto offset = TransportCcFeedback::ReferenceTimeResolution * (referenceTicks - referenceTime);
+
+		TransportCcFeedback feedback;
+		feedback.senderSsrc = senderSsrc;
+		feedback.mediaSsrc = mediaSsrc;
+		feedback.baseSequenceNumber = uint16_t(base);
+		feedback.referenceTime = referenceTime;
+		feedback.feedbackCount = mFeedbackCount++;
+
+		auto last = TransportCcFeedback::ReferenceTimeResolution * referenceTime;
+		int64_t expected = base;
+		size_t count = 0;
+		while (i < received.size() && count < MaxReceivedPerFeedback) {
+			const auto &packet = received[i];
+			if (packet.sequenceNumber - base >= MaxStatusCount)
+				break;
+
+			auto arrivalTime = duration_cast<microseconds>(packet.arrivalTime - mEpoch) - offset;
+			auto ticks = (arrivalTime - last) / TransportCcFeedback::DeltaResolution;
+			if (ticks >= MaxDeltaTicks || ticks <= MinDeltaTicks)
+				break; // delta does not fit, continue in the next feedback
+
+			for (; expected < packet.sequenceNumber; ++expected)
+				feedback.packets.push_back({uint16_t(expected), false, {}, {}});
+
+			feedback.packets.push_back({uint16_t(expected), true, {}, arrivalTime});
+			last = arrivalTime;
+			++expected;
+			++count;
+			++i;
+		}
+
+		mNextBaseSequenceNumber = expected;
+		result.push_back(feedback.serialize());
+	}
+
+	received.clear();
+	return result;
+}
+
+TransportCcHandler::TransportCcHandler(shared_ptr<TransportCcSession> session,
+                                       uint8_t extensionId)
+    : mSession(std::move(session)), mConfiguredExtensionId(extensionId),
+      mExtensionId(extensionId) {
+	if (!mSession)
+		throw std::invalid_argument("Transport-cc session is null");
+}
+
+void TransportCcHandler::media(const Description::Media &desc) {
+	if (mConfiguredExtensionId != 0)
+		return;
+
+	uint8_t extensionId = 0;
+	for (int id : desc.extIds())
+		if (auto extMap = desc.extMap(id); extMap && extMap->uri == TransportCcFeedback::ExtensionUri)
+			extensionId = uint8_t(id);
+
+	mExtensionId = extensionId;
+}
+
+void TransportCcHandler::incoming(message_vector &messages,
+                                  [[maybe_unused]] const message_callback &send) {
+	for (const auto &message : messages) {
+		if (message->type != Message::Control)
+			continue;
+
+		size_t offset = 0;
+		while (offset + sizeof(RtcpHeader) <= message->size()) {
+			auto header = reinterpret_cast<const RtcpHeader *>(message->data() + offset);
+			size_t length = header->lengthInBytes();
+			if (offset + length > message->size())
+				break;
+
+			if (TransportCcFeedback::IsTransportCc(header)) {
+				if (auto feedback = TransportCcFeedback::Parse(message->data() + offset, length))
+					mSession->processFeedback(*feedback);
+				else
+					PLOG_VERBOSE << "Invalid transport-cc feedback";
+			}
+
+			offset += length;
+		}
+	}
+}
+
+void TransportCcHandler::outgoing(message_vector &messages,
+                                  [[maybe_unused]] const message_callback &send) {
+	uint8_t extensionId = mExtensionId.load();
+	if (extensionId == 0)
+		return;
+
+	for (auto &message : messages) {
+		if (message->type == Message::Control || message->size() < sizeof(RtpHeader))
+			continue;
+
+		auto rtp = reinterpret_cast<RtpHeader *>(message->data());
+		byte *value = nullptr;
+		size_t size = 0;
+		if (auto ext = rtp->getExtensionHeader();
+		    ext && rtp->getBody() <= reinterpret_cast<char *>(message->data() + message->size()))
+			value = ext->findHeader(extensionId, &size);
+
+		if (!value || size != 2) {
+			// The element was not reserved by the packetizer, rewrite the packet
+			auto rewritten = addTransportCcExtension(message, extensionId);
+			if (!rewritten) {
+				PLOG_VERBOSE << "Unable to add transport-cc header extension";
+				continue;
+			}
+
+			message = std::move(rewritten);
+			rtp = reinterpret_cast<RtpHeader *>(message->data());
+			value = rtp->getExtensionHeader()->findHeader(extensionId, &size);
+		}
+
+		// The message might be shared, for instance with a packet history for retransmissions, so
+		// write the sequence number in a copy
+		if (message.use_count() > 1) {
+			auto offset = value - message->data();
+			message = make_message(message->size(), message);
+			value = message->data() + offset;
+		}
+
+		uint16_t sequenceNumber = mSession->registerSentPacket(message->size());
+		value[0] = byte(sequenceNumber >> 8);
+		value[1] = byte(sequenceNumber & 0xFF);
+	}
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
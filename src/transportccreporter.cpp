@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#if RTC_ENABLE_MEDIA
+
+#include "transportccreporter.hpp"
+
+#include "impl/internals.hpp"
+
+#include <stdexcept>
+
+namespace rtc {
+
+TransportCcReporter::TransportCcReporter(shared_ptr<TransportCcSession> session,
+                                         uint8_t extensionId, std::chrono::milliseconds interval)
+    : mSession(std::move(session)), mConfiguredExtensionId(extensionId), mInterval(interval),
+      mExtensionId(extensionId) {
+	if (!mSession)
+		throw std::invalid_argument("Transport-cc session is null");
+}
+
+void TransportCcReporter::media(const Description::Media &desc) {
+	if (auto ssrcs = desc.getSSRCs(); !ssrcs.empty())
+		mLocalSsrc = ssrcs.front();
+
+	if (mConfiguredExtensionId != 0)
+		return;
+
+	uint8_t extensionId = 0;
+	for (int id : desc.extIds())
+		if (auto extMap = desc.extMap(id); extMap && extMap->uri == TransportCcFeedback::ExtensionUri)
+			extensionId = uint8_t(id);
+
+	mExtensionId = extensionId;
+}
+
+void TransportCcReporter::incoming(message_vector &messages, const message_callback &send) {
+	uint8_t extensionId = mExtensionId.load();
+	if (extensionId == 0)
+		return;
+
+	bool received = false;
+	for (const auto &message : messages) {
+		if (message->type == Message::Control || message->size() < sizeof(RtpHeader))
+			continue;
+
+		auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+		auto ext = rtp->getExtensionHeader();
+		if (!ext || rtp->getBody() > reinterpret_cast<const char *>(message->data() + message->size()))
+			continue;
+
+		size_t size = 0;
+		auto value = ext->findHeader(extensionId, &size);
+		if (!value || size != 2)
+			continue;
+
+		mSession->registerReceivedPacket(
+		    uint16_t((std::to_integer<uint16_t>(value[0]) << 8) | std::to_integer<uint16_t>(value[1])));
+		mMediaSsrc = rtp->ssrc();
+		received = true;
+	}
+
+	if (received)
+		for (auto &feedback : mSession->generateFeedback(mLocalSsrc, mMediaSsrc, mInterval))
+			send(std::move(feedback));
+}
+
+} // namespace rtc
+
+#endif /* RTC_ENABLE_MEDIA */
@@ -59,6 +59,10 @@ bool WebSocket::send(const byte *data, size_t size) {
 	return impl()->outgoing(make_message(data, data + size, Message::Binary));
 }
 
+void WebSocket::sendStream(std::function<optional<binary>()> producer) {
+	impl()->outgoingStream(std::move(producer));
+}
+
 optional<string> WebSocket::remoteAddress() const {
 	auto tcpTransport = impl()->getTcpTransport();
 	return tcpTransport ? make_optional(tcpTransport->remoteAddress()) : nullopt;
@@ -19,18 +19,40 @@ namespace rtc {
 WebSocketServer::WebSocketServer() : WebSocketServer(Configuration()) {}
 
 WebSocketServer::WebSocketServer(Configuration config)
-    : CheshireCat<impl::WebSocketServer>(std::move(config)) {}
+    : CheshireCat<impl::WebSocketServer>(std::move(config)) {
+	impl()->start();
+}
 
 WebSocketServer::~WebSocketServer() { impl()->stop(); }
 
 void WebSocketServer::stop() { impl()->stop(); }
 
-uint16_t WebSocketServer::port() const { return impl()->tcpServer->port(); }
+uint16_t WebSocketServer::port() const { return impl()->tcpServers.front()->port(); }
 
 void WebSocketServer::onClient(std::function<void(shared_ptr<WebSocket>)> callback) {
 	impl()->clientCallback = callback;
 }
 
+size_t WebSocketServer::broadcast(message_variant data,
+                                  const std::vector<shared_ptr<WebSocket>> &clients) {
+	auto frame = impl()->encodeFrame(make_message(std::move(data)));
+
+	size_t count = 0;
+	for (const auto &client : clients) {
+		if (!client || !client->isOpen())
+			continue;
+
+		try {
+			if (client->impl()->outgoingEncoded(frame))
+				++count;
+
+		} catch (const std::exception &e) {
+			PLOG_WARNING << "WebSocketServer broadcast: " << e.what();
+		}
+	}
+	return count;
+}
+
 } // namespace rtc
 
 #endif
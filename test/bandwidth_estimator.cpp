@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/bandwidthestimator.hpp"
+#include "test.hpp"
+
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <optional>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+using Clock = BandwidthEstimator::clock;
+
+// Deterministic bottleneck link: FIFO queue drained at capacity, propagation delay, tail drop and
+// random loss from a fixed-seed generator
+struct Link {
+	double capacity; // bits per second
+	double lossRate;
+	Clock::duration propagation = 20ms;
+	Clock::duration maxQueueDelay = 300ms;
+	Clock::time_point busyUntil = {};
+	uint32_t state = 12345;
+
+	double random() {
+		state = state * 1664525u + 1013904223u;
+		return double(state >> 8) / double(1u << 24);
+	}
+
+	std::optional<Clock::time_point> transmit(size_t size, Clock::time_point sendTime) {
+		if (random() < lossRate)
+			return nullopt;
+
+		auto start = max(sendTime, busyUntil);
+		if (start - sendTime > maxQueueDelay)
+			return nullopt;
+
+		busyUntil = start + chrono::duration_cast<Clock::duration>(
+		                        chrono::duration<double>(double(size) * 8. / capacity));
+		return busyUntil + propagation;
+	}
+};
+
+// Sends at the target bitrate through the link and feeds back results every 100 ms
+struct Simulation {
+	shared_ptr<BandwidthEstimator> estimator;
+	Link link;
+	Clock::time_point start = {};
+	Clock::time_point now = {};
+	double budget = 0.;
+	uint16_t sequenceNumber = 0;
+	std::deque<pair<TransportCcPacketResult, optional<Clock::time_point>>> inFlight;
+
+	void run(Clock::duration length) {
+		const size_t packetSize = 1200;
+		const auto step = 5ms;
+		auto end = now + length;
+		while (now < end) {
+			now += step;
+			budget += estimator->targetBitrate() * chrono::duration<double>(step).count() / 8.;
+			while (budget >= packetSize) {
+				budget -= packetSize;
+				TransportCcPacketResult result{sequenceNumber++, packetSize, now, nullopt};
+				inFlight.emplace_back(result, link.transmit(packetSize, now));
+			}
+
+			if ((now - start) % 100ms != 0ms)
+				continue;
+
+			vector<TransportCcPacketResult> results;
+			while (!inFlight.empty()) {
+				auto &[result, arrival] = inFlight.front();
+				if (arrival ? *arrival > now : result.sendTime + 100ms > now)
+					break;
+
+				if (arrival)
+					result.arrivalTime = chrono::duration_cast<chrono::microseconds>(*arrival - start);
+
+				results.push_back(result);
+				inFlight.pop_front();
+			}
+
+			estimator->processTransportCcFeedback(results, now);
+		}
+	}
+};
+
+} // namespace
+
+// Simulation test: delay-based estimation follows the capacity of a bottleneck link
+TestResult test_bandwidth_estimator_delay() {
+	cout << "Bandwidth estimator delay-based test" << endl;
+
+	auto estimator = make_shared<BandwidthEstimator>(300000);
+	auto pacer = make_shared<PacingHandler>(300000 * 2.5, 5ms);
+	estimator->setPacingHandler(pacer);
+
+	unsigned int reported = 0;
+	estimator->onTargetBitrate([&](unsigned int bitrate) { reported = bitrate; });
+
+	Simulation sim{estimator, Link{1500000., 0.}};
+	sim.run(20s);
+
+	unsigned int target = estimator->targetBitrate();
+	cout << "Target bitrate with 1.5 Mbps capacity: " << target << endl;
+	if (target < 900000 || target > 1800000)
+		return TestResult(false, "Target bitrate did not converge to the link capacity");
+
+	if (reported == 0 || reported < target * 0.98 || reported > target * 1.02)
+		return TestResult(false, "Target bitrate was not reported");
+
+	// Capacity drop
+	sim.link.capacity = 500000.;
+	sim.run(10s);
+
+	target = estimator->targetBitrate();
+	cout << "Target bitrate with 500 kbps capacity: " << target << endl;
+	if (target < 250000 || target > 650000)
+		return TestResult(false, "Target bitrate did not follow the capacity drop");
+
+	if (sim.link.busyUntil - sim.now > 200ms)
+		return TestResult(false, "Bottleneck queue did not drain");
+
+	return TestResult(true);
+}
+
+// Simulation test: loss-based estimation backs off on heavy loss and REMB caps the target
+// until it expires
+TestResult test_bandwidth_estimator_loss() {
+	cout << "Bandwidth estimator loss-based test" << endl;
+
+	auto estimator = make_shared<BandwidthEstimator>(2000000);
+	Simulation sim{estimator, Link{10000000., 0.2}};
+	sim.run(5s);
+
+	unsigned int target = estimator->targetBitrate();
+	cout << "Target bitrate with 20% loss: " << target << endl;
+	if (target > 500000)
+		return TestResult(false, "Target bitrate did not decrease on heavy loss");
+
+	// Light loss lets the estimate recover
+	sim.link.lossRate = 0.01;
+	sim.run(10s);
+
+	unsigned int recovered = estimator->targetBitrate();
+	cout << "Target bitrate with 1% loss: " << recovered << endl;
+	if (recovered < target * 1.5)
+		return TestResult(false, "Target bitrate did not recover on light loss");
+
+	estimator->processRemb(100000, sim.now);
+	if (estimator->targetBitrate() != 100000)
+		return TestResult(false, "Target bitrate is not capped by REMB");
+
+	// The cap holds until REMB has not been refreshed for the timeout
+	sim.run(2s);
+	if (estimator->targetBitrate() != 100000)
+		return TestResult(false, "Target bitrate is not capped by recent REMB");
+
+	sim.run(5s);
+	cout << "Target bitrate after REMB timeout: " << estimator->targetBitrate() << endl;
+	if (estimator->targetBitrate() <= 100000)
+		return TestResult(false, "Target bitrate is still capped by expired REMB");
+
+	return TestResult(true);
+}
@@ -0,0 +1,142 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "test.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+#if RTC_HAS_COROUTINES
+
+namespace {
+
+Task<void> echo(shared_ptr<WebSocket> ws) {
+	if (!co_await AsyncOpen(*ws))
+		throw runtime_error("Server-side WebSocket failed to open");
+
+	while (auto message = co_await AsyncReceive(*ws))
+		co_await AsyncSend(*ws, std::move(*message));
+
+	cout << "Coroutine: Server-side WebSocket closed" << endl;
+}
+
+Task<void> sendAll(WebSocket &ws, int count) {
+	for (int i = 0; i < count; ++i)
+		co_await AsyncSend(ws, "Hello " + to_string(i));
+}
+
+Task<size_t> exchange(WebSocket &ws, int count) {
+	if (!co_await AsyncOpen(ws))
+		throw runtime_error("WebSocket failed to open");
+
+	cout << "Coroutine: WebSocket open" << endl;
+
+	// Send from another task, so both wait on the WebSocket at the same time
+	auto sent = Spawn(sendAll(ws, count));
+
+	size_t total = 0;
+	for (int i = 0; i < count; ++i) {
+		auto message = co_await AsyncReceive(ws);
+		if (!message)
+			throw runtime_error("WebSocket closed unexpectedly");
+
+		auto received = get_if<string>(&*message);
+		if (!received || *received != "Hello " + to_string(i))
+			throw runtime_error("Unexpected message received");
+
+		total += received->size();
+	}
+
+	sent.get(); // all messages were echoed, so the sending task has completed
+	ws.close();
+	if (co_await AsyncReceive(ws))
+		throw runtime_error("Unexpected message received after closing");
+
+	co_return total;
+}
+
+} // namespace
+
+TestResult test_coroutine() {
+	InitLogger(LogLevel::Debug);
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48081;
+	serverConfig.bindAddress = "127.0.0.1";
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex mutex;
+	vector<future<void>> echoes;
+	server.onClient([&mutex, &echoes](shared_ptr<WebSocket> incoming) {
+		cout << "Coroutine: Client connection received" << endl;
+		std::lock_guard lock(mutex);
+		echoes.push_back(Spawn(echo(std::move(incoming))));
+	});
+
+	auto ws = make_shared<WebSocket>();
+	ws->open("ws://localhost:48081/");
+
+	const int count = 100;
+	auto result = Spawn(exchange(*ws, count));
+	if (result.wait_for(10s) == future_status::timeout)
+		return TestResult(false, "Exchange timeout");
+
+	size_t total;
+	try {
+		total = result.get();
+	} catch (const exception &e) {
+		return TestResult(false, e.what());
+	}
+
+	cout << "Coroutine: Exchanged " << count << " messages (" << total << " bytes)" << endl;
+	ws.reset();
+
+	{
+		std::lock_guard lock(mutex);
+		for (auto &echo : echoes) {
+			if (echo.wait_for(10s) == future_status::timeout)
+				return TestResult(false, "Echo timeout");
+
+			try {
+				echo.get();
+			} catch (const exception &e) {
+				return TestResult(false, e.what());
+			}
+		}
+		echoes.clear();
+	}
+
+	server.stop();
+	this_thread::sleep_for(1s);
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#else
+
+TestResult test_coroutine() {
+	cout << "Coroutines are not supported by the compiler, skipping" << endl;
+	return TestResult(true);
+}
+
+#endif
+
+#endif
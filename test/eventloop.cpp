@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "test.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+TestResult test_external_event_loop() {
+	InitLogger(LogLevel::Debug);
+	SetExternalEventLoop(true);
+
+	const auto loopThreadId = this_thread::get_id();
+	bool otherThread = false;
+	auto checkThread = [&]() {
+		if (this_thread::get_id() != loopThreadId)
+			otherThread = true;
+	};
+
+	const int count = 100;
+	int received = 0;
+	bool open = false, closed = false;
+	string error = [&]() -> string {
+		WebSocketServer::Configuration serverConfig;
+		serverConfig.port = 48082;
+		serverConfig.enableTls = true;
+		serverConfig.bindAddress = "127.0.0.1";
+		WebSocketServer server(std::move(serverConfig));
+
+		shared_ptr<WebSocket> client;
+		server.onClient([&](shared_ptr<WebSocket> incoming) {
+			checkThread();
+			cout << "External event loop: Client connection received" << endl;
+			client = incoming;
+			client->onMessage([&, wclient = weak_ptr<WebSocket>(client)](message_variant message) {
+				checkThread();
+				if (auto client = wclient.lock())
+					client->send(std::move(message)); // echo
+			});
+		});
+
+		WebSocket::Configuration config;
+		config.disableTlsVerification = true;
+		auto ws = make_shared<WebSocket>(config);
+
+		ws->onOpen([&]() {
+			checkThread();
+			cout << "External event loop: WebSocket open" << endl;
+			open = true;
+			for (int i = 0; i < count; ++i)
+				ws->send("Hello " + to_string(i));
+		});
+
+		ws->onMessage([&](variant<binary, string> message) {
+			checkThread();
+			if (holds_alternative<string>(message) &&
+			    get<string>(message) == "Hello " + to_string(received))
+				++received;
+		});
+
+		ws->onClosed([&]() {
+			checkThread();
+			cout << "External event loop: WebSocket closed" << endl;
+			closed = true;
+		});
+
+		ws->open("wss://localhost:48082/");
+
+		auto runUntil = [](function<bool()> condition) {
+			auto deadline = chrono::steady_clock::now() + 10s;
+			while (!condition() && chrono::steady_clock::now() < deadline)
+				Poll(100ms);
+
+			return condition();
+		};
+
+		if (!runUntil([&]() { return received == count; }))
+			return "Received " + to_string(received) + " messages instead of " + to_string(count);
+
+		if (GetPollDescriptors().empty())
+			return "No descriptors to poll";
+
+		ws->close();
+		if (!runUntil([&]() { return closed; }))
+			return "WebSocket is not closed";
+
+		if (client)
+			client->close();
+
+		return "";
+	}();
+
+	// Tasks holding the library must still be processed for the cleanup to complete
+	auto cleanup = Cleanup();
+	auto deadline = chrono::steady_clock::now() + 10s;
+	while (cleanup.wait_for(0s) != future_status::ready && chrono::steady_clock::now() < deadline)
+		Poll(100ms);
+
+	SetExternalEventLoop(false);
+
+	if (!error.empty())
+		return TestResult(false, error);
+
+	if (cleanup.wait_for(0s) != future_status::ready)
+		return TestResult(false, "Cleanup timeout");
+
+	if (!open)
+		return TestResult(false, "WebSocket did not open");
+
+	if (otherThread)
+		return TestResult(false, "Callback called from another thread");
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#endif
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "test.hpp"
+
+#if RTC_ENABLE_WEBSOCKET && RTC_TESTS_INTERNALS
+
+#include "impl/http.hpp"
+#include "impl/internals.hpp"
+#include "impl/tcptransport.hpp"
+#include "impl/wshandshake.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+using impl::HttpParser;
+
+const string Request = "GET /chat?room=1 HTTP/1.1\r\n"
+                       "Host: example.com\r\n"
+                       "Upgrade:  websocket \r\n"
+                       "Connection: Upgrade\r\n"
+                       "X-Empty:\r\n"
+                       "\r\n";
+
+size_t parse(HttpParser &parser, const string &buffer, size_t size) {
+	return parser.parse(reinterpret_cast<const byte *>(buffer.data()), size);
+}
+
+// Returns the response code of the error thrown when parsing the request, or 0 if none is thrown
+int parseError(const string &request) {
+	try {
+		HttpParser parser(HttpParser::Type::Request);
+		parse(parser, request, request.size());
+		return 0;
+	} catch (const HttpParser::Error &e) {
+		return e.responseCode();
+	}
+}
+
+string checkRequest(const HttpParser &parser) {
+	if (parser.method() != "GET" || parser.target() != "/chat?room=1" ||
+	    parser.version() != "HTTP/1.1")
+		return "Wrong request line";
+
+	if (parser.header("HOST") != "example.com" || parser.header("upgrade") != "websocket" ||
+	    parser.header("x-empty") != "" || parser.header("Origin"))
+		return "Wrong headers";
+
+	size_t count = 0;
+	parser.forEachHeader([&count](string_view, string_view) { ++count; });
+	if (count != 4)
+		return "Wrong number of headers";
+
+	return "";
+}
+
+message_ptr makeMessage(const string &str) {
+	auto data = reinterpret_cast<const byte *>(str.data());
+	return make_message(data, data + str.size());
+}
+
+bool waitFor(function<bool()> condition) {
+	auto deadline = chrono::steady_clock::now() + 5s;
+	while (!condition() && chrono::steady_clock::now() < deadline)
+		this_thread::sleep_for(10ms);
+
+	return condition();
+}
+
+} // namespace
+
+// Unit test: incremental parsing of request heads, limits and malformed request lines
+TestResult test_http_parser() {
+	cout << "HTTP parser test" << endl;
+
+	// Fed one byte at a time, the head is complete only with the final empty line
+	HttpParser parser(HttpParser::Type::Request);
+	const string buffer = Request + "Payload";
+	for (size_t size = 1; size <= Request.size(); ++size) {
+		size_t length = parse(parser, buffer, size);
+		if (length != (size == Request.size() ? Request.size() : 0))
+			return TestResult(false, "Head completed at the wrong byte");
+	}
+
+	if (auto error = checkRequest(parser); !error.empty())
+		return TestResult(false, error);
+
+	// Reads split in the middle of header names, values and line endings
+	for (size_t split : {size_t(30), size_t(47), size_t(Request.size() - 1)}) {
+		HttpParser splitParser(HttpParser::Type::Request);
+		if (parse(splitParser, buffer, split) != 0 ||
+		    parse(splitParser, buffer, buffer.size()) != Request.size())
+			return TestResult(false, "Head split across reads was not parsed");
+
+		if (auto error = checkRequest(splitParser); !error.empty())
+			return TestResult(false, error);
+	}
+
+	// A head of exactly the maximum size is accepted, a larger one is refused with 431
+	string head = "GET / HTTP/1.1\r\nX-Padding: ";
+	head += string(HTTP_MAX_HEAD_SIZE - head.size() - 4, 'a') + "\r\n\r\n";
+	if (parseError(head) != 0)
+		return TestResult(false, "Head of the maximum size was refused");
+
+	head.insert(head.size() - 4, "a");
+	if (parseError(head) != 431)
+		return TestResult(false, "Head over the maximum size was not refused with 431");
+
+	// The incomplete head is refused as soon as the limit is reached
+	if (parseError(head.substr(0, HTTP_MAX_HEAD_SIZE)) != 431)
+		return TestResult(false, "Incomplete head at the limit was not refused with 431");
+
+	string headers = "GET / HTTP/1.1\r\n";
+	for (size_t i = 0; i < HTTP_MAX_HEADERS_COUNT; ++i)
+		headers += "X-Header-" + to_string(i) + ": value\r\n";
+
+	if (parseError(headers + "\r\n") != 0)
+		return TestResult(false, "Maximum number of headers was refused");
+
+	if (parseError(headers + "X-Header: value\r\n\r\n") != 431)
+		return TestResult(false, "Too many headers were not refused with 431");
+
+	// Malformed request lines
+	const string malformed[] = {"\r\n\r\n", " \r\n\r\n", "GET\r\n\r\n", "GET \r\nHost: a\r\n\r\n"};
+	for (const auto &request : malformed)
+		if (parseError(request) != 400)
+			return TestResult(false, "Malformed request line was not refused with 400");
+
+	return TestResult(true);
+}
+
+// Integration test: a WebSocket server answers a request with oversized headers with 431
+TestResult test_http_header_limit_response() {
+	InitLogger(LogLevel::Debug);
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48085;
+	serverConfig.bindAddress = "127.0.0.1";
+	WebSocketServer server(std::move(serverConfig));
+
+	mutex mutex;
+	shared_ptr<WebSocket> client;
+	atomic<bool> open = false;
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		incoming->onOpen([&open]() { open = true; });
+		lock_guard lock(mutex);
+		client = std::move(incoming);
+	});
+
+	string response;
+	atomic<bool> closed = false;
+	auto tcp = make_shared<impl::TcpTransport>("127.0.0.1", "48085", nullptr);
+	tcp->onRecv([&](message_ptr message) {
+		if (!message) {
+			closed = true;
+			return;
+		}
+
+		lock_guard lock(mutex);
+		response.append(reinterpret_cast<const char *>(message->data()), message->size());
+	});
+	tcp->start();
+	if (!waitFor([&]() { return tcp->state() == impl::Transport::State::Connected; }))
+		return TestResult(false, "TCP connection failed");
+
+	// Send the headers in several writes, so the server sees the head grow over the limit
+	const string line = "X-Padding: " + string(1000, 'a') + "\r\n";
+	string request = "GET / HTTP/1.1\r\nHost: 127.0.0.1\r\n";
+	tcp->send(makeMessage(request));
+	for (int i = 0; i < 20 && !closed; ++i) {
+		tcp->send(makeMessage(line));
+		this_thread::sleep_for(10ms);
+	}
+
+	if (!waitFor([&]() { return closed.load(); }))
+		return TestResult(false, "Connection was not closed");
+
+	tcp->stop();
+	server.stop();
+
+	lock_guard lock(mutex);
+	client.reset();
+	if (open)
+		return TestResult(false, "WebSocket with oversized headers was open");
+
+	if (response.rfind("HTTP/1.1 431 Request Header Fields Too Large\r\n", 0) != 0)
+		return TestResult(false, "Unexpected response: " + response.substr(0, response.find('\r')));
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+
+static bool isContiguous(const message_vector &packets) {
+	for (size_t i = 1; i < packets.size(); ++i) {
+		auto prev = reinterpret_cast<const RtpHeader *>(packets[i - 1]->data());
+		auto cur = reinterpret_cast<const RtpHeader *>(packets[i]->data());
+		if (uint16_t(prev->seqNumber() + 1) != cur->seqNumber())
+			return false;
+	}
+	return true;
+}
+
+static bool allMarked(const message_vector &packets) {
+	for (const auto &packet : packets)
+		if (!reinterpret_cast<const RtpHeader *>(packet->data())->marker())
+			return false;
+
+	return true;
+}
+
+// L2T2 structure with decode targets S0T0, S0T1, S1T0 and S1T1
+static FrameDependencyStructure makeL2T2Structure() {
+	using DTI = DecodeTargetIndication;
+	const DTI N = DTI::NotPresent, D = DTI::Discardable, S = DTI::Switch, R = DTI::Required;
+
+	FrameDependencyStructure structure;
+	structure.templateIdOffset = 1;
+	structure.decodeTargetCount = 4;
+	structure.resolutions = {{320, 180}, {640, 360}};
+	auto add = [&](int spatialId, int temporalId, vector<DTI> dtis, vector<int> frameDiffs) {
+		FrameDependencyTemplate frameTemplate;
+		frameTemplate.spatialId = spatialId;
+		frameTemplate.temporalId = temporalId;
+		frameTemplate.decodeTargetIndications = std::move(dtis);
+		frameTemplate.frameDiffs = std::move(frameDiffs);
+		structure.templates.push_back(std::move(frameTemplate));
+	};
+	add(0, 0, {S, S, S, S}, {});  // key frame, spatial layer 0
+	add(0, 0, {S, S, R, R}, {4}); // base temporal layer
+	add(0, 1, {N, D, N, R}, {2});
+	add(1, 0, {N, N, S, S}, {1}); // key frame, spatial layer 1
+	add(1, 0, {N, N, R, R}, {4, 1});
+	add(1, 1, {N, N, N, D}, {2, 1});
+	return structure;
+}
+
+// Unit test: dependency descriptors are read back and used to select layers
+TestResult test_layer_selector_dependency_descriptor() {
+	cout << "Layer selector dependency descriptor test" << endl;
+
+	const uint8_t ddId = 3;
+	auto structure = makeL2T2Structure();
+
+	// Round trip
+	{
+		DependencyDescriptorContext context;
+		context.structure = structure;
+		context.descriptor.frameNumber = 42;
+		context.descriptor.structureAttached = true;
+		context.descriptor.dependencyTemplate = structure.templates[0];
+		DependencyDescriptorWriter writer(context);
+		binary buf(writer.getSize());
+		writer.writeTo(buf.data(), buf.size());
+
+		DependencyDescriptorReader reader;
+		auto descriptor = reader.read(buf.data(), buf.size());
+		if (!descriptor || descriptor->frameNumber != 42 || !descriptor->structureAttached ||
+		    !descriptor->resolution || descriptor->resolution->width != 320)
+			return TestResult(false, "Failed to read the dependency descriptor");
+
+		auto read = reader.structure();
+		if (!read || read->templateIdOffset != 1 || read->decodeTargetCount != 4 ||
+		    read->templates.size() != structure.templates.size() ||
+		    read->templates[4].frameDiffs != vector<int>{4, 1} ||
+		    read->templates[5].decodeTargetIndications !=
+		        structure.templates[5].decodeTargetIndications)
+			return TestResult(false, "Failed to read the template dependency structure");
+
+		auto layers = DependencyDescriptorReader::DecodeTargetLayers(*read);
+		if (layers != vector<pair<int, int>>{{0, 0}, {0, 1}, {1, 0}, {1, 1}})
+			return TestResult(false, "Wrong decode target layers");
+	}
+
+	auto rtpConfig = make_shared<RtpPacketizationConfig>(42, "video", 96, 90000);
+	rtpConfig->dependencyDescriptorId = ddId;
+	rtpConfig->dependencyDescriptorContext.emplace();
+	rtpConfig->dependencyDescriptorContext->structure = structure;
+	RtpPacketizer packetizer(rtpConfig);
+
+	Description::Video video("video", Description::Direction::SendOnly);
+	video.addVP8Codec(96);
+	video.addExtMap(Description::Entry::ExtMap(ddId, LayerSelector::DependencyDescriptorUri));
+
+	auto selector = make_shared<LayerSelector>();
+	selector->media(video);
+	selector->setTargetLayers(0, 0);
+
+	message_vector forwarded;
+	int frameNumber = 0;
+	auto feed = [&](int templateIndex, bool keyframe) {
+		auto &descriptor = rtpConfig->dependencyDescriptorContext->descriptor;
+		descriptor.frameNumber = frameNumber++;
+		descriptor.structureAttached = keyframe && templateIndex == 0;
+		descriptor.dependencyTemplate = structure.templates[templateIndex];
+		message_vector messages = {make_message(100, Message::Binary)};
+		packetizer.outgoing(messages, [](message_ptr) {});
+		// Only the last layer frame of a picture is marked
+		auto rtp = reinterpret_cast<RtpHeader *>(messages[0]->data());
+		rtp->setMarker(structure.templates[templateIndex].spatialId == 1);
+
+		selector->outgoing(messages, [](message_ptr) {});
+		forwarded.insert(forwarded.end(), messages.begin(), messages.end());
+	};
+	auto feedPicture = [&](int temporalId, bool keyframe) {
+		if (keyframe) {
+			feed(0, true);
+			feed(3, true);
+		} else if (temporalId == 0) {
+			feed(1, false);
+			feed(4, false);
+		} else {
+			feed(2, false);
+			feed(5, false);
+		}
+	};
+
+	for (int i = 0; i < 8; ++i)
+		feedPicture(i % 2, i == 0);
+
+	if (forwarded.size() != 4)
+		return TestResult(false, "Wrong number of forwarded packets for S0T0");
+
+	if (!isContiguous(forwarded))
+		return TestResult(false, "Sequence numbers are not contiguous");
+
+	if (!allMarked(forwarded))
+		return TestResult(false, "Marker bit was not moved to the base layer");
+
+	// Switching up the temporal layer happens at the next switch point
+	selector->setTargetLayers(0, 1);
+	feedPicture(1, false);
+	feedPicture(0, false);
+	feedPicture(1, false);
+	if (forwarded.size() != 6 || selector->currentLayers() != make_pair(0, 1))
+		return TestResult(false, "Temporal layer switch failed");
+
+	// Switching up the spatial layer waits for a key frame
+	selector->setTargetLayers(1, 1);
+	feedPicture(0, false);
+	if (forwarded.size() != 7)
+		return TestResult(false, "Spatial layer switched without a switch point");
+
+	feedPicture(0, true);
+	feedPicture(1, false);
+	if (forwarded.size() != 11 || selector->currentLayers() != make_pair(1, 1))
+		return TestResult(false, "Spatial layer switch failed");
+
+	// Switching down happens at the next frame
+	selector->setTargetLayers(0, 0);
+	feedPicture(1, false);
+	feedPicture(0, false);
+	if (forwarded.size() != 12 || !isContiguous(forwarded))
+		return TestResult(false, "Layer switch down failed");
+
+	return TestResult(true);
+}
+
+// Unit test: VP9 layers are selected with the payload descriptor
+TestResult test_layer_selector_vp9() {
+	cout << "Layer selector VP9 test" << endl;
+
+	Description::Video video("video", Description::Direction::RecvOnly);
+	video.addVP9Codec(98);
+
+	auto selector = make_shared<LayerSelector>();
+	selector->media(video);
+	selector->setTargetLayers(0, 0);
+
+	message_vector forwarded;
+	uint16_t seq = 0;
+	auto feed = [&](uint16_t pictureId, int spatialId, int temporalId, bool keyframe) {
+		auto message = make_message(sizeof(RtpHeader) + 8, Message::Binary);
+		auto rtp = reinterpret_cast<RtpHeader *>(message->data());
+		rtp->preparePacket();
+		rtp->setPayloadType(98);
+		rtp->setSsrc(7);
+		rtp->setSeqNumber(seq++);
+		rtp->setTimestamp(pictureId * 3000);
+		rtp->setMarker(spatialId == 1);
+		// I, P, L, B, E; 15-bit picture ID; TID, SID
+		uint8_t first = 0x80 | (keyframe ? 0x00 : 0x40) | 0x20 | 0x08 | 0x04;
+		auto payload = message->data() + sizeof(RtpHeader);
+		payload[0] = byte(first);
+		payload[1] = byte(0x80 | (pictureId >> 8));
+		payload[2] = byte(pictureId & 0xFF);
+		payload[3] = byte((temporalId << 5) | (spatialId << 1));
+
+		message_vector messages = {message};
+		selector->incoming(messages, [](message_ptr) {});
+		forwarded.insert(forwarded.end(), messages.begin(), messages.end());
+	};
+
+	uint16_t pictureId = 1000;
+	for (int i = 0; i < 8; ++i, ++pictureId) {
+		feed(pictureId, 0, i % 2, i == 0);
+		feed(pictureId, 1, i % 2, i == 0);
+	}
+
+	if (forwarded.size() != 4 || !isContiguous(forwarded) || !allMarked(forwarded))
+		return TestResult(false, "Layers were not dropped");
+
+	// Switching up the spatial layer waits for a key frame
+	selector->setTargetLayers(1, 0);
+	feed(pictureId, 0, 0, false);
+	feed(pictureId++, 1, 0, false);
+	if (forwarded.size() != 5)
+		return TestResult(false, "Spatial layer switched without a key frame");
+
+	feed(pictureId, 0, 0, true);
+	feed(pictureId++, 1, 0, true);
+	feed(pictureId, 0, 1, false);
+	feed(pictureId++, 1, 1, false);
+	if (forwarded.size() != 7 || selector->currentLayers() != make_pair(1, 0) ||
+	    !isContiguous(forwarded))
+		return TestResult(false, "Spatial layer switch failed");
+
+	return TestResult(true);
+}
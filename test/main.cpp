@@ -44,11 +44,35 @@ TestResult test_rtcp_app_empty_data();
 TestResult test_rtcp_app_send();
 TestResult test_rtcp_app_multiple_in_compound();
 TestResult test_rtcp_app_integration();
+TestResult test_nack_responder_history();
+TestResult test_nack_responder_shared_history();
+TestResult test_transport_cc_feedback();
+TestResult test_transport_cc_loop();
+TestResult test_bandwidth_estimator_delay();
+TestResult test_bandwidth_estimator_loss();
+TestResult test_pacing_rate();
+TestResult test_pacing_priority();
+TestResult test_pacing_shared_budget();
+TestResult test_pacing_external_event_loop();
+TestResult test_rtcp_receiving_session();
+TestResult test_rtp_forwarder_simulcast();
+TestResult test_rtp_forwarder_temporal();
+TestResult test_layer_selector_dependency_descriptor();
+TestResult test_layer_selector_vp9();
+TestResult test_parallel_srtp();
 TestResult test_capi_connectivity();
 TestResult test_capi_track();
 TestResult test_websocket();
 TestResult test_websocketserver();
+TestResult test_websocketserver_accept_threads();
 TestResult test_capi_websocketserver();
+TestResult test_coroutine();
+TestResult test_external_event_loop();
+TestResult test_tls_session_resumption();
+TestResult test_http_parser();
+TestResult test_http_header_limit_response();
+TestResult test_tcp_partial_write();
+TestResult test_websocket_partial_write();
 size_t benchmark(chrono::milliseconds duration);
 
 void test_benchmark() {
@@ -109,13 +133,45 @@ static const vector<Test> tests = {
     Test("RTCP APP send", test_rtcp_app_send),
     Test("RTCP APP multiple in compound", test_rtcp_app_multiple_in_compound),
     Test("RTCP APP integration", test_rtcp_app_integration),
+    Test("RTP packet history", test_nack_responder_history),
+    Test("RtcpNackResponder shared history", test_nack_responder_shared_history),
+    Test("Transport-cc feedback", test_transport_cc_feedback),
+    Test("Transport-cc loop", test_transport_cc_loop),
+    Test("Bandwidth estimator delay-based", test_bandwidth_estimator_delay),
+    Test("Bandwidth estimator loss-based", test_bandwidth_estimator_loss),
+    Test("Pacing rate", test_pacing_rate),
+    Test("Pacing priority", test_pacing_priority),
+    Test("Pacing shared budget", test_pacing_shared_budget),
+    Test("RTCP receiving session", test_rtcp_receiving_session),
+    Test("RTP forwarder simulcast", test_rtp_forwarder_simulcast),
+    Test("RTP forwarder temporal layers", test_rtp_forwarder_temporal),
+    Test("Layer selector dependency descriptor", test_layer_selector_dependency_descriptor),
+    Test("Layer selector VP9", test_layer_selector_vp9),
+    Test("WebRTC parallel SRTP", test_parallel_srtp),
 #endif
 #if RTC_ENABLE_WEBSOCKET
     // TODO: Temporarily disabled as the echo service is unreliable
     // Test("WebSocket", test_websocket),
     Test("WebSocketServer", test_websocketserver),
+    Test("WebSocketServer accept threads", test_websocketserver_accept_threads),
+#if RTC_TESTS_INTERNALS
+    Test("TLS session resumption", test_tls_session_resumption),
+    Test("HTTP parser", test_http_parser),
+    Test("HTTP header limit response", test_http_header_limit_response),
+#ifndef _WIN32
+    Test("TCP partial write", test_tcp_partial_write),
+#endif
+#endif
+    Test("WebSocket partial write", test_websocket_partial_write),
+    Test("Coroutine", test_coroutine), // skipped without C++20 coroutines
 #endif
     Test("Cleanup", test_cleanup),
+#if RTC_ENABLE_WEBSOCKET
+    Test("External event loop", test_external_event_loop),
+#endif
+#if RTC_ENABLE_MEDIA
+    Test("Pacing external event loop", test_pacing_external_event_loop),
+#endif
     // C API tests
     Test("WebRTC C API connectivity", test_capi_connectivity),
 #if RTC_ENABLE_MEDIA
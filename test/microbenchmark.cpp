@@ -0,0 +1,553 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+// Microbenchmarks of internal hot paths, linked statically against the library
+
+#ifdef MICROBENCHMARK_MAIN
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include "impl/srtppipeline.hpp"
+#include "impl/track.hpp"
+#include "impl/wshandshake.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+#include <malloc.h>
+#define HAVE_MALLINFO2 1
+#endif
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+using chrono::milliseconds;
+using chrono::steady_clock;
+
+namespace {
+
+// Calls func repeatedly for the given duration and returns the number of calls per second
+double measure(milliseconds duration, const function<void()> &func) {
+	const size_t batch = 1024;
+	size_t count = 0;
+	auto start = steady_clock::now();
+	auto end = start + duration;
+	steady_clock::time_point now;
+	do {
+		for (size_t i = 0; i < batch; ++i)
+			func();
+
+		count += batch;
+		now = steady_clock::now();
+	} while (now < end);
+
+	return double(count) / chrono::duration<double>(now - start).count();
+}
+
+void report(const string &name, double rate, const string &unit) {
+	cout << left << setw(48) << name << right << setw(14) << fixed << setprecision(0) << rate
+	     << " " << unit << endl;
+}
+
+// Track ingress: packets go through impl::Track::incoming() and the media handler chain, then
+// are popped from the receive queue as the user would. Optionally, another thread concurrently
+// reads the track state like the send path does.
+double benchmarkTrackIncoming(shared_ptr<MediaHandler> handler, milliseconds duration,
+                              bool concurrentReader = false) {
+	Description::Video video("video", Description::Direction::RecvOnly);
+	video.addH264Codec(96);
+	video.addSSRC(1, "video");
+
+	auto track = make_shared<impl::Track>(weak_ptr<impl::PeerConnection>(), std::move(video));
+	if (handler)
+		track->setMediaHandler(std::move(handler));
+
+	atomic<bool> running = true;
+	thread reader;
+	if (concurrentReader)
+		reader = thread([&]() {
+			while (running)
+				if (track->direction() == Description::Direction::Inactive ||
+				    !track->getMediaHandler())
+					this_thread::yield();
+		});
+
+	uint16_t seq = 0;
+	double rate = measure(duration, [&]() {
+		track->incoming(makeRtpPacket(42, seq, seq * 3000u, 1200));
+		++seq;
+		track->receive();
+	});
+
+	running = false;
+	if (reader.joinable())
+		reader.join();
+
+	track->close();
+	return rate;
+}
+
+// SRTP protection of packets from several SSRCs, either inline with a single session like the
+// default send path, or with the given number of parallel workers
+double benchmarkSrtpProtect(srtp_profile_t profile, size_t workers, size_t ssrcs,
+                            milliseconds duration) {
+	srtp_policy_t policy = {};
+	if (srtp_crypto_policy_set_from_profile_for_rtp(&policy.rtp, profile) ||
+	    srtp_crypto_policy_set_from_profile_for_rtcp(&policy.rtcp, profile))
+		throw runtime_error("SRTP profile is not supported");
+
+	vector<unsigned char> key(srtp_profile_get_master_key_length(profile) +
+	                              srtp_profile_get_master_salt_length(profile),
+	                          0x42);
+	policy.ssrc.type = ssrc_any_outbound;
+	policy.key = key.data();
+	policy.window_size = 1024;
+	policy.allow_repeat_tx = true;
+
+	const size_t payloadSize = 1200;
+	vector<uint16_t> seqs(ssrcs, 0);
+	size_t next = 0;
+	auto makePacket = [&]() {
+		SSRC ssrc = SSRC(next++ % ssrcs);
+		uint16_t seq = seqs[ssrc]++;
+		auto message = makeRtpPacket(ssrc + 1, seq, seq * 3000u, payloadSize);
+		return make_message(message->size() + SRTP_MAX_TRAILER_LEN, message);
+	};
+	auto protect = [](srtp_t session, message_ptr message) {
+		int size = int(message->size() - SRTP_MAX_TRAILER_LEN);
+		if (srtp_err_status_t err = srtp_protect(session, message->data(), &size))
+			throw runtime_error("SRTP protect error, status=" + to_string(int(err)));
+	};
+
+	if (workers == 0) {
+		srtp_t session;
+		if (srtp_create(&session, &policy))
+			throw runtime_error("srtp_create failed");
+
+		double rate = measure(duration, [&]() { protect(session, makePacket()); });
+		srtp_dealloc(session);
+		return rate;
+	}
+
+	impl::SrtpPipeline pipeline(
+	    workers,
+	    [&protect](srtp_t session, message_ptr &message) {
+		    protect(session, message);
+		    return true;
+	    },
+	    [](message_vector &) {});
+	pipeline.addStream(policy);
+
+	// Push packets in bursts, like a track sending a frame, and wait for the workers
+	const size_t burst = 256;
+	size_t count = 0;
+	auto start = steady_clock::now();
+	auto end = start + duration;
+	steady_clock::time_point now;
+	do {
+		for (size_t i = 0; i < burst; ++i)
+			pipeline.push(makePacket());
+
+		pipeline.join();
+		count += burst;
+		now = steady_clock::now();
+	} while (now < end);
+
+	return double(count) / chrono::duration<double>(now - start).count();
+}
+
+#if RTC_ENABLE_WEBSOCKET
+// Server-side parsing of a WebSocket handshake request as sent by a browser
+double benchmarkWsHandshakeParsing(milliseconds duration) {
+	const string request = "GET /socket?room=42 HTTP/1.1\r\n"
+	                       "Host: signaling.example.com\r\n"
+	                       "Connection: Upgrade\r\n"
+	                       "Pragma: no-cache\r\n"
+	                       "Cache-Control: no-cache\r\n"
+	                       "User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, "
+	                       "like Gecko) Chrome/120.0.0.0 Safari/537.36\r\n"
+	                       "Upgrade: websocket\r\n"
+	                       "Origin: https://example.com\r\n"
+	                       "Sec-WebSocket-Version: 13\r\n"
+	                       "Accept-Encoding: gzip, deflate, br\r\n"
+	                       "Accept-Language: en-US,en;q=0.9\r\n"
+	                       "Cookie: session=0123456789abcdef; theme=dark\r\n"
+	                       "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+	                       "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+	                       "\r\n";
+
+	auto data = reinterpret_cast<const byte *>(request.data());
+	return measure(duration, [&]() {
+		impl::WsHandshake handshake;
+		if (handshake.parseHttpRequest(data, request.size()) != request.size())
+			throw runtime_error("WebSocket handshake request parsing failed");
+	});
+}
+
+// Fan-out from a local WebSocket server to many clients, either sending to each client in turn or
+// broadcasting a single encoded frame. Each client needs two sockets, so the file descriptor limit
+// might need to be raised (ulimit -n) for large client counts.
+void benchmarkWebSocketFanout(size_t clientCount, size_t messageSize, milliseconds duration) {
+	WebSocketServer::Configuration config;
+	config.port = 0; // any
+	config.bindAddress = "127.0.0.1";
+	WebSocketServer server(std::move(config));
+
+	mutex mutex;
+	vector<shared_ptr<WebSocket>> serverClients;
+	server.onClient([&](shared_ptr<WebSocket> ws) {
+		std::lock_guard lock(mutex);
+		serverClients.push_back(std::move(ws));
+	});
+
+	atomic<size_t> openCount = 0;
+	atomic<size_t> receivedCount = 0;
+	const string url = "ws://127.0.0.1:" + to_string(server.port()) + "/";
+	vector<shared_ptr<WebSocket>> clients;
+	clients.reserve(clientCount);
+	while (clients.size() < clientCount) {
+		// Connect in small batches, connection storms are measured separately
+		const size_t batch = 8;
+		for (size_t i = 0; i < batch && clients.size() < clientCount; ++i) {
+			auto ws = make_shared<WebSocket>();
+			ws->onOpen([&openCount]() { ++openCount; });
+			ws->onMessage([&receivedCount](message_variant) { ++receivedCount; });
+			ws->open(url);
+			clients.push_back(std::move(ws));
+		}
+
+		auto deadline = steady_clock::now() + 10s;
+		while (openCount < clients.size() && steady_clock::now() < deadline)
+			this_thread::sleep_for(1ms);
+
+		if (openCount < clients.size())
+			throw runtime_error("Only " + to_string(openCount) + " WebSocket clients connected");
+	}
+
+	{
+		std::lock_guard lock(mutex);
+		if (serverClients.size() != clientCount)
+			throw runtime_error("Unexpected number of WebSocket server clients");
+	}
+
+	const binary payload(messageSize, byte(0x42));
+	// Returns delivered messages per second and the sending cost per message in nanoseconds
+	auto run = [&](const function<void()> &sendAll) {
+		receivedCount = 0;
+		size_t sentCount = 0;
+		chrono::duration<double> sendTime(0);
+		auto start = steady_clock::now();
+		auto end = start + duration;
+		steady_clock::time_point now;
+		do {
+			auto sendStart = steady_clock::now();
+			sendAll();
+			sendTime += steady_clock::now() - sendStart;
+			sentCount += clientCount;
+
+			// Wait for delivery so queues stay bounded
+			while (receivedCount < sentCount) {
+				if (steady_clock::now() > end + 10s)
+					throw runtime_error("WebSocket messages were not delivered");
+
+				this_thread::yield();
+			}
+			now = steady_clock::now();
+		} while (now < end);
+
+		return pair{double(receivedCount) / chrono::duration<double>(now - start).count(),
+		            1e9 * sendTime.count() / double(sentCount)};
+	};
+
+	const string suffix = ", " + to_string(clientCount) + " clients";
+	auto [sendRate, sendCost] = run([&]() {
+		for (const auto &ws : serverClients)
+			ws->send(payload);
+	});
+	report("WebSocket send to each client" + suffix, sendRate, "messages/s");
+	report("WebSocket send to each client" + suffix, sendCost, "ns/message");
+
+	auto [broadcastRate, broadcastCost] = run([&]() { server.broadcast(payload, serverClients); });
+	report("WebSocket broadcast" + suffix, broadcastRate, "messages/s");
+	report("WebSocket broadcast" + suffix, broadcastCost, "ns/message");
+
+	for (const auto &ws : clients)
+		ws->close();
+
+	server.stop();
+}
+
+// Connection storm: all clients connect to a local WebSocket server at once, like after a server
+// restart. Returns the number of established connections per second.
+double benchmarkWebSocketAccept(size_t clientCount, unsigned int acceptThreads, bool tls) {
+	WebSocketServer::Configuration config;
+	config.port = 0; // any
+	config.bindAddress = "127.0.0.1";
+	config.enableTls = tls;
+	config.acceptThreads = acceptThreads;
+	WebSocketServer server(std::move(config));
+
+	mutex mutex;
+	vector<shared_ptr<WebSocket>> serverClients;
+	serverClients.reserve(clientCount);
+	server.onClient([&](shared_ptr<WebSocket> ws) {
+		std::lock_guard lock(mutex);
+		serverClients.push_back(std::move(ws));
+	});
+
+	WebSocket::Configuration clientConfig;
+	clientConfig.disableTlsVerification = true;
+
+	atomic<size_t> openCount = 0;
+	const string url =
+	    string(tls ? "wss" : "ws") + "://127.0.0.1:" + to_string(server.port()) + "/";
+	vector<shared_ptr<WebSocket>> clients;
+	clients.reserve(clientCount);
+	auto start = steady_clock::now();
+	for (size_t i = 0; i < clientCount; ++i) {
+		auto ws = make_shared<WebSocket>(clientConfig);
+		ws->onOpen([&openCount]() { ++openCount; });
+		ws->open(url);
+		clients.push_back(std::move(ws));
+	}
+
+	auto deadline = start + 120s;
+	while (openCount < clientCount && steady_clock::now() < deadline)
+		this_thread::sleep_for(1ms);
+
+	auto end = steady_clock::now();
+	if (openCount < clientCount)
+		throw runtime_error("Only " + to_string(openCount) + " WebSocket clients connected");
+
+	for (const auto &ws : clients)
+		ws->close();
+
+	server.stop();
+	return double(clientCount) / chrono::duration<double>(end - start).count();
+}
+
+// Reconnections: a client repeatedly connects to a local WebSocket server over TLS and closes,
+// like a signaling client on a flaky network. After the first connection, TLS sessions are
+// resumed. Returns the number of connections per second.
+double benchmarkWebSocketReconnect(milliseconds duration) {
+	WebSocketServer::Configuration config;
+	config.port = 0; // any
+	config.bindAddress = "127.0.0.1";
+	config.enableTls = true;
+	WebSocketServer server(std::move(config));
+
+	mutex mutex;
+	shared_ptr<WebSocket> serverClient;
+	server.onClient([&](shared_ptr<WebSocket> ws) {
+		std::lock_guard lock(mutex);
+		serverClient = std::move(ws);
+	});
+
+	WebSocket::Configuration clientConfig;
+	clientConfig.disableTlsVerification = true;
+
+	const string url = "wss://127.0.0.1:" + to_string(server.port()) + "/";
+	auto connect = [&]() {
+		promise<void> opened;
+		auto ws = make_shared<WebSocket>(clientConfig);
+		ws->onOpen([&opened]() { opened.set_value(); });
+		ws->open(url);
+		if (opened.get_future().wait_for(10s) != future_status::ready)
+			throw runtime_error("WebSocket client failed to connect");
+
+		ws->resetCallbacks();
+		ws->close();
+	};
+
+	connect(); // full handshake
+
+	size_t count = 0;
+	auto start = steady_clock::now();
+	auto end = start + duration;
+	steady_clock::time_point now;
+	do {
+		connect();
+		++count;
+		now = steady_clock::now();
+	} while (now < end);
+
+	server.stop();
+	return double(count) / chrono::duration<double>(now - start).count();
+}
+
+#if HAVE_MALLINFO2
+size_t heapUsage() {
+	auto info = mallinfo2(); // all arenas
+	return info.uordblks + info.hblkhd;
+}
+
+// Idle connections: clients connect to a local WebSocket server, exchange a message, then stay
+// idle like signaling clients. Returns the heap memory per connection, counting both ends.
+double benchmarkWebSocketIdleMemory(size_t clientCount, bool tls) {
+	WebSocketServer::Configuration config;
+	config.port = 0; // any
+	config.bindAddress = "127.0.0.1";
+	config.enableTls = tls;
+	WebSocketServer server(std::move(config));
+
+	mutex mutex;
+	vector<shared_ptr<WebSocket>> serverClients;
+	server.onClient([&](shared_ptr<WebSocket> ws) {
+		weak_ptr<WebSocket> weakWs = ws;
+		ws->onMessage([weakWs](message_variant message) {
+			if (auto ws = weakWs.lock())
+				ws->send(std::move(message)); // echo
+		});
+		std::lock_guard lock(mutex);
+		serverClients.push_back(std::move(ws));
+	});
+
+	WebSocket::Configuration clientConfig;
+	clientConfig.disableTlsVerification = true;
+
+	atomic<size_t> receivedCount = 0;
+	const string url =
+	    string(tls ? "wss" : "ws") + "://127.0.0.1:" + to_string(server.port()) + "/";
+	const binary payload(16 * 1024, byte(0x42));
+	vector<shared_ptr<WebSocket>> clients;
+	clients.reserve(clientCount + 16);
+	auto connect = [&](size_t count) {
+		const size_t target = clients.size() + count;
+		while (clients.size() < target) {
+			const size_t batch = 8;
+			for (size_t i = 0; i < batch && clients.size() < target; ++i) {
+				auto ws = make_shared<WebSocket>(clientConfig);
+				weak_ptr<WebSocket> weakWs = ws;
+				ws->onOpen([weakWs, &payload]() {
+					if (auto ws = weakWs.lock())
+						ws->send(payload);
+				});
+				ws->onMessage([&receivedCount](message_variant) { ++receivedCount; });
+				ws->open(url);
+				clients.push_back(std::move(ws));
+			}
+
+			auto deadline = steady_clock::now() + 10s;
+			while (receivedCount < clients.size() && steady_clock::now() < deadline)
+				this_thread::sleep_for(1ms);
+
+			if (receivedCount < clients.size())
+				throw runtime_error("Only " + to_string(receivedCount) +
+				                    " WebSocket clients received an echo");
+		}
+		this_thread::sleep_for(100ms); // let transports settle
+	};
+
+	connect(16); // warm up shared state like TLS contexts and session caches
+
+	const size_t before = heapUsage();
+	connect(clientCount);
+	const size_t after = heapUsage();
+
+	for (const auto &ws : clients)
+		ws->close();
+
+	server.stop();
+	return double(after - before) / double(clientCount);
+}
+#endif
+#endif
+
+} // namespace
+
+int main(int argc, char **argv) {
+	rtc::InitLogger(LogLevel::Warning);
+
+	milliseconds duration = 2s;
+	if (argc > 1)
+		duration = milliseconds(stoi(argv[1]));
+
+	size_t clientCount = 10000;
+	if (argc > 2)
+		clientCount = size_t(stoul(argv[2]));
+
+	try {
+		rtc::Preload(); // thread pool and libSRTP
+
+		report("Track ingress, no handler", benchmarkTrackIncoming(nullptr, duration),
+		       "packets/s");
+		report("Track ingress, RtcpReceivingSession",
+		       benchmarkTrackIncoming(make_shared<RtcpReceivingSession>(), duration), "packets/s");
+		report("Track ingress, RtcpReceivingSession, concurrent",
+		       benchmarkTrackIncoming(make_shared<RtcpReceivingSession>(), duration, true),
+		       "packets/s");
+
+		// Per-packet protect cost of each profile with a single session
+		const pair<const char *, srtp_profile_t> profiles[] = {
+		    {"AEAD_AES_128_GCM", srtp_profile_aead_aes_128_gcm},
+		    {"AEAD_AES_256_GCM", srtp_profile_aead_aes_256_gcm},
+		    {"AES_CM_128_HMAC_SHA1_80", srtp_profile_aes128_cm_sha1_80},
+		    {"AES_CM_128_HMAC_SHA1_32", srtp_profile_aes128_cm_sha1_32}};
+		for (auto [name, profile] : profiles)
+			report(string("SRTP protect ") + name,
+			       1e9 / benchmarkSrtpProtect(profile, 0, 1, duration), "ns/packet");
+
+		const size_t workers = max(thread::hardware_concurrency(), 2u);
+		for (auto [name, profile] : {pair{"AES-CM", srtp_profile_aes128_cm_sha1_80},
+		                             pair{"AES-GCM", srtp_profile_aead_aes_128_gcm}}) {
+			report(string("SRTP protect ") + name + ", inline",
+			       benchmarkSrtpProtect(profile, 0, 8, duration), "packets/s");
+			report(string("SRTP protect ") + name + ", 1 SSRC, " + to_string(workers) + " workers",
+			       benchmarkSrtpProtect(profile, workers, 1, duration), "packets/s");
+			report(string("SRTP protect ") + name + ", 8 SSRCs, " + to_string(workers) + " workers",
+			       benchmarkSrtpProtect(profile, workers, 8, duration), "packets/s");
+		}
+
+#if RTC_ENABLE_WEBSOCKET
+		report("WebSocket handshake request parsing", 1e9 / benchmarkWsHandshakeParsing(duration),
+		       "ns/request");
+
+		benchmarkWebSocketFanout(clientCount, 1024, duration);
+
+		const unsigned int acceptThreads = max(thread::hardware_concurrency(), 2u);
+		for (bool tls : {false, true}) {
+			for (unsigned int threads : {1u, acceptThreads}) {
+				report(string(tls ? "WSS" : "WS") + " accept, " + to_string(clientCount) +
+				           " clients, " + to_string(threads) + " threads",
+				       benchmarkWebSocketAccept(clientCount, threads, tls), "connections/s");
+			}
+		}
+
+		report("WSS reconnect, resumed TLS session", benchmarkWebSocketReconnect(duration),
+		       "connections/s");
+
+#if HAVE_MALLINFO2
+		for (bool tls : {false, true})
+			report(string(tls ? "WSS" : "WS") + " idle connection, client and server",
+			       benchmarkWebSocketIdleMemory(clientCount, tls), "bytes");
+#endif
+#endif
+
+		rtc::Cleanup();
+		return 0;
+
+	} catch (const std::exception &e) {
+		cerr << "Microbenchmark failed: " << e.what() << endl;
+		return -1;
+	}
+}
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+static message_ptr makeNack(SSRC ssrc, uint16_t seq) {
+	auto message = make_message(RtcpNack::Size(1), Message::Control);
+	auto *nack = reinterpret_cast<RtcpNack *>(message->data());
+	nack->preparePacket(ssrc, 1);
+	unsigned int fciCount = 0;
+	uint16_t fciPID = 0;
+	nack->addMissingPacket(&fciCount, &fciPID, seq);
+	return message;
+}
+
+// Counts the packets passed to the following handlers
+class OutgoingCounter final : public MediaHandler {
+public:
+	void outgoing(message_vector &messages, const message_callback &) override {
+		count += messages.size();
+	}
+
+	size_t count = 0;
+};
+
+// Unit test: ring buffer eviction, SSRC keying and retention window of RtpPacketHistory
+TestResult test_nack_responder_history() {
+	cout << "RTP packet history test" << endl;
+
+	RtpPacketHistory history(100); // rounded up to 128
+	for (uint16_t seq = 65500; seq != 100; ++seq) // wraps around
+		history.store(makeRtpPacket(1, seq));
+
+	if (history.get(1, 99) == nullptr || history.get(1, 65535) == nullptr)
+		return TestResult(false, "Recent packet missing from history");
+	if (history.get(1, uint16_t(100 - 128)) == nullptr)
+		return TestResult(false, "Oldest packet missing from history");
+	if (history.get(1, uint16_t(100 - 129)) != nullptr)
+		return TestResult(false, "Evicted packet still in history");
+	if (history.get(2, 99) != nullptr)
+		return TestResult(false, "Packet returned for the wrong SSRC");
+
+	// A backward jump larger than the ring restarts the sequence
+	history.store(makeRtpPacket(1, uint16_t(100 - 200)));
+	history.store(makeRtpPacket(1, uint16_t(100 - 199)));
+	if (history.get(1, uint16_t(100 - 200)) == nullptr ||
+	    history.get(1, uint16_t(100 - 199)) == nullptr)
+		return TestResult(false, "Packet missing from history after a sequence restart");
+	if (history.get(1, 99) != nullptr)
+		return TestResult(false, "Packet from before the sequence restart still in history");
+
+	history.store(makeRtpPacket(2, 0));
+	history.remove(1);
+	if (history.get(1, uint16_t(100 - 199)) != nullptr || history.get(2, 0) == nullptr)
+		return TestResult(false, "Wrong stream removed from history");
+
+	RtpPacketHistory timedHistory(512, 50ms);
+	timedHistory.store(makeRtpPacket(1, 0));
+	this_thread::sleep_for(100ms);
+	timedHistory.store(makeRtpPacket(1, 1));
+	if (timedHistory.get(1, 0) != nullptr)
+		return TestResult(false, "Expired packet still in history");
+	if (timedHistory.get(1, 1) == nullptr)
+		return TestResult(false, "Fresh packet missing from history");
+
+	cout << "RTP packet history test passed" << endl;
+	return TestResult(true);
+}
+
+// Unit test: two responders answer NACKs from a single shared history
+TestResult test_nack_responder_shared_history() {
+	cout << "RtcpNackResponder shared history test" << endl;
+
+	const SSRC sourceSsrc = 1000;
+	const SSRC subscriberSsrcs[2] = {2001, 2002};
+
+	auto history = make_shared<RtpPacketHistory>();
+	vector<shared_ptr<RtcpNackResponder>> responders;
+	for (int i = 0; i < 2; ++i)
+		responders.push_back(make_shared<RtcpNackResponder>(history, sourceSsrc));
+
+	auto counter = make_shared<OutgoingCounter>();
+	responders[0]->addToChain(counter);
+
+	for (uint16_t seq = 0; seq < 10; ++seq) {
+		auto packet = makeRtpPacket(sourceSsrc, seq);
+		history->store(packet);
+
+		// Sending through the responders must not store copies
+		for (auto &responder : responders) {
+			message_vector messages{make_message(packet->begin(), packet->end())};
+			responder->outgoing(messages, [](message_ptr) {});
+		}
+	}
+
+	for (int i = 0; i < 2; ++i) {
+		vector<message_ptr> sent;
+		message_vector messages{makeNack(subscriberSsrcs[i], 5)};
+		responders[i]->incoming(messages, [&sent](message_ptr m) { sent.push_back(m); });
+
+		if (sent.size() != 1)
+			return TestResult(false, "Expected 1 retransmission, got " + to_string(sent.size()));
+
+		auto *rtp = reinterpret_cast<const RtpHeader *>(sent[0]->data());
+		if (rtp->ssrc() != subscriberSsrcs[i] || rtp->seqNumber() != 5)
+			return TestResult(false, "Retransmitted packet has wrong SSRC or sequence number");
+	}
+
+	// Retransmissions go through the following handlers, for instance to be paced
+	if (counter->count != 1)
+		return TestResult(false, "Retransmission was not passed to the following handlers");
+
+	auto stored = history->get(sourceSsrc, 5);
+	if (!stored || reinterpret_cast<const RtpHeader *>(stored->data())->ssrc() != sourceSsrc)
+		return TestResult(false, "Shared history packet was modified");
+
+	cout << "RtcpNackResponder shared history test passed" << endl;
+	return TestResult(true);
+}
@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#if RTC_TESTS_INTERNALS
+#include "impl/pacingengine.hpp"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+#if RTC_TESTS_INTERNALS
+
+using impl::PacingFlow;
+using impl::PacingScheduler;
+
+namespace {
+
+using Release = pair<SSRC, PacingScheduler::clock::time_point>;
+
+// Runs the schedule from start until all packets are released, and returns the SSRC and time of
+// each released packet
+vector<Release> runSchedule(PacingScheduler &scheduler, PacingScheduler::clock::time_point start) {
+	vector<Release> releases;
+	vector<PacingScheduler::Batch> batches;
+	auto now = start;
+	while (true) {
+		auto next = scheduler.process(now, batches);
+		if (batches.empty() && next && *next <= now)
+			throw runtime_error("Schedule does not progress");
+
+		for (auto &[flow, messages] : batches)
+			for (const auto &message : messages)
+				releases.emplace_back(reinterpret_cast<const RtpHeader *>(message->data())->ssrc(),
+				                      now);
+
+		batches.clear();
+		if (!next)
+			return releases;
+
+		now = *next;
+	}
+}
+
+shared_ptr<PacingFlow> makeFlow(double bytesPerSecond, double burstSize,
+                                PacingScheduler::clock::time_point now) {
+	auto flow = make_shared<PacingFlow>();
+	flow->bucket.bytesPerSecond = bytesPerSecond;
+	flow->bucket.burstSize = burstSize;
+	flow->bucket.tokens = burstSize;
+	flow->bucket.lastRefill = now;
+	return flow;
+}
+
+} // namespace
+
+// Unit test: the schedule releases packets at the configured bitrate after the burst
+TestResult test_pacing_rate() {
+	cout << "Pacing rate test" << endl;
+
+	const size_t count = 100;
+	const size_t size = 1000;
+	const auto start = PacingScheduler::clock::now();
+
+	PacingScheduler scheduler;
+	auto flow = makeFlow(100000., 1000., start); // 100 kB/s, 1 kB burst
+	scheduler.add(flow, start);
+	for (size_t i = 0; i < count; ++i)
+		flow->queue.push_back(makeRtpPacket(1, uint16_t(i), 0, size - sizeof(RtpHeader)));
+
+	vector<Release> releases;
+	try {
+		releases = runSchedule(scheduler, start);
+	} catch (const exception &e) {
+		return TestResult(false, e.what());
+	}
+
+	if (releases.size() != count)
+		return TestResult(false, "Not all packets were released");
+
+	// The burst goes out immediately, then one packet every 10 ms
+	if (releases[0].second != start)
+		return TestResult(false, "Burst was not released immediately");
+
+	for (size_t i = 2; i < releases.size(); ++i) {
+		auto interval = releases[i].second - releases[i - 1].second;
+		if (interval < 9900us || interval > 10100us)
+			return TestResult(false, "Packets were not released at the configured bitrate");
+	}
+
+	auto elapsed = chrono::duration<double>(releases.back().second - start).count();
+	cout << "Released " << count << " packets in " << elapsed << " s" << endl;
+	return TestResult(true);
+}
+
+// Unit test: audio and retransmissions borrow from the budget shared with other flows
+TestResult test_pacing_shared_budget() {
+	cout << "Pacing shared budget test" << endl;
+
+	const SSRC audioSsrc = 1, videoSsrc = 2, rtxSsrc = 3;
+	const auto start = PacingScheduler::clock::now();
+
+	PacingScheduler scheduler;
+	auto audio = makeFlow(10000., 100., start); // 10 kB/s, 100 B burst
+	audio->priority = PacingFlow::Priority::Audio;
+	auto video = makeFlow(90000., 900., start); // 90 kB/s, 900 B burst
+	scheduler.add(audio, start);
+	scheduler.add(video, start);
+
+	for (uint16_t i = 0; i < 10; ++i)
+		video->queue.push_back(makeRtpPacket(videoSsrc, i, 0, 1000 - sizeof(RtpHeader)));
+
+	// The first video packet exhausts the shared budget
+	vector<PacingScheduler::Batch> batches;
+	scheduler.process(start, batches);
+	if (batches.size() != 1 || batches[0].second.size() != 1)
+		return TestResult(false, "Burst was not released");
+
+	// Audio exceeds its flow budget and the retransmission has no video budget left, but they are
+	// released before video as soon as the shared budget allows
+	for (uint16_t i = 0; i < 5; ++i)
+		audio->queue.push_back(makeRtpPacket(audioSsrc, i, 0, 200 - sizeof(RtpHeader)));
+
+	video->retransmissionQueue.push_back(makeRtpPacket(rtxSsrc, 0, 0, 1000 - sizeof(RtpHeader)));
+
+	vector<Release> releases;
+	try {
+		releases = runSchedule(scheduler, start);
+	} catch (const exception &e) {
+		return TestResult(false, e.what());
+	}
+
+	if (releases.size() != 15)
+		return TestResult(false, "Not all packets were released");
+
+	for (size_t i = 0; i < 5; ++i)
+		if (releases[i].first != audioSsrc)
+			return TestResult(false, "Audio was not released first");
+
+	if (releases[5].first != rtxSsrc)
+		return TestResult(false, "Retransmission was not released before video");
+
+	// Priority does not increase the total rate: 12 kB at 100 kB/s, minus the 1 kB burst and the
+	// last packet released over budget
+	auto elapsed = releases.back().second - start;
+	if (elapsed < 95ms || elapsed > 110ms)
+		return TestResult(false, "Packets were not released at the shared bitrate");
+
+	return TestResult(true);
+}
+
+#else
+
+TestResult test_pacing_rate() {
+	cout << "Internals are not exported, skipping" << endl;
+	return TestResult(true);
+}
+
+TestResult test_pacing_shared_budget() {
+	cout << "Internals are not exported, skipping" << endl;
+	return TestResult(true);
+}
+
+#endif
+
+// Unit test: retransmissions are released before queued video
+TestResult test_pacing_priority() {
+	cout << "Pacing priority test" << endl;
+
+	const SSRC ssrc = 1;
+	const SSRC rtxSsrc = 2;
+	Description::Video video("video");
+	video.addSSRC(ssrc, "cname");
+	video.addRtxSSRC(ssrc, rtxSsrc);
+
+	auto pacer = make_shared<PacingHandler>(800000., 10ms); // 100 kB/s, 1 kB burst
+	pacer->media(video);
+
+	mutex mtx;
+	vector<SSRC> order;
+	auto send = [&](message_ptr message) {
+		lock_guard lock(mtx);
+		order.push_back(reinterpret_cast<const RtpHeader *>(message->data())->ssrc());
+	};
+
+	message_vector messages;
+	for (uint16_t i = 0; i < 10; ++i)
+		messages.push_back(makeRtpPacket(ssrc, i, 0, 1000 - sizeof(RtpHeader)));
+
+	pacer->outgoing(messages, send);
+	this_thread::sleep_for(5ms);
+
+	messages.push_back(makeRtpPacket(rtxSsrc, 0, 0, 1000 - sizeof(RtpHeader)));
+	pacer->outgoing(messages, send);
+	this_thread::sleep_for(200ms);
+
+	lock_guard lock(mtx);
+	if (order.size() != 11)
+		return TestResult(false, "Not all packets were released");
+
+	auto it = find(order.begin(), order.end(), rtxSsrc);
+	if (it == order.end() || it - order.begin() > 3)
+		return TestResult(false, "Retransmission was not released first");
+
+	return TestResult(true);
+}
+
+// Integration test: with an external event loop, paced packets are released only from Poll()
+TestResult test_pacing_external_event_loop() {
+	cout << "Pacing external event loop test" << endl;
+
+	SetExternalEventLoop(true);
+	Preload();
+
+	const auto loopThreadId = this_thread::get_id();
+	const int count = 20;
+	int sent = 0;
+	bool otherThread = false;
+	auto send = [&](message_ptr) {
+		if (this_thread::get_id() != loopThreadId)
+			otherThread = true;
+
+		++sent;
+	};
+
+	string error = [&]() -> string {
+		auto pacer = make_shared<PacingHandler>(800000., 10ms); // 100 kB/s, 1 kB burst
+		message_vector messages;
+		for (uint16_t i = 0; i < count; ++i)
+			messages.push_back(makeRtpPacket(1, i, 0, 1000 - sizeof(RtpHeader)));
+
+		const auto start = chrono::steady_clock::now();
+		pacer->outgoing(messages, send);
+		this_thread::sleep_for(50ms);
+		if (sent != 0)
+			return "Packets were released without polling";
+
+		if (!GetPollTimeout())
+			return "Poll timeout does not account for queued packets";
+
+		auto deadline = start + 5s;
+		while (sent < count && chrono::steady_clock::now() < deadline)
+			Poll(100ms);
+
+		if (sent < count)
+			return "Released " + to_string(sent) + " packets instead of " + to_string(count);
+
+		// The first packet uses the burst, the others are paced at 1 kB per 10 ms
+		auto elapsed = chrono::steady_clock::now() - start;
+		if (elapsed < 150ms)
+			return "Packets were not paced";
+
+		return "";
+	}();
+
+	auto cleanup = Cleanup();
+	auto deadline = chrono::steady_clock::now() + 10s;
+	while (cleanup.wait_for(0s) != future_status::ready && chrono::steady_clock::now() < deadline)
+		Poll(100ms);
+
+	SetExternalEventLoop(false);
+
+	if (!error.empty())
+		return TestResult(false, error);
+
+	if (cleanup.wait_for(0s) != future_status::ready)
+		return TestResult(false, "Cleanup timeout");
+
+	if (otherThread)
+		return TestResult(false, "Packets were released from another thread");
+
+	return TestResult(true);
+}
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+
+namespace {
+
+// Media handlers are not thread-safe, so the track must never call them concurrently
+class ConcurrencyDetector final : public MediaHandler {
+public:
+	void incoming(message_vector &, const message_callback &) override {
+		if (mInside.exchange(true))
+			mConcurrent = true;
+
+		this_thread::sleep_for(chrono::microseconds(100)); // widen the window
+		mInside = false;
+	}
+
+	bool concurrent() const { return mConcurrent; }
+
+private:
+	atomic<bool> mInside = false;
+	atomic<bool> mConcurrent = false;
+};
+
+} // namespace
+
+// Media over parallel SRTP workers: packets of all SSRCs of a single track are received, in order
+// per SSRC, and the handlers of the track are never called concurrently
+TestResult test_parallel_srtp() {
+	InitLogger(LogLevel::Debug);
+
+	Configuration config1;
+	config1.srtpWorkers = 4;
+	PeerConnection pc1(config1);
+
+	Configuration config2;
+	config2.srtpWorkers = 4;
+	PeerConnection pc2(config2);
+
+	pc1.onLocalDescription([&pc2](Description sdp) { pc2.setRemoteDescription(string(sdp)); });
+	pc1.onLocalCandidate([&pc2](Candidate candidate) { pc2.addRemoteCandidate(string(candidate)); });
+	pc2.onLocalDescription([&pc1](Description sdp) { pc1.setRemoteDescription(string(sdp)); });
+	pc2.onLocalCandidate([&pc1](Candidate candidate) { pc1.addRemoteCandidate(string(candidate)); });
+
+	const vector<SSRC> ssrcs = {1111, 2222, 3333, 4444};
+	const int count = 100;
+
+	std::mutex mutex;
+	map<SSRC, int> received; // number of packets per SSRC
+	atomic<bool> ordered = true;
+	promise<void> receivedPromise;
+	auto detector = make_shared<ConcurrencyDetector>();
+	shared_ptr<Track> t2;
+	pc2.onTrack([&](shared_ptr<Track> t) {
+		t->setMediaHandler(detector);
+		t->onMessage(
+		    [&](binary message) {
+			    auto rtp = reinterpret_cast<const RtpHeader *>(message.data());
+			    if (IsRtcp(message))
+				    return;
+
+			    std::lock_guard lock(mutex);
+			    int &n = received[rtp->ssrc()];
+			    if (rtp->seqNumber() != n)
+				    ordered = false;
+
+			    if (++n == count && received.size() == ssrcs.size()) {
+				    for (auto [ssrc, c] : received)
+					    if (c != count)
+						    return;
+
+				    receivedPromise.set_value();
+			    }
+		    },
+		    nullptr);
+
+		std::atomic_store(&t2, t);
+	});
+
+	Description::Video media("video", Description::Direction::SendOnly);
+	media.addH264Codec(96);
+	for (SSRC ssrc : ssrcs)
+		media.addSSRC(ssrc, "video-send");
+
+	auto t1 = pc1.addTrack(media);
+	pc1.setLocalDescription();
+
+	int attempts = 10;
+	shared_ptr<Track> at2;
+	while ((!(at2 = std::atomic_load(&t2)) || !at2->isOpen() || !t1->isOpen()) && attempts--)
+		this_thread::sleep_for(1s);
+
+	if (!at2 || !at2->isOpen() || !t1->isOpen())
+		return TestResult(false, "Track is not open");
+
+	binary packet(sizeof(RtpHeader) + 100);
+	auto rtp = reinterpret_cast<RtpHeader *>(packet.data());
+	rtp->preparePacket();
+	rtp->setPayloadType(96);
+	for (int i = 0; i < count; ++i) {
+		for (SSRC ssrc : ssrcs) {
+			rtp->setSsrc(ssrc);
+			rtp->setSeqNumber(uint16_t(i));
+			rtp->setTimestamp(i * 3000);
+			if (!t1->send(packet))
+				return TestResult(false, "Couldn't send RTP packet");
+		}
+		if (i % 10 == 0)
+			this_thread::sleep_for(10ms); // do not overflow socket buffers
+	}
+
+	if (receivedPromise.get_future().wait_for(5s) == future_status::timeout)
+		return TestResult(false, "Not all RTP packets were received");
+
+	if (!ordered)
+		return TestResult(false, "RTP packets were reordered");
+
+	if (detector->concurrent())
+		return TestResult(false, "Media handler was called concurrently");
+
+	pc1.close();
+	pc2.close();
+	this_thread::sleep_for(1s);
+
+	return TestResult(true);
+}
@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "test.hpp"
+
+#if RTC_ENABLE_WEBSOCKET
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// The TCP test needs internals and POSIX sockets
+#if RTC_TESTS_INTERNALS && !defined(_WIN32)
+#include "impl/tcptransport.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+// Content of the stream at offset, with a period prime to the buffer sizes so misplaced chunks
+// are detected
+byte patternByte(size_t offset) { return byte(offset % 251); }
+
+binary makePattern(size_t offset, size_t size) {
+	binary data(size);
+	for (size_t i = 0; i < size; ++i)
+		data[i] = patternByte(offset + i);
+
+	return data;
+}
+
+bool checkPattern(const byte *data, size_t offset, size_t size) {
+	for (size_t i = 0; i < size; ++i)
+		if (data[i] != patternByte(offset + i))
+			return false;
+
+	return true;
+}
+
+} // namespace
+
+#if RTC_TESTS_INTERNALS && !defined(_WIN32)
+
+// Integration test: messages sent through a small socket buffer are partially written, and must
+// arrive intact and in order
+TestResult test_tcp_partial_write() {
+	InitLogger(LogLevel::Debug);
+
+	const int bufferSize = 4096;
+	int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+	int sock = ::socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0 || sock < 0)
+		return TestResult(false, "Failed to create sockets");
+
+	// The accepted socket inherits the small receive buffer, which keeps the TCP window small
+	::setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+	::setsockopt(sock, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+
+	struct sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t addrlen = sizeof(addr);
+	if (::bind(listener, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+	    ::listen(listener, 1) < 0 ||
+	    ::getsockname(listener, reinterpret_cast<struct sockaddr *>(&addr), &addrlen) < 0 ||
+	    ::connect(sock, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+		::close(listener);
+		::close(sock);
+		return TestResult(false, "Failed to connect sockets");
+	}
+
+	int receiver = ::accept(listener, nullptr, nullptr);
+	::close(listener);
+	if (receiver < 0) {
+		::close(sock);
+		return TestResult(false, "Failed to accept connection");
+	}
+
+	// Messages of various sizes, a large one in the middle
+	vector<size_t> sizes;
+	for (size_t i = 0; i < 64; ++i)
+		sizes.push_back(i == 32 ? 4 * 1024 * 1024 : 1 + i * 997);
+
+	size_t total = 0;
+	for (size_t size : sizes)
+		total += size;
+
+	// The receiver starts late so the queue builds up, then reads in small chunks
+	auto received = std::async(std::launch::async, [receiver, total]() -> string {
+		this_thread::sleep_for(100ms);
+		byte buffer[1000];
+		size_t offset = 0;
+		while (offset < total) {
+			auto len = ::recv(receiver, buffer, sizeof(buffer), 0);
+			if (len <= 0)
+				return "Connection closed after " + to_string(offset) + " bytes";
+
+			if (!checkPattern(buffer, offset, size_t(len)))
+				return "Corrupted data at offset " + to_string(offset);
+
+			offset += size_t(len);
+		}
+		return "";
+	});
+
+	atomic<size_t> bufferedAmount = 0;
+	auto tcp = make_shared<impl::TcpTransport>(sock, nullptr);
+	tcp->onBufferedAmount([&bufferedAmount](size_t amount) { bufferedAmount = amount; });
+	tcp->start();
+
+	// Alternate between single sends and vectored sends
+	size_t offset = 0;
+	bool partial = false;
+	for (size_t i = 0; i < sizes.size(); i += 2) {
+		auto first = make_message(makePattern(offset, sizes[i]));
+		offset += sizes[i];
+		partial |= !tcp->send(first);
+
+		message_vector messages;
+		messages.push_back(make_message(makePattern(offset, sizes[i + 1])));
+		offset += sizes[i + 1];
+		partial |= !tcp->send(messages);
+	}
+
+	string error;
+	if (received.wait_for(10s) == future_status::ready)
+		error = received.get();
+	else
+		error = "Receive timeout";
+
+	tcp->stop();
+	::close(receiver);
+
+	if (!error.empty())
+		return TestResult(false, error);
+
+	if (!partial)
+		return TestResult(false, "Messages were not partially written");
+
+	if (bufferedAmount != 0)
+		return TestResult(false, "Buffered amount is not zero after sending");
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#endif
+
+// Integration test: a large WebSocket message exceeding the socket buffers is echoed intact, with
+// the header and payload written separately over TCP
+TestResult test_websocket_partial_write() {
+	InitLogger(LogLevel::Debug);
+
+	const size_t size = 16 * 1024 * 1024; // larger than the maximum socket buffers
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48086;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.maxMessageSize = size;
+	WebSocketServer server(std::move(serverConfig));
+
+	shared_ptr<WebSocket> client;
+	server.onClient([&client](shared_ptr<WebSocket> incoming) {
+		client = incoming;
+		client->onMessage([wclient = weak_ptr<WebSocket>(client)](message_variant message) {
+			if (auto client = wclient.lock())
+				client->send(std::move(message)); // echo
+		});
+	});
+
+	WebSocket::Configuration config;
+	config.maxMessageSize = size;
+	auto ws = make_shared<WebSocket>(config);
+
+	promise<string> result;
+	int count = 0;
+	string error;
+	ws->onOpen([&ws]() {
+		// A large message followed by a small one, which must arrive second
+		ws->send(makePattern(0, size));
+		ws->send("end");
+	});
+	ws->onMessage([&](message_variant message) {
+		if (++count == 1) {
+			auto data = get_if<binary>(&message);
+			if (!data || data->size() != size || !checkPattern(data->data(), 0, size))
+				error = "Large message was corrupted";
+
+		} else if (count == 2) {
+			auto str = get_if<string>(&message);
+			if (error.empty() && (!str || *str != "end"))
+				error = "Messages were reordered";
+
+			result.set_value(error);
+		}
+	});
+
+	ws->open("ws://localhost:48086/");
+
+	auto future = result.get_future();
+	string echoError =
+	    future.wait_for(10s) == future_status::ready ? future.get() : "Echo timeout";
+
+	ws->close();
+	this_thread::sleep_for(1s);
+	server.stop();
+
+	if (!echoError.empty())
+		return TestResult(false, echoError);
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+
+static message_ptr makeSenderReport(SSRC ssrc, uint64_t ntpTimestamp) {
+	auto message = make_message(RtcpSr::Size(0), Message::Control);
+	auto *sr = reinterpret_cast<RtcpSr *>(message->data());
+	sr->preparePacket(ssrc, 0);
+	sr->setNtpTimestamp(ntpTimestamp);
+	return message;
+}
+
+static const RtcpReportBlock *findReportBlock(const RtcpRr *rr, SSRC ssrc) {
+	for (int i = 0; i < int(rr->header.reportCount()); ++i)
+		if (auto block = rr->getReportBlock(i); block->getSSRC() == ssrc)
+			return block;
+
+	return nullptr;
+}
+
+// Unit test: two sources, one with losses and one wrapping around, reported in a single RR
+TestResult test_rtcp_receiving_session() {
+	cout << "RTCP receiving session test" << endl;
+
+	const SSRC localSsrc = 1234;
+	const SSRC ssrcA = 1;
+	const SSRC ssrcB = 2;
+
+	Description::Video video("video", Description::Direction::SendRecv);
+	video.addH264Codec(96);
+	video.addSSRC(localSsrc, "local");
+
+	RtcpReceivingSession session;
+	session.media(video);
+
+	vector<message_ptr> sent;
+	auto send = [&sent](message_ptr message) { sent.push_back(std::move(message)); };
+
+	message_vector messages;
+	for (uint16_t seq = 100; seq < 120; ++seq)
+		if (seq != 103 && (seq < 107 || seq > 110)) // 5 packets lost
+			messages.push_back(makeRtpPacket(ssrcA, seq, seq * 3000));
+
+	for (uint16_t seq = 65530; seq != 10; ++seq) // wraps around
+		messages.push_back(makeRtpPacket(ssrcB, seq, 9000 * seq)); // inconsistent timestamps
+
+	session.incoming(messages, send);
+	if (messages.size() != 31)
+		return TestResult(false, "RTP packets were not forwarded");
+
+	if (!sent.empty())
+		return TestResult(false, "RR sent before SR");
+
+	const uint64_t ntpTimestamp = 0x0123456789ABCDEFull;
+	message_vector reports = {makeSenderReport(ssrcA, ntpTimestamp)};
+	session.incoming(reports, send);
+	if (sent.size() != 1)
+		return TestResult(false, "No RR sent after SR");
+
+	auto rr = reinterpret_cast<const RtcpRr *>(sent[0]->data());
+	if (rr->header.payloadType() != 201 || rr->header.reportCount() != 2 ||
+	    rr->getSize() != sent[0]->size())
+		return TestResult(false, "Compound RR is invalid");
+
+	if (rr->senderSSRC() != localSsrc)
+		return TestResult(false, "RR sender SSRC is not the local SSRC");
+
+	auto blockA = findReportBlock(rr, ssrcA);
+	auto blockB = findReportBlock(rr, ssrcB);
+	if (!blockA || !blockB)
+		return TestResult(false, "Missing report block");
+
+	if (blockA->getPacketsLostCount() != 5 || blockA->getFractionLost() != 5 * 256 / 20 ||
+	    blockA->extendedHighestSeqNo() != 119)
+		return TestResult(false, "Wrong report block for the lossy source");
+
+	if (blockA->getNTPOfSR() != ((ntpTimestamp >> 16) & 0xFFFFFFFF) << 16)
+		return TestResult(false, "Wrong last SR timestamp");
+
+	if (blockB->getPacketsLostCount() != 0 || blockB->getFractionLost() != 0 ||
+	    blockB->extendedHighestSeqNo() != 0x10000 + 9 || blockB->getNTPOfSR() != 0)
+		return TestResult(false, "Wrong report block for the wrapping source");
+
+	// Back-to-back packets with timestamps 100 ms apart must show significant jitter
+	if (blockB->jitter() < 3000)
+		return TestResult(false, "Jitter is not estimated");
+
+	// Reports are rate-limited
+	reports = {makeSenderReport(ssrcA, ntpTimestamp)};
+	session.incoming(reports, send);
+	if (sent.size() != 1)
+		return TestResult(false, "RR was not rate-limited");
+
+	auto stats = session.getSourceStats();
+	if (stats.size() != 2)
+		return TestResult(false, "Wrong number of sources in stats");
+
+	auto statsA = std::find_if(stats.begin(), stats.end(),
+	                           [&](const auto &s) { return s.ssrc == ssrcA; });
+	if (statsA == stats.end() || statsA->packetsReceived != 15 || statsA->packetsLost != 5 ||
+	    statsA->fractionLost != 0.25 || statsA->clockRate != 90000)
+		return TestResult(false, "Wrong stats for the lossy source");
+
+	return TestResult(true);
+}
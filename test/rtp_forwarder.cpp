@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "test.hpp"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+
+static const vector<uint8_t> H264Keyframe = {0x65, 0x00}; // IDR slice
+static const vector<uint8_t> H264Delta = {0x41, 0x00};    // non-IDR slice
+
+static bool isContiguous(const vector<binary> &packets) {
+	for (size_t i = 1; i < packets.size(); ++i) {
+		auto prev = reinterpret_cast<const RtpHeader *>(packets[i - 1].data());
+		auto cur = reinterpret_cast<const RtpHeader *>(packets[i].data());
+		if (uint16_t(prev->seqNumber() + 1) != cur->seqNumber())
+			return false;
+	}
+	return true;
+}
+
+// Unit test: simulcast fan-out with rewrite and keyframe-gated layer switching
+TestResult test_rtp_forwarder_simulcast() {
+	cout << "RTP forwarder simulcast test" << endl;
+
+	Description::Video video("video", Description::Direction::RecvOnly);
+	video.addH264Codec(96);
+
+	auto forwarder = make_shared<RtpForwarder>();
+	forwarder->media(video);
+	forwarder->setLayers({10, 20});
+
+	vector<binary> received1, received2;
+	auto sub1 = forwarder->addSubscriber([&](binary packet) { received1.push_back(packet); }, 100,
+	                                     97, 0);
+	forwarder->addSubscriber([&](binary packet) { received2.push_back(packet); }, 200, nullopt,
+	                         1);
+
+	vector<message_ptr> sent;
+	auto send = [&sent](message_ptr message) { sent.push_back(std::move(message)); };
+
+	uint16_t seq0 = 1000, seq1 = 5000;
+	uint32_t ts = 0;
+	auto feed = [&](bool key0, bool key1) {
+		message_vector messages = {
+		    makeRtpPacket(10, seq0++, ts, key0 ? H264Keyframe : H264Delta),
+		    makeRtpPacket(20, seq1++, ts + 123456, key1 ? H264Keyframe : H264Delta)};
+		ts += 3000;
+		forwarder->incoming(messages, send);
+		return messages.empty();
+	};
+
+	// Subscribers wait for a keyframe, which is requested for both layers
+	if (!feed(false, false))
+		return TestResult(false, "RTP packets were not consumed");
+
+	if (!received1.empty() || !received2.empty())
+		return TestResult(false, "Packets forwarded before a keyframe");
+
+	if (sent.size() != 2)
+		return TestResult(false, "Keyframes were not requested");
+
+	for (const auto &message : sent) {
+		auto header = reinterpret_cast<const RtcpHeader *>(message->data());
+		if (header->payloadType() != 206 || header->reportCount() != 1)
+			return TestResult(false, "Keyframe request is not a PLI");
+	}
+
+	feed(true, false);
+	feed(false, false);
+	feed(false, true);
+	feed(false, false);
+	if (received1.size() != 4 || received2.size() != 2)
+		return TestResult(false, "Wrong number of forwarded packets");
+
+	for (const auto &packet : received1) {
+		auto rtp = reinterpret_cast<const RtpHeader *>(packet.data());
+		if (rtp->ssrc() != 100 || rtp->payloadType() != 97)
+			return TestResult(false, "Packet was not rewritten");
+	}
+
+	auto rtp2 = reinterpret_cast<const RtpHeader *>(received2.back().data());
+	if (rtp2->ssrc() != 200 || rtp2->payloadType() != 96)
+		return TestResult(false, "Packet was not rewritten for the second subscriber");
+
+	// Switch the first subscriber to the high layer, effective on its next keyframe
+	forwarder->setLayer(sub1, 1);
+	feed(false, false);
+	if (received1.size() != 5)
+		return TestResult(false, "Layer switched before a keyframe");
+
+	feed(false, true);
+	feed(false, false);
+	if (received1.size() != 8 || received2.size() != 5)
+		return TestResult(false, "Layer switch failed");
+
+	if (!isContiguous(received1))
+		return TestResult(false, "Sequence numbers are not contiguous across the switch");
+
+	auto beforeSwitch = reinterpret_cast<const RtpHeader *>(received1[5].data())->timestamp();
+	auto afterSwitch = reinterpret_cast<const RtpHeader *>(received1[6].data())->timestamp();
+	if (int32_t(afterSwitch - beforeSwitch) <= 0 || int32_t(afterSwitch - beforeSwitch) > 90000)
+		return TestResult(false, "Timestamps are not continuous across the switch");
+
+	// RTCP is passed through
+	auto pli = make_message(RtcpPli::Size(), Message::Control);
+	reinterpret_cast<RtcpPli *>(pli->data())->preparePacket(10);
+	message_vector messages = {pli};
+	forwarder->incoming(messages, send);
+	if (messages.size() != 1)
+		return TestResult(false, "RTCP was not passed through");
+
+	// Keyframe requests for removed subscribers are ignored
+	forwarder->removeSubscriber(sub1);
+	if (forwarder->requestKeyframe(sub1))
+		return TestResult(false, "Keyframe requested for a removed subscriber");
+
+	return TestResult(true);
+}
+
+// Unit test: VP8 temporal layer dropping keeps sequence numbers contiguous
+TestResult test_rtp_forwarder_temporal() {
+	cout << "RTP forwarder temporal layers test" << endl;
+
+	Description::Video video("video", Description::Direction::RecvOnly);
+	video.addVP8Codec(96);
+
+	auto forwarder = make_shared<RtpForwarder>();
+	forwarder->media(video);
+
+	vector<binary> received;
+	auto sub = forwarder->addSubscriber([&](binary packet) { received.push_back(packet); }, 1);
+	forwarder->setTemporalLayer(sub, 0);
+
+	auto send = [](message_ptr) {};
+	uint16_t seq = 0;
+	for (int i = 0; i < 8; ++i) {
+		uint8_t tid = i % 2;
+		bool key = i == 0;
+		// X=1, S=1, PID=0; T=1; TID; VP8 payload header with P bit
+		vector<uint8_t> payload = {0x90, 0x20, uint8_t(tid << 6), uint8_t(key ? 0x00 : 0x01)};
+		message_vector messages = {makeRtpPacket(42, seq++, uint32_t(i * 3000), payload)};
+		forwarder->incoming(messages, send);
+	}
+
+	if (received.size() != 4)
+		return TestResult(false, "Temporal layer was not dropped");
+
+	if (!isContiguous(received))
+		return TestResult(false, "Sequence numbers are not contiguous");
+
+	return TestResult(true);
+}
@@ -9,6 +9,16 @@
 #include <functional>
 #include <iostream>
 
+// Some tests exercise internals, which are not exported from a shared library on Windows. The build
+// system defines whether they are available, otherwise they are assumed unavailable on Windows.
+#ifndef RTC_TESTS_INTERNALS
+#ifdef _WIN32
+#define RTC_TESTS_INTERNALS 0
+#else
+#define RTC_TESTS_INTERNALS 1
+#endif
+#endif
+
 using namespace std;
 
 class TestResult {
@@ -38,3 +48,36 @@ public:
 		return res;
 	}
 };
+
+#if RTC_ENABLE_MEDIA
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Makes an RTP packet with payload type 96 and a zero-filled payload
+inline rtc::message_ptr makeRtpPacket(rtc::SSRC ssrc, uint16_t seq, uint32_t timestamp = 0,
+                                      size_t payloadSize = 8) {
+	auto message = rtc::make_message(sizeof(rtc::RtpHeader) + payloadSize, rtc::Message::Binary);
+	auto *rtp = reinterpret_cast<rtc::RtpHeader *>(message->data());
+	rtp->preparePacket();
+	rtp->setPayloadType(96);
+	rtp->setSsrc(ssrc);
+	rtp->setSeqNumber(seq);
+	rtp->setTimestamp(timestamp);
+	message->stream = ssrc;
+	return message;
+}
+
+inline rtc::message_ptr makeRtpPacket(rtc::SSRC ssrc, uint16_t seq, uint32_t timestamp,
+                                      const vector<uint8_t> &payload) {
+	auto message = makeRtpPacket(ssrc, seq, timestamp, payload.size());
+	for (size_t i = 0; i < payload.size(); ++i)
+		message->at(sizeof(rtc::RtpHeader) + i) = std::byte(payload[i]);
+
+	return message;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "test.hpp"
+
+#if RTC_ENABLE_WEBSOCKET && RTC_TESTS_INTERNALS
+
+#include "impl/certificate.hpp"
+#include "impl/tcpserver.hpp"
+#include "impl/tcptransport.hpp"
+#include "impl/tlstransport.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+namespace {
+
+using impl::TcpTransport;
+using impl::TlsTransport;
+using State = impl::Transport::State;
+
+bool waitFor(function<bool()> condition) {
+	auto deadline = chrono::steady_clock::now() + 5s;
+	while (!condition() && chrono::steady_clock::now() < deadline)
+		this_thread::sleep_for(10ms);
+
+	return condition();
+}
+
+// Connects a TLS client to the server and returns whether the client session was resumed. The
+// client waits for a message from the server, so TLS 1.3 tickets sent before it are received.
+bool connect(impl::TcpServer &server, impl::certificate_ptr serverCertificate,
+             impl::certificate_ptr clientCertificate = nullptr) {
+	auto accepted = std::async(std::launch::async, [&]() {
+		auto tcp = server.accept();
+		if (!tcp)
+			throw runtime_error("TCP accept failed");
+
+		auto tls = make_shared<TlsTransport>(tcp, nullopt, serverCertificate, nullptr);
+		tls->start();
+		tcp->start();
+		if (!waitFor([&]() { return tls->state() == State::Connected; }))
+			throw runtime_error("Server-side TLS handshake failed");
+
+		tls->send(make_message(4, Message::Binary));
+		return make_pair(tcp, tls);
+	});
+
+	auto tcp = make_shared<TcpTransport>("localhost", to_string(server.port()), nullptr);
+	tcp->start();
+	if (!waitFor([&]() { return tcp->state() == State::Connected; }))
+		throw runtime_error("TCP connection failed");
+
+	atomic<bool> received = false;
+	auto tls = make_shared<TlsTransport>(tcp, "localhost", clientCertificate, nullptr);
+	tls->onRecv([&received](message_ptr message) {
+		if (message)
+			received = true;
+	});
+	tls->start();
+
+	if (accepted.wait_for(5s) != future_status::ready)
+		throw runtime_error("Server-side connection timeout");
+
+	auto [serverTcp, serverTls] = accepted.get();
+	if (!waitFor([&]() { return received.load(); }))
+		throw runtime_error("No message received");
+
+	bool resumed = tls->isSessionResumed();
+	tls->stop();
+	tcp->stop();
+	serverTls->stop();
+	serverTcp->stop();
+	return resumed;
+}
+
+} // namespace
+
+TestResult test_tls_session_resumption() {
+	InitLogger(LogLevel::Debug);
+
+	try {
+		auto serverCertificate = impl::make_certificate().get();
+		auto clientCertificate = impl::make_certificate().get();
+
+		impl::TcpServer server1(48083, "127.0.0.1");
+		impl::TcpServer server2(48084, "127.0.0.1"); // same certificate on another port
+
+		if (connect(server1, serverCertificate))
+			return TestResult(false, "First connection was resumed");
+
+#if !USE_MBEDTLS // Mbed TLS does not report resumption
+		if (!connect(server1, serverCertificate))
+			return TestResult(false, "Second connection was not resumed");
+
+		// Each connection takes a ticket, and is issued new ones
+		if (!connect(server1, serverCertificate))
+			return TestResult(false, "Third connection was not resumed");
+#endif
+
+		if (connect(server1, serverCertificate, clientCertificate))
+			return TestResult(false, "Session was resumed with another client certificate");
+
+		if (connect(server2, serverCertificate))
+			return TestResult(false, "Session was resumed on another port");
+
+		server1.close();
+		server2.close();
+
+	} catch (const exception &e) {
+		return TestResult(false, e.what());
+	}
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
+#endif
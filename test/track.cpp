@@ -183,6 +183,20 @@ TestResult test_track() {
 		throw runtime_error("Received RTP packet is different than the packet that was sent");
 	}
 
+	// Stats test
+	auto sentStats = t1->stats();
+	if (sentStats.packetsSent != 1 || sentStats.bytesSent != rtpRaw.size())
+		throw runtime_error("Incorrect sent packet stats");
+
+	auto receivedStats = t2->stats();
+	if (receivedStats.packetsReceived != 1 || receivedStats.bytesReceived != rtpRaw.size())
+		throw runtime_error("Incorrect received packet stats");
+
+	auto report = pc1.stats();
+	if (report.tracks.empty() || report.transport.packetsSent == 0 ||
+	    report.transport.bytesReceived == 0 || !report.transport.localCandidate)
+		throw runtime_error("Incorrect stats report");
+
 	// RTCP REMB test
 	std::promise<unsigned int> rembPromise;
 	t1->setMediaHandler(make_shared<RembHandler>([&rembPromise](unsigned int bitrate) {
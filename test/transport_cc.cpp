@@ -0,0 +1,171 @@
+/**
+ * Copyright (c) 2026 Paul-Louis Ageneau
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "rtc/rtc.hpp"
+#include "rtc/rtp.hpp"
+#include "rtc/transportccfeedback.hpp"
+#include "test.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace rtc;
+using namespace std;
+using namespace chrono_literals;
+
+// Unit test: serialization and parsing of feedback with losses, small and large deltas
+TestResult test_transport_cc_feedback() {
+	cout << "Transport-cc feedback test" << endl;
+
+	TransportCcFeedback feedback;
+	feedback.senderSsrc = 1;
+	feedback.mediaSsrc = 2;
+	feedback.baseSequenceNumber = 65530; // wraps around
+	feedback.referenceTime = -3;
+	feedback.feedbackCount = 7;
+
+	auto reference = TransportCcFeedback::ReferenceTimeResolution * feedback.referenceTime;
+	auto arrival = reference;
+	for (int i = 0; i < 40; ++i) {
+		TransportCcFeedback::Packet packet;
+		packet.sequenceNumber = uint16_t(feedback.baseSequenceNumber + i);
+		packet.received = (i % 9) != 4 && (i < 20 || i > 35);
+		if (packet.received) {
+			arrival += (i == 17 ? -2ms : i == 37 ? 300ms : 1ms); // reordering and large gap
+			packet.arrivalTime = arrival;
+		}
+		feedback.packets.push_back(packet);
+	}
+
+	auto message = feedback.serialize();
+	if (message->size() % 4 != 0)
+		return TestResult(false, "Serialized feedback is not 32-bit aligned");
+
+	auto header = reinterpret_cast<const RtcpHeader *>(message->data());
+	if (!TransportCcFeedback::IsTransportCc(header) || header->lengthInBytes() != message->size())
+		return TestResult(false, "Invalid feedback header");
+
+	auto parsed = TransportCcFeedback::Parse(message->data(), message->size());
+	if (!parsed)
+		return TestResult(false, "Failed to parse feedback");
+
+	if (parsed->senderSsrc != 1 || parsed->mediaSsrc != 2 ||
+	    parsed->baseSequenceNumber != feedback.baseSequenceNumber ||
+	    parsed->referenceTime != feedback.referenceTime || parsed->feedbackCount != 7)
+		return TestResult(false, "Feedback fields mismatch");
+
+	if (parsed->packets.size() != feedback.packets.size())
+		return TestResult(false, "Feedback packet count mismatch");
+
+	for (size_t i = 0; i < feedback.packets.size(); ++i) {
+		const auto &expected = feedback.packets[i];
+		const auto &packet = parsed->packets[i];
+		if (packet.sequenceNumber != expected.sequenceNumber || packet.received != expected.received)
+			return TestResult(false, "Feedback packet status mismatch");
+		if (packet.received && packet.arrivalTime != expected.arrivalTime)
+			return TestResult(false, "Feedback arrival time mismatch");
+	}
+
+	if (TransportCcFeedback::Parse(message->data(), message->size() - 4))
+		return TestResult(false, "Truncated feedback was parsed");
+
+	return TestResult(true);
+}
+
+// Unit test: sender stamping, receiver feedback generation and matching on the sender side
+TestResult test_transport_cc_loop() {
+	cout << "Transport-cc loop test" << endl;
+
+	const uint8_t extensionId = 5;
+	auto senderSession = make_shared<TransportCcSession>();
+	auto receiverSession = make_shared<TransportCcSession>();
+	auto handler = make_shared<TransportCcHandler>(senderSession, extensionId);
+	auto reporter = make_shared<TransportCcReporter>(receiverSession, extensionId, 0ms);
+
+	vector<TransportCcPacketResult> results;
+	senderSession->onFeedback(
+	    [&](vector<TransportCcPacketResult> r) { results.insert(results.end(), r.begin(), r.end()); });
+
+	// Stamp outgoing packets, the extension is added since the packets have none
+	message_vector sent;
+	for (uint16_t seq = 0; seq < 10; ++seq)
+		sent.push_back(makeRtpPacket(42, seq));
+
+	handler->outgoing(sent, [](message_ptr) {});
+	if (sent.size() != 10)
+		return TestResult(false, "Unexpected outgoing packet count");
+
+	uint16_t first = 0;
+	for (size_t i = 0; i < sent.size(); ++i) {
+		auto rtp = reinterpret_cast<const RtpHeader *>(sent[i]->data());
+		size_t size = 0;
+		auto ext = rtp->getExtensionHeader();
+		auto value = ext ? ext->findHeader(extensionId, &size) : nullptr;
+		if (!value || size != 2)
+			return TestResult(false, "Transport-cc extension missing");
+		if (rtp->seqNumber() != i || rtp->getBody()[0] != 0)
+			return TestResult(false, "Packet corrupted by stamping");
+
+		uint16_t transportSeq = uint16_t((to_integer<uint16_t>(value[0]) << 8) |
+		                                 to_integer<uint16_t>(value[1]));
+		if (i == 0)
+			first = transportSeq;
+		else if (transportSeq != uint16_t(first + i))
+			return TestResult(false, "Transport-wide sequence numbers are not consecutive");
+	}
+
+	// Deliver all packets except the 4th, feedback is sent back immediately
+	message_vector received;
+	for (size_t i = 0; i < sent.size(); ++i)
+		if (i != 3)
+			received.push_back(sent[i]);
+
+	message_vector feedback;
+	reporter->incoming(received, [&](message_ptr m) { feedback.push_back(std::move(m)); });
+	if (feedback.size() != 1)
+		return TestResult(false, "Expected a single feedback packet");
+
+	// The same feedback dispatched twice must only be processed once
+	message_vector incoming = {feedback[0], feedback[0]};
+	handler->incoming(incoming, [](message_ptr) {});
+
+	if (results.size() != 10)
+		return TestResult(false, "Unexpected number of packet results");
+
+	for (size_t i = 0; i < results.size(); ++i) {
+		if (results[i].sequenceNumber != uint16_t(first + i))
+			return TestResult(false, "Packet result sequence number mismatch");
+		if (results[i].size != sent[i]->size())
+			return TestResult(false, "Packet result size mismatch");
+		if (results[i].arrivalTime.has_value() == (i == 3))
+			return TestResult(false, "Packet result reception status mismatch");
+	}
+
+	// A shared packet, like one kept for retransmission, is stamped in a copy
+	auto readTransportSeq = [&](const message_ptr &message) {
+		auto rtp = reinterpret_cast<const RtpHeader *>(message->data());
+		size_t size = 0;
+		auto value = rtp->getExtensionHeader()->findHeader(extensionId, &size);
+		return uint16_t((to_integer<uint16_t>(value[0]) << 8) | to_integer<uint16_t>(value[1]));
+	};
+
+	auto stored = sent[0];
+	uint16_t storedSeq = readTransportSeq(stored);
+	message_vector retransmitted = {stored};
+	handler->outgoing(retransmitted, [](message_ptr) {});
+	if (retransmitted.size() != 1 || retransmitted[0] == stored)
+		return TestResult(false, "Shared packet was stamped in place");
+
+	if (readTransportSeq(stored) != storedSeq ||
+	    readTransportSeq(retransmitted[0]) != uint16_t(first + sent.size()))
+		return TestResult(false, "Retransmission has a wrong transport-wide sequence number");
+
+	return TestResult(true);
+}
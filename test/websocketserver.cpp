@@ -17,6 +17,7 @@
 #include <map>
 #include <memory>
 #include <thread>
+#include <vector>
 
 using namespace rtc;
 using namespace std;
@@ -33,6 +34,7 @@ TestResult test_websocketserver() {
 	// serverConfig.keyPemFile = ...
 	serverConfig.bindAddress = "127.0.0.1"; // to test IPv4 fallback
 	serverConfig.maxMessageSize = 1000;     // to test max message size
+	serverConfig.maxBufferedAmount = 65536; // to test streaming with a send buffer limit
 	WebSocketServer server(std::move(serverConfig));
 
 	WebSocket::Headers requestHeaders = {
@@ -118,6 +120,7 @@ TestResult test_websocketserver() {
 	WebSocket ws(std::move(config));
 
 	const string myMessage = "Hello world from client";
+	const string broadcastMessage = "Hello world from server";
 
 	ws.onOpen([&ws, &myMessage]() {
 		cout << "WebSocket: Open" << endl;
@@ -129,16 +132,33 @@ TestResult test_websocketserver() {
 
 	std::atomic<bool> received = false;
 	std::atomic<bool> maxSizeReceived = false;
-	ws.onMessage([&received, &maxSizeReceived, &myMessage](variant<binary, string> message) {
+	std::atomic<bool> broadcastReceived = false;
+	std::atomic<bool> streamReceived = false;
+	const size_t streamChunkSize = 16384;
+	const size_t streamChunksCount = 12;
+	ws.onMessage([&received, &maxSizeReceived, &broadcastReceived, &streamReceived, &myMessage,
+	              &broadcastMessage](variant<binary, string> message) {
 		if (holds_alternative<string>(message)) {
 			string str = std::move(get<string>(message));
-			if ((received = (str == myMessage)))
+			if (str == broadcastMessage) {
+				broadcastReceived = true;
+				cout << "WebSocket: Received broadcast message" << endl;
+			} else if ((received = (str == myMessage)))
 				cout << "WebSocket: Received expected message" << endl;
 			else
 				cout << "WebSocket: Received UNEXPECTED message" << endl;
 		} else {
 			binary bin = std::move(get<binary>(message));
-			if ((maxSizeReceived = (bin.size() == 1000)))
+			if (bin.size() == streamChunkSize * streamChunksCount) {
+				bool ok = true;
+				for (size_t i = 0; i < bin.size(); ++i)
+					ok &= bin[i] == byte(i / streamChunkSize);
+
+				if ((streamReceived = ok))
+					cout << "WebSocket: Received streamed message" << endl;
+				else
+					cout << "WebSocket: Received CORRUPTED streamed message" << endl;
+			} else if ((maxSizeReceived = (bin.size() == 1000)))
 				cout << "WebSocket: Received large message truncated at max size" << endl;
 			else
 				cout << "WebSocket: Received large message NOT TRUNCATED" << endl;
@@ -160,6 +180,31 @@ TestResult test_websocketserver() {
 	if (!allRequestHeadersReceived)
 		return TestResult(false, "Some request headers not received");
 
+	if (server.broadcast(broadcastMessage, {client, nullptr}) != 1)
+		return TestResult(false, "Broadcast message not sent");
+
+	attempts = 5;
+	while (!broadcastReceived && attempts--)
+		this_thread::sleep_for(1s);
+
+	if (!broadcastReceived)
+		return TestResult(false, "Broadcast message not received");
+
+	size_t streamChunk = 0;
+	client->sendStream([&streamChunk]() -> optional<binary> {
+		if (streamChunk == streamChunksCount)
+			return nullopt;
+
+		return binary(streamChunkSize, byte(streamChunk++));
+	});
+
+	attempts = 5;
+	while (!streamReceived && attempts--)
+		this_thread::sleep_for(1s);
+
+	if (!streamReceived)
+		return TestResult(false, "Streamed message not received");
+
 	ws.close();
 	this_thread::sleep_for(1s);
 
@@ -169,4 +214,57 @@ TestResult test_websocketserver() {
 	return TestResult(true);
 }
 
+// Integration test: with several accept threads, the client callback is never called concurrently
+TestResult test_websocketserver_accept_threads() {
+	InitLogger(LogLevel::Debug);
+
+	WebSocketServer::Configuration serverConfig;
+	serverConfig.port = 48087;
+	serverConfig.bindAddress = "127.0.0.1";
+	serverConfig.acceptThreads = 4;
+	WebSocketServer server(std::move(serverConfig));
+
+	const int count = 32;
+	atomic<int> inCallback = 0;
+	atomic<bool> concurrent = false;
+	vector<shared_ptr<WebSocket>> clients; // accessed only in the callback
+	server.onClient([&](shared_ptr<WebSocket> incoming) {
+		if (inCallback++ > 0)
+			concurrent = true;
+
+		clients.push_back(std::move(incoming));
+		this_thread::sleep_for(chrono::milliseconds(10)); // widen the window for overlapping calls
+		--inCallback;
+	});
+
+	atomic<int> open = 0;
+	vector<shared_ptr<WebSocket>> sockets;
+	for (int i = 0; i < count; ++i) {
+		auto ws = make_shared<WebSocket>();
+		ws->onOpen([&open]() { ++open; });
+		ws->open("ws://localhost:48087/");
+		sockets.push_back(std::move(ws));
+	}
+
+	int attempts = 10;
+	while (open < count && attempts--)
+		this_thread::sleep_for(1s);
+
+	sockets.clear();
+	this_thread::sleep_for(1s);
+
+	server.stop();
+	this_thread::sleep_for(1s);
+
+	if (open < count)
+		return TestResult(false, "Only " + to_string(open) + " of " + to_string(count) +
+		                             " WebSockets opened");
+
+	if (concurrent)
+		return TestResult(false, "Client callback was called concurrently");
+
+	cout << "Success" << endl;
+	return TestResult(true);
+}
+
 #endif